@@ -22,3 +22,22 @@ meta:
 	ADDON_URL = https://github.com/paulvollmer/ofxCsv
 
 common:
+	# uncomment to enable reading & writing .zst files, requires libzstd
+	# ADDON_CFLAGS += -DOFX_CSV_ZSTD
+	# ADDON_LDFLAGS += -lzstd
+
+linux64:
+	# zlib is used for reading & writing .gz files
+	ADDON_LDFLAGS += -lz
+
+linux:
+	ADDON_LDFLAGS += -lz
+
+linuxarmv6l:
+	ADDON_LDFLAGS += -lz
+
+linuxarmv7l:
+	ADDON_LDFLAGS += -lz
+
+osx:
+	ADDON_LDFLAGS += -lz
@@ -0,0 +1,135 @@
+/**
+ *  ofxCsv
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "csvGenerator.h"
+
+// xorshift64* generator, the same sequence on every platform
+class csvRandom {
+	public:
+		csvRandom(uint64_t seed) : state(seed ? seed : 1) {}
+		uint64_t next() {
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 2685821657736338717ULL;
+		}
+		size_t below(size_t n) {
+			return next() % n;
+		}
+	private:
+		uint64_t state;
+};
+
+static const char *s_words[] = {
+	"red", "green", "blue", "alpha", "bravo", "charlie", "delta", "echo",
+	"sensor", "device", "value", "north", "south", "east", "west", "node"
+};
+
+// append a field of the kind given by the column number
+static void addField(string &text, csvRandom &random, size_t col, bool quoted) {
+	char buffer[32];
+	if(quoted) { // separators, escaped quotes, & spaces inside quotes
+		text += '"';
+		text += s_words[random.below(16)];
+		text += ", ";
+		if(random.below(4) == 0) {
+			text += "\"\"";
+			text += s_words[random.below(16)];
+			text += "\"\"";
+		}
+		text += " ";
+		text += s_words[random.below(16)];
+		text += '"';
+		return;
+	}
+	switch(col % 3) {
+		case 0:
+			snprintf(buffer, sizeof(buffer), "%d", (int)random.below(2000000) - 1000000);
+			break;
+		case 1:
+			snprintf(buffer, sizeof(buffer), "%.4f", (double)random.below(100000000) / 1000.0 - 50000.0);
+			break;
+		default:
+			snprintf(buffer, sizeof(buffer), "%s%d", s_words[random.below(16)], (int)random.below(1000));
+			break;
+	}
+	text += buffer;
+}
+
+//--------------------------------------------------------------
+vector<csvGenerator::Shape> csvGenerator::getShapes() {
+	return {Tall, Wide, Numeric, Quoted, MultiSep, Ragged};
+}
+
+//--------------------------------------------------------------
+string csvGenerator::getName(Shape shape) {
+	switch(shape) {
+		case Tall: return "tall";
+		case Wide: return "wide";
+		case Numeric: return "numeric";
+		case Quoted: return "quoted";
+		case MultiSep: return "multisep";
+		case Ragged: return "ragged";
+	}
+	return "";
+}
+
+//--------------------------------------------------------------
+string csvGenerator::getSeparator(Shape shape) {
+	return (shape == MultiSep ? "::" : ",");
+}
+
+//--------------------------------------------------------------
+size_t csvGenerator::getNumCols(Shape shape) {
+	switch(shape) {
+		case Wide: return 256;
+		case Numeric: case Ragged: return 16;
+		default: return 8;
+	}
+}
+
+//--------------------------------------------------------------
+string csvGenerator::generate(Shape shape, size_t rows, uint64_t seed) {
+	csvRandom random(seed);
+	string separator = getSeparator(shape);
+	size_t numCols = getNumCols(shape);
+	string text;
+	for(size_t row = 0; row < rows; row++) {
+		size_t cols = (shape == Ragged ? 1 + random.below(numCols) : numCols);
+		for(size_t col = 0; col < cols; col++) {
+			if(col > 0) {
+				text += separator;
+			}
+			addField(text, random, (shape == Numeric ? 1 : col), shape == Quoted);
+		}
+		text += '\n';
+	}
+	return text;
+}
@@ -0,0 +1,73 @@
+/**
+ *  ofxCsv
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+/// \class csvGenerator
+/// \brief deterministic synthetic CSV files for benchmarking
+///
+/// The same shape, size, & seed always produce the same bytes, so results
+/// can be compared between versions & machines.
+class csvGenerator {
+
+	public:
+
+		/// File shapes
+		enum Shape {
+			Tall,     //< 8 mixed int, float, & text columns
+			Wide,     //< 256 mixed columns
+			Numeric,  //< 16 float columns
+			Quoted,   //< 8 quoted text columns with separators, quotes, & spaces
+			MultiSep, //< 8 mixed columns separated by "::"
+			Ragged    //< 1 - 16 mixed columns per row
+		};
+
+		/// Get all shapes.
+		static vector<Shape> getShapes();
+
+		/// Get a shape's name, ie. "tall".
+		static string getName(Shape shape);
+
+		/// Get a shape's field separator.
+		static string getSeparator(Shape shape);
+
+		/// Get a shape's (maximum) number of columns.
+		static size_t getNumCols(Shape shape);
+
+		/// Generate CSV text.
+		///
+		/// \param shape File shape.
+		/// \param rows Number of rows.
+		/// \param seed Random seed.
+		/// \returns text with one row per line
+		static string generate(Shape shape, size_t rows, uint64_t seed=1);
+};
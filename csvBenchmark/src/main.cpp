@@ -0,0 +1,58 @@
+/**
+ *  ofxCsv
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+// usage: csvBenchmark [--quick] [--label name]
+//   --quick  only run the smaller sizes
+//   --label  version or machine label added to the results, ie. "0.2.1"
+int main(int argc, char *argv[]){
+
+	bool quick = false;
+	string label;
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "--quick") {
+			quick = true;
+		}
+		else if(arg == "--label" && i + 1 < argc) {
+			label = argv[++i];
+		}
+	}
+
+	// no window needed, the results are logged & written to bin/data
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>(quick, label);
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
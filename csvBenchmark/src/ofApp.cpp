@@ -0,0 +1,218 @@
+/**
+ *  ofxCsv
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofApp.h"
+
+#include <chrono>
+
+//--------------------------------------------------------------
+ofApp::ofApp(bool quick, const string &label) :
+	quick(quick), label(label), repeats(quick ? 3 : 5), sink(0) {}
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+
+	ofSetLogLevel("ofxCsv", OF_LOG_WARNING);
+	ofDirectory::createDirectory("bench", true, true);
+
+	vector<size_t> sizes = {1000, 10000};
+	if(!quick) {
+		sizes.push_back(100000);
+	}
+	for(auto shape : csvGenerator::getShapes()) {
+		for(auto rows : sizes) {
+			// keep wide files around the size of the others
+			runShape(shape, (shape == csvGenerator::Wide ? rows / 16 : rows));
+		}
+	}
+	saveResults();
+
+	// remove the generated files
+	ofDirectory("bench").remove(true);
+	ofExit();
+}
+
+//--------------------------------------------------------------
+void ofApp::runShape(csvGenerator::Shape shape, size_t rows){
+
+	string name = csvGenerator::getName(shape);
+	string separator = csvGenerator::getSeparator(shape);
+	string text = csvGenerator::generate(shape, rows);
+	string path = "bench/" + name + "_" + ofToString(rows) + ".csv";
+	ofBuffer buffer(text.data(), text.size());
+	ofBufferToFile(path, buffer);
+	vector<string> lines = ofSplitString(text, "\n", true);
+	ofLogNotice("csvBenchmark") << name << " " << rows << " rows, " << text.size() / 1024 << " kB";
+
+	Result info;
+	info.shape = name;
+	info.rows = rows;
+	info.cols = csvGenerator::getNumCols(shape);
+	info.bytes = text.size();
+
+	// file io
+	ofxCsv csv, copy;
+	info.op = "load";
+	info.items = rows;
+	measure(info, nullptr, [&]{
+		csv.load(path, separator);
+	});
+	info.op = "save";
+	measure(info, nullptr, [&]{
+		csv.save("bench/" + name + "_out.csv", false, separator);
+	});
+	info.op = "trim";
+	measure(info, [&]{copy = csv;}, [&]{
+		copy.trim();
+	});
+
+	// row strings
+	info.op = "fromString";
+	measure(info, nullptr, [&]{
+		for(auto &line : lines) {
+			sink += ofxCsvRow::fromString(line, separator).size();
+		}
+	});
+	info.op = "toString";
+	measure(info, nullptr, [&]{
+		for(auto &row : csv) {
+			sink += ofxCsvRow::toString(row.getData(), false, separator).size();
+		}
+	});
+
+	// typed getters over every field
+	size_t fields = 0;
+	for(auto &row : csv) {
+		fields += row.size();
+	}
+	info.op = "getters";
+	info.items = fields;
+	measure(info, nullptr, [&]{
+		const vector<ofxCsvRow> &data = csv.getData();
+		for(auto &row : data) {
+			for(size_t col = 0; col < row.size(); col++) {
+				sink += row.getInt(col);
+				sink += row.getFloat(col) > 0;
+				sink += row.getString(col).size();
+				sink += row.getBool(col);
+			}
+		}
+	});
+
+	// aggregates over the whole table without key columns & grouped by the
+	// first column, the ungrouped case has empty group keys
+	info.op = "aggregate";
+	info.items = rows;
+	measure(info, nullptr, [&]{
+		const vector<ofxCsvRow> &data = csv.getData();
+		sink += ofxCsvAggregate::apply(data, 0, {},
+			{ofxCsvAggregate::count(), ofxCsvAggregate::sum(1)}).size();
+		sink += ofxCsvAggregate::apply(data, 0, {0},
+			{ofxCsvAggregate::count()}).size();
+	});
+
+	// row edits at spread out positions: insert & remove a row, then
+	// set, insert, & remove fields
+	info.op = "edits";
+	info.items = std::min<size_t>(rows, 1000);
+	measure(info, [&]{copy = csv;}, [&]{
+		ofxCsvRow row = csv.getData()[0];
+		for(size_t i = 0; i < info.items; i++) {
+			int index = (i * 7919) % copy.getNumRows();
+			copy.insertRow(index, row);
+			copy.removeRow(index + 1);
+			ofxCsvRow &edited = copy.getRow(index);
+			edited.setString(0, "edited");
+			edited.insertFloat(1, 1.5f);
+			edited.remove(1);
+		}
+	});
+}
+
+//--------------------------------------------------------------
+void ofApp::measure(Result result, const std::function<void()> &prepare,
+                    const std::function<void()> &run){
+	vector<double> times;
+	for(int i = 0; i < repeats; i++) {
+		if(prepare) {
+			prepare();
+		}
+		auto start = std::chrono::steady_clock::now();
+		run();
+		auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	result.minMs = times.front();
+	result.medianMs = times[times.size() / 2];
+	results.push_back(result);
+	ofLogNotice("csvBenchmark") << "  " << result.op << ": " << ofToString(result.medianMs, 3) << " ms";
+}
+
+//--------------------------------------------------------------
+void ofApp::saveResults(){
+
+	// one object per result with the run info at the top
+	ofJson json;
+	json["label"] = label;
+	json["timestamp"] = ofGetTimestampString("%Y-%m-%dT%H:%M:%S");
+	json["threads"] = ofxCsvThreadPool::shared().getNumThreads();
+	json["repeats"] = repeats;
+	json["results"] = ofJson::array();
+
+	// the same as a flat table
+	ofxCsv table;
+	ofxCsvRow header(vector<string>{"label", "shape", "rows", "cols", "bytes", "op", "items",
+	                                "min_ms", "median_ms", "mb_per_s"});
+	table.addRow(header);
+	for(auto &result : results) {
+		double mbPerSec = (result.medianMs > 0 ? result.bytes / (1024.0 * 1024.0) / (result.medianMs / 1000.0) : 0);
+		json["results"].push_back({
+			{"shape", result.shape},
+			{"rows", result.rows},
+			{"cols", result.cols},
+			{"bytes", result.bytes},
+			{"op", result.op},
+			{"items", result.items},
+			{"min_ms", result.minMs},
+			{"median_ms", result.medianMs},
+			{"mb_per_s", mbPerSec}
+		});
+		ofxCsvRow row(vector<string>{label, result.shape, ofToString(result.rows),
+		                             ofToString(result.cols), ofToString(result.bytes), result.op,
+		                             ofToString(result.items), ofToString(result.minMs, 4),
+		                             ofToString(result.medianMs, 4), ofToString(mbPerSec, 2)});
+		table.addRow(row);
+	}
+	ofSavePrettyJson("results.json", json);
+	table.save("results.csv");
+	ofLogNotice("csvBenchmark") << "Wrote " << results.size() << " results to "
+	                            << ofToDataPath("results.json", true) << " & results.csv";
+}
@@ -0,0 +1,75 @@
+/**
+ *  ofxCsv
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxCsv.h"
+#include "csvGenerator.h"
+
+/// Times ofxCsv operations on generated files of several shapes & sizes,
+/// then writes the results to bin/data/results.json & results.csv.
+class ofApp : public ofBaseApp{
+
+	public:
+		ofApp(bool quick, const string &label);
+
+		void setup();
+
+	protected:
+
+		/// one timed operation
+		struct Result {
+			string shape;        //< file shape name
+			size_t rows = 0;     //< number of rows
+			size_t cols = 0;     //< (maximum) number of columns
+			uint64_t bytes = 0;  //< file size
+			string op;           //< operation name
+			size_t items = 0;    //< rows, fields, or edits processed per run
+			double minMs = 0;    //< fastest run in milliseconds
+			double medianMs = 0; //< median run in milliseconds
+		};
+
+		/// generate a file & time each operation on it
+		void runShape(csvGenerator::Shape shape, size_t rows);
+
+		/// time a function over several runs, calling prepare untimed before each
+		void measure(Result result, const std::function<void()> &prepare,
+		             const std::function<void()> &run);
+
+		/// write results.json & results.csv
+		void saveResults();
+
+		bool quick;             //< only run the smaller sizes?
+		string label;           //< version or machine label
+		int repeats;            //< runs per operation
+		vector<Result> results; //< results so far
+		size_t sink;            //< keeps the optimizer from removing work
+};
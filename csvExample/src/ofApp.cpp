@@ -34,7 +34,8 @@
 void ofApp::setup(){
 	
 	ofSetFrameRate(30);
-	ofSetLogLevel("ofxCsv", OF_LOG_VERBOSE); // See what's going on inside.
+	ofxCsvLog::setLevel(ofxCsvLogLevel::Verbose); // See what's going on inside.
+	ofSetLogLevel("ofxCsv", OF_LOG_VERBOSE);
 	
 	// Load a CSV File.
 	if(csv.load("file.csv")) {
@@ -175,7 +176,8 @@ void ofApp::keyPressed(int key){
 	}
 	else if(key == 'r') {
 		// Save the recorded values in the csvRecorder ofxCsv object.
-		csvRecorder.save("MyRecordedMouseData.csv");
+		// Only appends the rows recorded since the last save, if possible.
+		csvRecorder.saveChanges("MyRecordedMouseData.csv");
 		ofLog() << "Saved " << csvRecorder.getNumRows() << " rows of mouse data";
 	}
 }
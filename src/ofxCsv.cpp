@@ -30,14 +30,99 @@
 
 #include "ofxCsv.h"
 
-#include "ofLog.h"
-#include "ofUtils.h"
-#include "ofFileUtils.h"
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <unordered_set>
+
+#include <sys/stat.h>
+
+// replace a file with another, atomically where the platform allows
+static bool replaceFile(const string &from, const string &to) {
+	if(rename(from.c_str(), to.c_str()) == 0) {
+		return true;
+	}
+	// Windows won't rename over an existing file
+	remove(to.c_str());
+	return rename(from.c_str(), to.c_str()) == 0;
+}
+
+// match a file name with * & ? wildcards
+static bool matchesPattern(const string &name, const string &pattern) {
+	size_t n = 0, p = 0;
+	size_t star = string::npos, mark = 0;
+	while(n < name.size()) {
+		if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+			n++;
+			p++;
+		}
+		else if(p < pattern.size() && pattern[p] == '*') {
+			star = p++;
+			mark = n;
+		}
+		else if(star != string::npos) { // backtrack, let the last * match one more char
+			p = star + 1;
+			n = ++mark;
+		}
+		else {
+			return false;
+		}
+	}
+	while(p < pattern.size() && pattern[p] == '*') {
+		p++;
+	}
+	return p == pattern.size();
+}
+
+// compare strings with digit runs compared by value, ie. data_2 < data_10
+static bool naturalLess(const string &a, const string &b) {
+	size_t i = 0, j = 0;
+	while(i < a.size() && j < b.size()) {
+		if(isdigit((unsigned char)a[i]) && isdigit((unsigned char)b[j])) {
+			size_t ei = i, ej = j;
+			while(ei < a.size() && isdigit((unsigned char)a[ei])) {ei++;}
+			while(ej < b.size() && isdigit((unsigned char)b[ej])) {ej++;}
+			// skip leading zeros, then longer runs are larger
+			size_t si = i, sj = j;
+			while(si + 1 < ei && a[si] == '0') {si++;}
+			while(sj + 1 < ej && b[sj] == '0') {sj++;}
+			if(ei - si != ej - sj) {
+				return ei - si < ej - sj;
+			}
+			int c = a.compare(si, ei - si, b, sj, ej - sj);
+			if(c != 0) {
+				return c < 0;
+			}
+			i = ei;
+			j = ej;
+		}
+		else {
+			if(a[i] != b[j]) {
+				return a[i] < b[j];
+			}
+			i++;
+			j++;
+		}
+	}
+	if(a.size() - i != b.size() - j) {
+		return a.size() - i < b.size() - j;
+	}
+	return a < b; // tie break ie. 01 vs 1
+}
 
 //--------------------------------------------------
 ofxCsv::ofxCsv() {
 	fieldSeparator = ",";
 	commentPrefix = "#";
+	compression = ofxCsvCompression::Auto;
+	encoding = ofxCsvEncoding::Auto;
+	lazy = false;
 }
 
 //--------------------------------------------------
@@ -51,76 +136,187 @@ bool ofxCsv::load(const string &path, const string &separator, const string &com
 	fieldSeparator = separator;
 	commentPrefix = comment;
 	
-	// verbose log print
-	ofLogVerbose("ofxCsv") << "Loading " << filePath;
-	ofLogVerbose("ofxCsv") << "  separator: " << fieldSeparator;
-	ofLogVerbose("ofxCsv") << "  comment: " << commentPrefix;
+	return loadFile();
+}
+
+//--------------------------------------------------
+bool ofxCsv::load(const string &path, const string &separator) {
+	return load(path, separator, commentPrefix);
+}
+
+//--------------------------------------------------
+bool ofxCsv::load(const string &path) {
+	return load(path, fieldSeparator);
+}
+
+//--------------------------------------------------
+bool ofxCsv::load(const string &path, const ofxCsvSchema &schema) {
 	
-	// do some checks
-	ofFile file(ofToDataPath(filePath), ofFile::Reference);
-	if(!file.exists()) {
-		ofLogError("ofxCsv") << "Cannot load " << filePath << ": file not found";
+	clear();
+	
+	if(path != "") {
+		filePath = path;
+	}
+	this->schema = schema;
+	for(auto &column : schema.getColumns()) {
+		columns.push_back(ofxCsvColumn(column.type));
+	}
+	
+	return loadFile();
+}
+
+//--------------------------------------------------
+bool ofxCsv::loadSample(const string &path, size_t numRows, bool header, bool exact, uint64_t seed) {
+	
+	clear();
+	
+	OFX_CSV_LOG_VERBOSE << "Sampling " << numRows << " rows from " << path;
+	
+	string absolutePath = ofxCsvFileUtils::toDataPath(path);
+	if(!ofxCsvFileUtils::exists(absolutePath) || ofxCsvFileUtils::isDirectory(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot sample " << path << ": file not found";
 		return false;
 	}
-	if(!file.canRead()) {
-		ofLogError("ofxCsv") << "Cannot load " << filePath << ": file not readable";
+	
+	ofxCsvCompression format = compression;
+	if(format == ofxCsvCompression::Auto) {
+		format = ofxCsvReader::detectCompression(path);
+	}
+	bool offsets = (!exact && format == ofxCsvCompression::None);
+	if(offsets) {
+		// offsets only work with UTF-8 text without a byte order mark
+		ofxCsvReader probe;
+		char bytes[16];
+		probe.setEncoding(encoding);
+		offsets = probe.open(absolutePath, format) && probe.read(bytes, sizeof(bytes)) > 0 &&
+		          probe.getEncoding() == ofxCsvEncoding::Utf8 && !probe.hasByteOrderMark();
+	}
+	bool success = false;
+	if(!offsets) {
+		success = ofxCsvSampler::sampleReservoir(absolutePath, numRows, header,
+		                                         fieldSeparator, commentPrefix, seed, data, encoding);
+	}
+	else {
+		success = ofxCsvSampler::sampleOffsets(absolutePath, numRows, header,
+		                                       fieldSeparator, commentPrefix, seed, data);
+	}
+	if(!success) {
+		OFX_CSV_LOG_ERROR << "Cannot sample " << path << ": couldn't read file";
 		return false;
 	}
-	if(file.isDirectory()) {
-		ofLogError("ofxCsv") << "Cannot load " << filePath << ": \"file\" is actually a directory";
+	
+	// expand to fill in any missing cols, just in case
+	size_t maxCols = 0;
+	for(auto &row : data) {
+		maxCols = std::max(maxCols, row.size());
+	}
+	expand(data.size(), maxCols);
+	
+	OFX_CSV_LOG_VERBOSE << "Sampled a " << data.size() << "x" << maxCols << " table";
+	
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsv::loadFiles(const vector<string> &paths, bool header) {
+	
+	clear();
+	
+	if(paths.empty()) {
+		OFX_CSV_LOG_ERROR << "Cannot load files: no files given";
 		return false;
 	}
+	OFX_CSV_LOG_VERBOSE << "Loading " << paths.size() << " files";
 	
-	// open file & read each line
-	int lineCount = 0;
-	int maxCols = 0;
-	ofBuffer buffer = ofBufferFromFile(file.getAbsolutePath());
-	for(auto line : buffer.getLines()) {
-		
-		// skip empty lines
-		if(line.empty()) {
-			ofLogVerbose("ofxCsv") << "Skipping empty line: " << lineCount;
-			lineCount++;
+	// load each file into its own table concurrently
+	vector<ofxCsv> shards(paths.size());
+	vector<uint8_t> loaded(paths.size(), 0);
+	for(size_t i = 0; i < paths.size(); i++) {
+		shards[i].filePath = paths[i];
+		shards[i].fieldSeparator = fieldSeparator;
+		shards[i].commentPrefix = commentPrefix;
+		shards[i].compression = compression;
+		shards[i].encoding = encoding;
+		shards[i].lazy = lazy;
+	}
+	ofxCsvThreadPool::shared().parallelFor(0, paths.size(), 1, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			loaded[i] = shards[i].loadFile();
+		}
+	});
+	
+	// check all files agree with the first non-empty file
+	int first = -1;
+	size_t numRows = 0;
+	for(size_t i = 0; i < shards.size(); i++) {
+		if(!loaded[i]) {
+			OFX_CSV_LOG_ERROR << "Cannot load files: couldn't load " << paths[i];
+			return false;
+		}
+		if(shards[i].data.empty()) {
 			continue;
 		}
-		
-		// skip comment lines
-		// TODO: only checks substring at line beginning, does not ignore whitespace
-		if(line.substr(0, commentPrefix.length()) == commentPrefix) {
-			ofLogVerbose("ofxCsv") << "Skipping comment line: " << lineCount;
-			lineCount++;
+		numRows += shards[i].data.size();
+		if(first < 0) {
+			first = i;
 			continue;
 		}
-		
-		// split line into separate files
-		vector<string> cols = fromRowString(line);
-		data.push_back(cols);
-	
-		// calc maxium table cols
-		if(cols.size() > maxCols) {
-			maxCols = cols.size();
+		if(shards[i].getNumCols() != shards[first].getNumCols()) {
+			OFX_CSV_LOG_ERROR << "Cannot load files: " << paths[i] << " has "
+			                  << shards[i].getNumCols() << " columns, expected "
+			                  << shards[first].getNumCols() << " as in " << paths[first];
+			return false;
+		}
+		if(header) {
+			if(shards[i].data[0].getData() != shards[first].data[0].getData()) {
+				OFX_CSV_LOG_ERROR << "Cannot load files: " << paths[i]
+				                  << " header differs from " << paths[first];
+				return false;
+			}
+			numRows--;
 		}
-		lineCount++;
 	}
-	buffer.clear();
 	
-	// expand to fill in any missing cols, just in case
-	expand(data.size(), maxCols);
-
-	ofLogVerbose("ofxCsv") << "Read " << lineCount << " lines from " << filePath;
-	ofLogVerbose("ofxCsv") << "Loaded a " << data.size() << "x" << maxCols << " table";
+	// move rows in file order, keeping only the first header
+	data.reserve(numRows);
+	for(int i = 0; i < (int)shards.size(); i++) {
+		auto &rows = shards[i].data;
+		size_t skip = (header && i != first && !rows.empty() ? 1 : 0);
+		data.insert(data.end(), std::make_move_iterator(rows.begin() + skip),
+		            std::make_move_iterator(rows.end()));
+		rows = vector<ofxCsvRow>();
+	}
+	
+	OFX_CSV_LOG_VERBOSE << "Loaded a " << data.size() << "x" << getNumCols()
+	                    << " table from " << paths.size() << " files";
 	
 	return true;
 }
 
 //--------------------------------------------------
-bool ofxCsv::load(const string &path, const string &separator) {
-	return load(path, separator, commentPrefix);
+bool ofxCsv::loadMatching(const string &pattern, bool header) {
+	vector<string> paths = findFiles(pattern);
+	if(paths.empty()) {
+		clear();
+		OFX_CSV_LOG_ERROR << "Cannot load files: no files match " << pattern;
+		return false;
+	}
+	return loadFiles(paths, header);
 }
 
 //--------------------------------------------------
-bool ofxCsv::load(const string &path) {
-	return load(path, fieldSeparator);
+vector<string> ofxCsv::findFiles(const string &pattern) {
+	string directory = ofxCsvFileUtils::getEnclosingDirectory(pattern);
+	string name = ofxCsvFileUtils::getFileName(pattern);
+	vector<string> paths;
+	for(auto &path : ofxCsvFileUtils::listDirectory(ofxCsvFileUtils::toDataPath(directory.empty() ? "." : directory))) {
+		string fileName = ofxCsvFileUtils::getFileName(path);
+		if(fileName[0] != '.' && matchesPattern(fileName, name)) { // skip hidden files
+			paths.push_back(path);
+		}
+	}
+	std::sort(paths.begin(), paths.end(), naturalLess);
+	return paths;
 }
 
 //--------------------------------------------------
@@ -132,59 +328,428 @@ bool ofxCsv::save(const string &path, bool quote, const string &separator) {
 	fieldSeparator = separator;
 	
 	// verbose log print
-	ofLogVerbose("ofxCsv") << "Saving "  << filePath;
-	ofLogVerbose("ofxCsv") << "  separator: " << fieldSeparator;
-	ofLogVerbose("ofxCsv") << "  quote: " << quote;
+	OFX_CSV_LOG_VERBOSE << "Saving "  << filePath;
+	OFX_CSV_LOG_VERBOSE << "  separator: " << fieldSeparator;
+	OFX_CSV_LOG_VERBOSE << "  quote: " << quote;
+	beginStats(ofxCsvStats::Save);
 	
 	// do some checks
 	if(data.empty()) {
-		ofLogWarning("ofxCsv") << "Aborting save to " << filePath << ": data is empty";
-		return false;
+		OFX_CSV_LOG_WARNING << "Aborting save to " << filePath << ": data is empty";
+		return endStats(false);
 	}
-	ofFile file(ofToDataPath(filePath), ofFile::Reference);
-	if(!file.exists()) {
+	string absolutePath = ofxCsvFileUtils::toDataPath(filePath);
+	if(!ofxCsvFileUtils::exists(absolutePath)) {
 		if(!createFile(filePath)) {
-			ofLogError("ofxCsv") << "Could not save to " << filePath << ": couldn't create";
+			OFX_CSV_LOG_ERROR << "Could not save to " << filePath << ": couldn't create";
+			return endStats(false);
+		}
+	}
+	if(!ofxCsvFileUtils::canWrite(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot save " << filePath << ": file not writable";
+		return endStats(false);
+	}
+	if(ofxCsvFileUtils::isDirectory(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot save " << filePath << ": \"file\" is actually a directory";
+		return endStats(false);
+	}
+	
+	// write to a temp file & replace the original when done so a failed
+	// save never leaves a partially written file
+	string tempPath = absolutePath + ".tmp";
+	ofxCsvCompression format = getFileCompression();
+	int lineCount = 0;
+	auto start = std::chrono::steady_clock::now();
+	{
+		ofxCsvWriter writer;
+		if(!writer.open(tempPath, format)) {
+			OFX_CSV_LOG_ERROR << "Could not save to " << filePath << ": "
+			                  << (ofxCsvReader::isSupported(format) ? "couldn't open temp file" : "compression format not supported");
+			return endStats(false);
+		}
+		for(auto &row : data) {
+			writer.write(toRowString(row.getData(), quote));
+			writer.write("\n", 1);
+			stats.fields += row.size();
+			stats.maxCols = std::max(stats.maxCols, (size_t)row.size());
+			lineCount++;
+		}
+		if(!writer.close()) {
+			OFX_CSV_LOG_ERROR << "Could not save to " << filePath << ": couldn't write buffer";
+			remove(tempPath.c_str());
+			return endStats(false);
+		}
+		// writing is interleaved with formatting, so split the time
+		stats.writeTime = writer.getWriteTime();
+		stats.formatTime = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - stats.writeTime, 0.0);
+		stats.bytes = writer.getBytesWritten();
+		stats.rows = lineCount;
+	}
+	if(!replaceFile(tempPath, absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Could not save to " << filePath << ": couldn't replace file";
+		remove(tempPath.c_str());
+		return endStats(false);
+	}
+	setSaved(absolutePath, data.size(), true, ofxCsvEncoding::Utf8, quote);
+	
+	OFX_CSV_LOG_VERBOSE << "Wrote " << lineCount << " lines to " << filePath;
+	
+	return endStats(true);
+}
+
+//--------------------------------------------------
+bool ofxCsv::save(const string &path, bool quote) {
+	return save(path, quote, fieldSeparator);
+}
+
+//--------------------------------------------------
+bool ofxCsv::saveChanges(const string &path, bool quote) {
+	
+	if(path != "") {
+		filePath = path;
+	}
+	
+	// appending is only possible if the file is still the one last loaded
+	// or saved & no rows before the new ones changed
+	string absolutePath = ofxCsvFileUtils::toDataPath(filePath);
+	ofxCsvCompression format = getFileCompression();
+	bool append = !saved.modified && saved.rows <= data.size() &&
+	              saved.path == absolutePath && saved.separator == fieldSeparator &&
+	              saved.encoding == ofxCsvEncoding::Utf8 && saved.quote == quote &&
+	              saved.compression == format && saved.size > 0 &&
+	              ofxCsvFileUtils::exists(absolutePath) && !ofxCsvFileUtils::isDirectory(absolutePath) &&
+	              ofxCsvFileUtils::getSize(absolutePath) == saved.size;
+	if(!append) {
+		OFX_CSV_LOG_VERBOSE << "Saving changes to " << filePath << ": rewriting file";
+		return save(filePath, quote, fieldSeparator);
+	}
+	beginStats(ofxCsvStats::Save);
+	if(saved.rows == data.size()) {
+		OFX_CSV_LOG_VERBOSE << "Saving changes to " << filePath << ": no new rows";
+		return endStats(true);
+	}
+	
+	// append new rows only
+	auto start = std::chrono::steady_clock::now();
+	ofxCsvWriter writer;
+	if(!writer.open(absolutePath, format, true)) {
+		OFX_CSV_LOG_ERROR << "Could not save changes to " << filePath << ": couldn't open file";
+		return endStats(false);
+	}
+	if(!saved.newline) {
+		writer.write("\n", 1);
+	}
+	for(size_t row = saved.rows; row < data.size(); row++) {
+		writer.write(toRowString(data[row].getData(), quote));
+		writer.write("\n", 1);
+		stats.fields += data[row].size();
+		stats.maxCols = std::max(stats.maxCols, (size_t)data[row].size());
+	}
+	if(!writer.close()) {
+		OFX_CSV_LOG_ERROR << "Could not save changes to " << filePath << ": couldn't write buffer";
+		saved.size = 0; // unknown file state, rewrite next time
+		return endStats(false);
+	}
+	stats.writeTime = writer.getWriteTime();
+	stats.formatTime = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - stats.writeTime, 0.0);
+	stats.bytes = writer.getBytesWritten();
+	stats.rows = data.size() - saved.rows;
+	OFX_CSV_LOG_VERBOSE << "Appended " << (data.size() - saved.rows) << " lines to " << filePath;
+	setSaved(absolutePath, data.size(), true, ofxCsvEncoding::Utf8, quote);
+	
+	return endStats(true);
+}
+
+//--------------------------------------------------
+bool ofxCsv::savePartitioned(const string &directory, const ofxCsvPartition &partition,
+                             bool header, bool quote, const string &prefix) const {
+	
+	OFX_CSV_LOG_VERBOSE << "Saving partitions to " << directory;
+	
+	size_t first = (header ? 1 : 0);
+	if(data.size() <= first) {
+		OFX_CSV_LOG_WARNING << "Aborting partitioned save to " << directory << ": data is empty";
+		return false;
+	}
+	string absoluteDir = ofxCsvFileUtils::toDataPath(directory);
+	if(!ofxCsvFileUtils::createDirectory(absoluteDir)) {
+		OFX_CSV_LOG_ERROR << "Could not save partitions to " << directory << ": couldn't create directory";
+		return false;
+	}
+	
+	// assign rows & name the files
+	vector<string> keys;
+	size_t headerBytes = (header ? ofxCsvRow::toString(data[0].getData(), quote, fieldSeparator).size() + 1 : 0);
+	vector<vector<size_t>> partitions = partition.apply(data, first, fieldSeparator, quote, keys, headerBytes);
+	string extension = ".csv";
+	ofxCsvCompression format = (compression == ofxCsvCompression::Auto ? ofxCsvCompression::None : compression);
+	if(format == ofxCsvCompression::Gzip) {
+		extension += ".gz";
+	}
+	else if(format == ofxCsvCompression::Zstd) {
+		extension += ".zst";
+	}
+	vector<string> names(partitions.size());
+	std::unordered_set<string> used;
+	for(size_t i = 0; i < partitions.size(); i++) {
+		string name;
+		if(partition.mode == ofxCsvPartition::Value) {
+			// keep file name safe characters only
+			name = keys[i].substr(0, 64);
+			for(auto &c : name) {
+				if(!isalnum((unsigned char)c) && c != '-' && c != '_' && c != '.') {
+					c = '_';
+				}
+			}
+			if(name.empty()) {
+				name = "empty";
+			}
+			name = prefix + "_" + name;
+			string base = name;
+			for(int n = 1; used.count(name); n++) {
+				name = base + "_" + std::to_string(n);
+			}
+		}
+		else {
+			char number[32];
+			snprintf(number, sizeof(number), "%05zu", i);
+			name = prefix + "_" + number;
+		}
+		used.insert(name);
+		names[i] = name + extension;
+	}
+	
+	// write each partition to a temp file & replace when done
+	vector<uint64_t> bytes(partitions.size(), 0);
+	vector<uint8_t> written(partitions.size(), 0);
+	ofxCsvThreadPool::shared().parallelFor(0, partitions.size(), 1, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			string path = ofxCsvFileUtils::join(absoluteDir, names[i]);
+			string tempPath = path + ".tmp";
+			ofxCsvWriter writer;
+			if(!writer.open(tempPath, format)) {
+				continue;
+			}
+			if(header) {
+				writer.write(ofxCsvRow::toString(data[0].getData(), quote, fieldSeparator));
+				writer.write("\n", 1);
+			}
+			for(size_t row : partitions[i]) {
+				writer.write(ofxCsvRow::toString(data[row].getData(), quote, fieldSeparator));
+				writer.write("\n", 1);
+			}
+			if(writer.close() && replaceFile(tempPath, path)) {
+				bytes[i] = ofxCsvFileUtils::getSize(path); // compressed size, if any
+				written[i] = 1;
+			}
+			else {
+				remove(tempPath.c_str());
+			}
+		}
+	});
+	for(size_t i = 0; i < partitions.size(); i++) {
+		if(!written[i]) {
+			OFX_CSV_LOG_ERROR << "Could not save partition " << names[i] << " to " << directory;
 			return false;
 		}
 	}
-	if(!file.canWrite()) {
-		ofLogError("ofxCsv") << "Cannot save " << filePath << ": file not writable";
+	
+	// manifest
+	ofxCsvWriter manifest;
+	string manifestPath = ofxCsvFileUtils::join(absoluteDir, "manifest.csv");
+	if(!manifest.open(manifestPath, ofxCsvCompression::None)) {
+		OFX_CSV_LOG_ERROR << "Could not save partition manifest to " << directory;
 		return false;
 	}
-	if(file.isDirectory()) {
-		ofLogError("ofxCsv") << "Cannot save " << filePath << ": \"file\" is actually a directory";
+	bool byValue = (partition.mode == ofxCsvPartition::Value);
+	manifest.write(byValue ? "file,rows,bytes,key\n" : "file,rows,bytes\n");
+	for(size_t i = 0; i < partitions.size(); i++) {
+		string line = names[i] + "," + std::to_string(partitions[i].size()) + "," + std::to_string(bytes[i]);
+		if(byValue) {
+			line += ",\"";
+			for(char c : keys[i]) {
+				line += (c == '"' ? "\"\"" : string(1, c));
+			}
+			line += "\"";
+		}
+		manifest.write(line + "\n");
+	}
+	if(!manifest.close()) {
+		OFX_CSV_LOG_ERROR << "Could not save partition manifest to " << directory;
 		return false;
 	}
 	
-	// fill buffer & write to file
-	ofBuffer buffer;
-	int lineCount = 0;
-	for(auto row : data) {
-		buffer.append(toRowString(row, quote)+"\n");
-		lineCount++;
+	OFX_CSV_LOG_VERBOSE << "Wrote " << partitions.size() << " partitions to " << directory;
+	
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsv::loadArrow(const string &path, bool header) {
+	
+	clear();
+	
+	OFX_CSV_LOG_VERBOSE << "Loading Arrow " << path;
+	
+	string absolutePath = ofxCsvFileUtils::toDataPath(path);
+	if(!ofxCsvFileUtils::exists(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot load " << path << ": file not found";
+		return false;
 	}
-	if(!ofBufferToFile(file.getAbsolutePath(), buffer)) {
-		ofLogError("ofxCsv") << "Could not save to " << filePath << ": couldn't save buffer";
+	string error;
+	if(!ofxCsvArrow::read(absolutePath, header, data, schema, columns, error)) {
+		OFX_CSV_LOG_ERROR << "Cannot load " << path << ": " << error;
+		clear();
 		return false;
 	}
-	buffer.clear();
 	
-	ofLogVerbose("ofxCsv") << "Wrote " << lineCount << " lines to " << filePath;
+	OFX_CSV_LOG_VERBOSE << "Loaded a " << data.size() << "x" << schema.size() << " table";
 	
 	return true;
 }
 
 //--------------------------------------------------
-bool ofxCsv::save(const string &path, bool quote) {
-	return save(path, quote, fieldSeparator);
+bool ofxCsv::saveArrow(const string &path, bool header) const {
+	
+	OFX_CSV_LOG_VERBOSE << "Saving Arrow " << path;
+	
+	// use the typed columns if they match the rows, otherwise infer & parse
+	bool typed = (schema.size() > 0 && columns.size() == schema.size());
+	for(auto &column : columns) {
+		typed = typed && (column.size() == data.size());
+	}
+	ofxCsvSchema types = (typed ? schema : inferSchema(header, 0));
+	vector<ofxCsvColumn> parsed;
+	if(!typed) {
+		parsed.resize(types.size());
+		ofxCsvThreadPool::shared().parallelFor(0, types.size(), 1, [&](size_t begin, size_t end) {
+			for(size_t col = begin; col < end; col++) {
+				ofxCsvColumn column(types[col].type);
+				column.reserve(data.size());
+				for(size_t row = 0; row < data.size(); row++) {
+					const vector<string> &fields = data[row].getData();
+					if((header && row == 0) || col >= fields.size()) {
+						column.addNull();
+					}
+					else {
+						column.add(fields[col]);
+					}
+				}
+				parsed[col] = std::move(column);
+			}
+		});
+	}
+	if(header && !data.empty()) {
+		for(size_t col = 0; col < types.size(); col++) {
+			if(types[col].name.empty()) {
+				types[col].name = data[0].getString(col);
+			}
+		}
+	}
+	
+	string absolutePath = ofxCsvFileUtils::toDataPath(path);
+	string directory = ofxCsvFileUtils::getEnclosingDirectory(absolutePath);
+	if(!directory.empty()) {
+		ofxCsvFileUtils::createDirectory(directory);
+	}
+	if(!ofxCsvArrow::write(absolutePath, data, (header && !data.empty() ? 1 : 0),
+	                       types, (typed ? columns : parsed))) {
+		OFX_CSV_LOG_ERROR << "Could not save to " << path << ": couldn't write file";
+		return false;
+	}
+	
+	OFX_CSV_LOG_VERBOSE << "Wrote " << data.size() << " rows to " << path;
+	
+	return true;
+}
+
+//--------------------------------------------------
+void ofxCsv::markModified() {
+	saved.modified = true;
+	snapshots.all = true;
+}
+
+//--------------------------------------------------
+void ofxCsv::markModified(size_t row) {
+	if(row < saved.rows) {
+		saved.modified = true;
+	}
+	markRows(row, row+1);
+}
+
+//--------------------------------------------------
+bool ofxCsv::isModified() const {
+	return saved.modified || saved.rows != data.size();
 }
 
 //--------------------------------------------------
 bool ofxCsv::createFile(const string &path) {
-	ofLogVerbose("ofxCsv") << "Creating "  << path;
-	ofFile file(ofToDataPath(path), ofFile::WriteOnly, false);
-	return file.create();
+	OFX_CSV_LOG_VERBOSE << "Creating "  << path;
+	return ofxCsvFileUtils::createFile(ofxCsvFileUtils::toDataPath(path));
+}
+
+// LIVE RELOAD
+
+//--------------------------------------------------
+bool ofxCsv::watch(float interval) {
+	watched.enabled = false;
+	watched.interval = interval;
+	watched.changes.clear();
+	if(filePath.empty()) {
+		OFX_CSV_LOG_ERROR << "Cannot watch: no file path set";
+		return false;
+	}
+	if(!reload(true)) {
+		return false;
+	}
+	watched.enabled = true;
+	watched.checked = std::chrono::steady_clock::now();
+	watched.changes.clear();
+	OFX_CSV_LOG_VERBOSE << "Watching " << filePath << ": " << data.size() << " rows in "
+	                    << watched.index.getNumBlocks() << " blocks";
+	return true;
+}
+
+//--------------------------------------------------
+void ofxCsv::unwatch() {
+	watched.enabled = false;
+	watched.index.clear();
+	watched.changes.clear();
+}
+
+//--------------------------------------------------
+bool ofxCsv::isWatching() const {
+	return watched.enabled;
+}
+
+//--------------------------------------------------
+bool ofxCsv::update() {
+	watched.changes.clear();
+	if(!watched.enabled) {
+		return false;
+	}
+	auto now = std::chrono::steady_clock::now();
+	if(std::chrono::duration<float>(now - watched.checked).count() < watched.interval) {
+		return false;
+	}
+	watched.checked = now;
+
+	// the file may be missing briefly while an editor replaces it
+	struct stat info;
+	if(stat(ofxCsvFileUtils::toDataPath(filePath).c_str(), &info) != 0) {
+		return false;
+	}
+	if(info.st_mtime == watched.mtime && (uint64_t)info.st_size == watched.size && !watched.racy) {
+		return false;
+	}
+	// rows added or removed since don't line up with the index anymore
+	reload(data.size() != watched.index.getNumRows());
+	return !watched.changes.empty();
+}
+
+//--------------------------------------------------
+const vector<ofxCsvChange>& ofxCsv::getChanges() const {
+	return watched.changes;
 }
 
 /// DATA IO
@@ -210,11 +775,17 @@ void ofxCsv::expand(int rows, int cols) {
 		rows = max(rows, 1);
 	}
 	cols = max(cols, 1);
+	if(data.size() < (size_t)rows) {
+		markRows(data.size(), rows);
+	}
 	while(data.size() < rows) {
 		data.push_back(ofxCsvRow());
 	}
-	for(auto &row : data) {
-		row.expand(cols-1);
+	for(size_t i = 0; i < data.size(); i++) {
+		if(data[i].isSplit() && data[i].size() < (size_t)cols) {
+			markRows(i, i+1);
+		}
+		data[i].expand(cols-1);
 	}
 }
 
@@ -224,6 +795,10 @@ void ofxCsv::clear() {
 		row.clear();
 	}
 	data.clear();
+	schema = ofxCsvSchema();
+	columns.clear();
+	saved.modified = true;
+	snapshots.all = true;
 }
 
 /// ROW ACCESS
@@ -243,22 +818,31 @@ unsigned int ofxCsv::getNumCols(int row) const {
 
 //--------------------------------------------------
 ofxCsvRow& ofxCsv::getRow(int index) {
+	if(index >= 0 && (size_t)index < saved.rows) {
+		saved.modified = true;
+	}
 	expand(index, getNumCols()-1);
+	markRows(index, index+1);
 	return data[index];
 }
 
 //--------------------------------------------------
 void ofxCsv::addRow(ofxCsvRow &row) {
 	data.push_back(row);
+	markRows(data.size()-1, data.size());
 }
 
 //--------------------------------------------------
 void ofxCsv::addRow() {
 	data.push_back(ofxCsvRow());
+	markRows(data.size()-1, data.size());
 }
 
 //--------------------------------------------------
 void ofxCsv::setRow(int index, ofxCsvRow &row) {
+	if(index >= 0 && (size_t)index < saved.rows) {
+		saved.modified = true;
+	}
 	int c = getNumCols()-1;
 	if(data.empty() && index == 0) {
 		data.push_back(row);
@@ -267,10 +851,14 @@ void ofxCsv::setRow(int index, ofxCsvRow &row) {
 		expand(index+1, c);
 	}
 	data[index] = row;
+	markRows(index, index+1);
 }
 
 //--------------------------------------------------
 void ofxCsv::insertRow(int index, ofxCsvRow &row) {
+	if(index >= 0 && (size_t)index < saved.rows) {
+		saved.modified = true;
+	}
 	int c = getNumCols()-1;
 	if(data.empty() && index == 0) {
 		data.push_back(row);
@@ -280,19 +868,24 @@ void ofxCsv::insertRow(int index, ofxCsvRow &row) {
 		data.insert(data.begin()+index, row);
 	}
 	data[index].expand(c);
+	markRows(index, data.size());
 }
 
 //--------------------------------------------------
 void ofxCsv::removeRow(int index) {
+	if(index >= 0 && (size_t)index < saved.rows) {
+		saved.modified = true;
+	}
 	if(index < data.size()) {
 		data.erase(data.begin()+index);
+		markRows(index, data.size()+1);
 	}
 }
 
 //--------------------------------------------------
 void ofxCsv::print() const {
 	for(auto &row : data) {
-		ofLog() << row;
+		OFX_CSV_LOG_NOTICE << row;
 	}
 }
 
@@ -303,6 +896,11 @@ vector<ofxCsvRow>& ofxCsv::getData() {
 	return data;
 }
 
+//--------------------------------------------------
+const vector<ofxCsvRow>& ofxCsv::getData() const {
+	return data;
+}
+
 //--------------------------------------------------
 vector<ofxCsvRow>::iterator ofxCsv::begin() {
 	return data.begin();
@@ -378,10 +976,300 @@ bool ofxCsv::empty() const {
 	return data.empty();
 }
 
+// PARALLEL PROCESSING
+
+//--------------------------------------------------
+void ofxCsv::parallelForEachRow(const std::function<void(ofxCsvRow &row, size_t index)> &function,
+                                size_t grainSize) {
+	if(saved.rows > 0) {
+		saved.modified = true;
+	}
+	snapshots.all = true;
+	ofxCsvThreadPool::shared().parallelFor(0, data.size(), grainSize, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			function(data[i], i);
+		}
+	});
+}
+
+//--------------------------------------------------
+ofxCsv ofxCsv::parallelMapRows(const std::function<ofxCsvRow(const ofxCsvRow &row, size_t index)> &function,
+                               size_t grainSize) const {
+	ofxCsv result;
+	result.fieldSeparator = fieldSeparator;
+	result.commentPrefix = commentPrefix;
+	result.data.resize(data.size());
+	ofxCsvThreadPool::shared().parallelFor(0, data.size(), grainSize, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			result.data[i] = function(data[i], i);
+		}
+	});
+	return result;
+}
+
+// SNAPSHOTS
+
+//--------------------------------------------------
+std::shared_ptr<const ofxCsvSnapshot> ofxCsv::publish() {
+	const size_t blockSize = ofxCsvSnapshot::BlockSize;
+	std::shared_ptr<const ofxCsvSnapshot> previous = std::atomic_load(&snapshots.current);
+	auto snapshot = std::make_shared<ofxCsvSnapshot>();
+	snapshot->numRows = data.size();
+	snapshot->version = (previous ? previous->version + 1 : 1);
+	snapshot->blocks.resize((data.size() + blockSize - 1) / blockSize);
+
+	// share unmodified blocks, copy the rest in parallel
+	vector<size_t> copies;
+	for(size_t block = 0; block < snapshot->blocks.size(); block++) {
+		size_t rows = std::min(blockSize, data.size() - block * blockSize);
+		bool modified = (snapshots.all || !previous || block >= previous->blocks.size() ||
+		                 (block < snapshots.modified.size() && snapshots.modified[block]) ||
+		                 previous->blocks[block]->size() != rows);
+		if(modified) {
+			copies.push_back(block);
+		}
+		else {
+			snapshot->blocks[block] = previous->blocks[block];
+		}
+	}
+	ofxCsvThreadPool::shared().parallelFor(0, copies.size(), 1, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			size_t first = copies[i] * blockSize;
+			size_t last = std::min(first + blockSize, data.size());
+			for(size_t row = first; row < last; row++) {
+				data[row].getData(); // split lazy rows once, in the table
+			}
+			snapshot->blocks[copies[i]] = std::make_shared<const ofxCsvSnapshot::Block>(data.begin() + first, data.begin() + last);
+		}
+	});
+	snapshot->copiedBlocks = copies.size();
+	snapshots.modified.clear();
+	snapshots.all = false;
+
+	std::shared_ptr<const ofxCsvSnapshot> result = snapshot;
+	std::atomic_store(&snapshots.current, result);
+	OFX_CSV_LOG_VERBOSE << "Published version " << snapshot->version << ": copied " << copies.size()
+	                    << " of " << snapshot->blocks.size() << " row blocks";
+	return result;
+}
+
+//--------------------------------------------------
+std::shared_ptr<const ofxCsvSnapshot> ofxCsv::getSnapshot() const {
+	static const std::shared_ptr<const ofxCsvSnapshot> s_emptySnapshot = std::make_shared<ofxCsvSnapshot>();
+	std::shared_ptr<const ofxCsvSnapshot> snapshot = std::atomic_load(&snapshots.current);
+	return (snapshot ? snapshot : s_emptySnapshot);
+}
+
+// TYPED COLUMNS
+
+//--------------------------------------------------
+ofxCsvSchema ofxCsv::inferSchema(bool header, size_t sampleSize, unsigned int threads) const {
+	return ofxCsvSchema::infer(data, header, sampleSize, threads);
+}
+
+//--------------------------------------------------
+void ofxCsv::setSchema(const ofxCsvSchema &schema) {
+	this->schema = schema;
+	updateColumns();
+}
+
+//--------------------------------------------------
+const ofxCsvSchema& ofxCsv::getSchema() const {
+	return schema;
+}
+
+//--------------------------------------------------
+const ofxCsvColumn& ofxCsv::getColumn(int col) const {
+	static const ofxCsvColumn s_emptyColumn;
+	if(col < 0 || (size_t)col >= columns.size()) {
+		return s_emptyColumn;
+	}
+	return columns[col];
+}
+
+//--------------------------------------------------
+int ofxCsv::getColumnIndex(const string &name, bool header) const {
+	vector<string> names = getColumnNames(header);
+	for(size_t i = 0; i < names.size(); i++) {
+		if(names[i] == name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+//--------------------------------------------------
+void ofxCsv::updateColumns() {
+	columns.clear();
+	for(auto &column : schema.getColumns()) {
+		columns.push_back(ofxCsvColumn(column.type));
+		columns.back().reserve(data.size());
+	}
+	if(columns.empty()) {
+		return;
+	}
+	for(size_t row = 0; row < data.size(); row++) {
+		parseColumns(data[row].getData(), row);
+	}
+}
+
+// ANALYSIS
+
+//--------------------------------------------------
+ofxCsv ofxCsv::aggregate(const vector<int> &groupCols,
+                         const vector<ofxCsvAggregate> &aggregates,
+                         bool header, unsigned int threads) const {
+	ofxCsv result;
+	result.fieldSeparator = fieldSeparator;
+	result.commentPrefix = commentPrefix;
+	if(header && !data.empty()) {
+		ofxCsvRow names;
+		for(int col : groupCols) {
+			names.addString(data[0].getString(col));
+		}
+		for(auto &aggregate : aggregates) {
+			names.addString(aggregate.getName(data[0].getString(aggregate.col)));
+		}
+		result.data.push_back(names);
+	}
+	vector<ofxCsvRow> rows = ofxCsvAggregate::apply(data, (header ? 1 : 0),
+	                                                groupCols, aggregates, threads);
+	result.data.insert(result.data.end(), std::make_move_iterator(rows.begin()),
+	                   std::make_move_iterator(rows.end()));
+	return result;
+}
+
+//--------------------------------------------------
+vector<size_t> ofxCsv::select(const string &expression, bool header) const {
+	ofxCsvQuery query;
+	if(!query.compile(expression, getColumnNames(header))) {
+		OFX_CSV_LOG_ERROR << "Cannot compile query \"" << expression << "\": " << query.getError();
+		return vector<size_t>();
+	}
+	return query.select(*this, header);
+}
+
+//--------------------------------------------------
+ofxCsv ofxCsv::filter(const string &expression, bool header) const {
+	ofxCsvQuery query;
+	if(!query.compile(expression, getColumnNames(header))) {
+		OFX_CSV_LOG_ERROR << "Cannot compile query \"" << expression << "\": " << query.getError();
+		ofxCsv result;
+		result.fieldSeparator = fieldSeparator;
+		result.commentPrefix = commentPrefix;
+		return result;
+	}
+	return filter(query, header);
+}
+
+//--------------------------------------------------
+ofxCsv ofxCsv::filter(const ofxCsvQuery &query, bool header) const {
+	ofxCsv result;
+	result.fieldSeparator = fieldSeparator;
+	result.commentPrefix = commentPrefix;
+	vector<size_t> rows = query.select(*this, header);
+	result.data.reserve(rows.size() + 1);
+	if(header && !data.empty()) {
+		result.data.push_back(data[0]);
+	}
+	for(size_t row : rows) {
+		result.data.push_back(data[row]);
+	}
+	return result;
+}
+
+//--------------------------------------------------
+vector<double> ofxCsv::getValues(int col, bool header) const {
+	size_t first = (header && !data.empty() ? 1 : 0);
+	vector<double> values;
+	values.reserve(data.size() - first);
+	const ofxCsvColumn &column = getColumn(col);
+	if(column.getType() != ofxCsvSchema::String && column.size() == data.size()) {
+		for(size_t row = first; row < data.size(); row++) {
+			values.push_back(column.isNull(row) ? NAN : column.getDouble(row));
+		}
+		return values;
+	}
+	for(size_t row = first; row < data.size(); row++) {
+		const vector<string> &fields = data[row].getData();
+		double value;
+		if(col < 0 || (size_t)col >= fields.size() || !ofxCsvColumn::parseFloat(fields[col], value)) {
+			value = NAN;
+		}
+		values.push_back(value);
+	}
+	return values;
+}
+
+//--------------------------------------------------
+vector<int64_t> ofxCsv::getTimestamps(int col, bool header, ofxCsvTimestamp::Format format) const {
+	size_t first = (header && !data.empty() ? 1 : 0);
+	vector<int64_t> values(data.size() - first, ofxCsvTimestamp::Missing);
+	const ofxCsvColumn &column = getColumn(col);
+	if(format == ofxCsvTimestamp::Iso8601 && column.getType() == ofxCsvSchema::Timestamp &&
+	   column.size() == data.size()) {
+		for(size_t row = first; row < data.size(); row++) {
+			if(!column.isNull(row)) {
+				values[row - first] = column.getInt(row);
+			}
+		}
+		return values;
+	}
+	ofxCsvThreadPool::shared().parallelFor(first, data.size(), 16384, [&](size_t begin, size_t end) {
+		for(size_t row = begin; row < end; row++) {
+			values[row - first] = data[row].getTimestamp(col, format);
+		}
+	});
+	return values;
+}
+
+//--------------------------------------------------
+vector<double> ofxCsv::rolling(int col, ofxCsvRolling::Op op, size_t window,
+                               bool header, size_t minValues) const {
+	return ofxCsvRolling::apply(getValues(col, header), op, window, minValues);
+}
+
+//--------------------------------------------------
+int ofxCsv::addRollingColumn(int col, ofxCsvRolling::Op op, size_t window,
+                             bool header, size_t minValues) {
+	if(saved.rows > 0) {
+		saved.modified = true;
+	}
+	snapshots.all = true;
+	int newCol = 0;
+	for(auto &row : data) {
+		newCol = max(newCol, (int)row.size());
+	}
+	size_t first = 0;
+	if(header && !data.empty()) {
+		ofxCsvRolling rolling(op, window);
+		data[0].setString(newCol, rolling.getName(col, data[0].getString(col)));
+		first = 1;
+	}
+	ofxCsvRolling rolling(op, window, minValues);
+	vector<double> values = getValues(col, header);
+	char buffer[32];
+	for(size_t i = 0; i < values.size(); i++) {
+		double result = rolling.push(values[i]);
+		if(std::isnan(result)) {
+			data[first+i].setString(newCol, "");
+		}
+		else {
+			snprintf(buffer, sizeof(buffer), "%.15g", result);
+			data[first+i].setString(newCol, buffer);
+		}
+	}
+	return newCol;
+}
+
 // UTIL
 
 //--------------------------------------------------
 void ofxCsv::trim() {
+	if(saved.rows > 0) {
+		saved.modified = true;
+	}
+	snapshots.all = true;
 	for(int row = 0; row < data.size(); row++) {
 		data[row].trim();
 	}
@@ -417,12 +1305,455 @@ string ofxCsv::getComment() const {
 	return commentPrefix;
 }
 
+//--------------------------------------------------
+void ofxCsv::setCompression(ofxCsvCompression compression) {
+	this->compression = compression;
+}
+
+//--------------------------------------------------
+ofxCsvCompression ofxCsv::getCompression() const {
+	return compression;
+}
+
+//--------------------------------------------------
+void ofxCsv::setEncoding(ofxCsvEncoding encoding) {
+	this->encoding = encoding;
+}
+
+//--------------------------------------------------
+ofxCsvEncoding ofxCsv::getEncoding() const {
+	return encoding;
+}
+
+//--------------------------------------------------
+void ofxCsv::setLazy(bool lazy) {
+	this->lazy = lazy;
+}
+
+//--------------------------------------------------
+bool ofxCsv::isLazy() const {
+	return lazy;
+}
+
+//--------------------------------------------------
+const ofxCsvStats& ofxCsv::getStats() const {
+	return stats;
+}
+
+//--------------------------------------------------
+void ofxCsv::setStatsCallback(std::function<void(const ofxCsvStats &stats)> callback) {
+	statsCallback = callback;
+}
+
 // PROTECTED
 
+//--------------------------------------------------
+void ofxCsv::reserve(const char *text, size_t size, size_t &numFields) {
+	
+	// every row ends with a newline, except maybe the last, so this is an
+	// upper bound as empty & comment lines are counted too
+	size_t numLines = ofxCsvSimd::count(text, size, '\n') + 1;
+	data.reserve(data.size() + numLines);
+	for(auto &column : columns) {
+		column.reserve(numLines);
+	}
+	
+	// estimate fields per row from the separators in the first lines
+	size_t sampleSize = std::min<size_t>(size, 64 * 1024);
+	size_t sampleLines = ofxCsvSimd::count(text, sampleSize, '\n') + 1;
+	char sepStart = (fieldSeparator.empty() ? ',' : fieldSeparator[0]);
+	size_t separators = ofxCsvSimd::count(text, sampleSize, sepStart);
+	numFields = separators / sampleLines + 1;
+	
+	OFX_CSV_LOG_VERBOSE << "  reserved " << numLines << " rows of ~" << numFields << " fields";
+}
+
+//--------------------------------------------------
+void ofxCsv::setSaved(const string &absolutePath, size_t rows, bool newline, ofxCsvEncoding encoding, bool quote) {
+	saved.path = absolutePath;
+	saved.separator = fieldSeparator;
+	saved.compression = getFileCompression();
+	saved.encoding = encoding;
+	saved.quote = quote;
+	saved.rows = rows;
+	saved.size = ofxCsvFileUtils::getSize(absolutePath);
+	saved.newline = newline;
+	saved.modified = false;
+}
+
+//--------------------------------------------------
+ofxCsvCompression ofxCsv::getFileCompression() const {
+	if(compression == ofxCsvCompression::Auto) {
+		return ofxCsvReader::detectCompression(filePath);
+	}
+	return compression;
+}
+
 //--------------------------------------------------
 void ofxCsv::expandRow(int row, int cols) {
+	if(row >= 0 && data.size() <= (size_t)row) {
+		markRows(data.size(), row+1);
+	}
 	while(data.size() <= row) {
 		data.push_back(ofxCsvRow());
 	}
 	data[row].expand(cols);
 }
+
+//--------------------------------------------------
+void ofxCsv::markRows(size_t begin, size_t end) {
+	if(snapshots.all || begin >= end) {
+		return;
+	}
+	size_t last = (end - 1) / ofxCsvSnapshot::BlockSize;
+	if(snapshots.modified.size() <= last) {
+		snapshots.modified.resize(last + 1, 0);
+	}
+	for(size_t block = begin / ofxCsvSnapshot::BlockSize; block <= last; block++) {
+		snapshots.modified[block] = 1;
+	}
+}
+
+//--------------------------------------------------
+void ofxCsv::beginStats(ofxCsvStats::Operation operation) {
+	stats = ofxCsvStats();
+	stats.operation = operation;
+	stats.path = filePath;
+	statsStarted = std::chrono::steady_clock::now();
+}
+
+//--------------------------------------------------
+bool ofxCsv::endStats(bool success) {
+	stats.success = success;
+	stats.totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - statsStarted).count();
+	if(statsCallback) {
+		statsCallback(stats);
+	}
+	return success;
+}
+
+//--------------------------------------------------
+bool ofxCsv::loadFile() {
+	
+	// verbose log print
+	OFX_CSV_LOG_VERBOSE << "Loading " << filePath;
+	OFX_CSV_LOG_VERBOSE << "  separator: " << fieldSeparator;
+	OFX_CSV_LOG_VERBOSE << "  comment: " << commentPrefix;
+	beginStats(ofxCsvStats::Load);
+	
+	// do some checks
+	string absolutePath = ofxCsvFileUtils::toDataPath(filePath);
+	if(!ofxCsvFileUtils::exists(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": file not found";
+		return endStats(false);
+	}
+	if(!ofxCsvFileUtils::canRead(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": file not readable";
+		return endStats(false);
+	}
+	if(ofxCsvFileUtils::isDirectory(absolutePath)) {
+		OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": \"file\" is actually a directory";
+		return endStats(false);
+	}
+	
+	// open file & read each line
+	int lineCount = 0;
+	int maxCols = 0;
+	size_t fieldsHint = 1;
+	size_t numFields = 0;
+	auto parseLine = [&](const string &line) {
+		
+		// skip empty lines
+		if(line.empty()) {
+			OFX_CSV_LOG_VERBOSE << "Skipping empty line: " << lineCount;
+			lineCount++;
+			return;
+		}
+		
+		// skip comment lines
+		// TODO: only checks substring at line beginning, does not ignore whitespace
+		if(line.substr(0, commentPrefix.length()) == commentPrefix) {
+			OFX_CSV_LOG_VERBOSE << "Skipping comment line: " << lineCount;
+			lineCount++;
+			return;
+		}
+		
+		// split line into separate files
+		vector<string> cols = ofxCsvRow::fromString(line, fieldSeparator, fieldsHint);
+		if(!columns.empty()) {
+			parseColumns(cols, data.size());
+		}
+	
+		// calc maxium table cols
+		numFields += cols.size();
+		if((int)cols.size() > maxCols) {
+			maxCols = cols.size();
+		}
+		data.push_back(std::move(cols));
+		lineCount++;
+	};
+	bool endsWithNewline = false; // unknown for compressed files
+	ofxCsvCompression format = getFileCompression();
+	ofxCsvReader reader;
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed = [&start]() {
+		auto now = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(now - start).count();
+		start = now;
+		return seconds;
+	};
+	if(lazy && columns.empty()) {
+		// keep the text & only find the lines, rows are split on first access
+		auto text = std::make_shared<ofxCsvRow::LazyText>();
+		text->separator = fieldSeparator;
+		if(!readFileText(absolutePath, text->text, reader)) {
+			OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": "
+			                  << (ofxCsvReader::isSupported(format) ? "couldn't read file" : "compression format not supported");
+			return endStats(false);
+		}
+		stats.readTime = elapsed();
+		const char *begin = text->text.data();
+		size_t size = text->text.size();
+		stats.bytes = size;
+		data.reserve(ofxCsvSimd::count(begin, size, '\n') + 1);
+		size_t pos = 0;
+		while(pos < size) {
+			const char *newline = (const char *)memchr(begin + pos, '\n', size - pos);
+			size_t end = (newline ? newline - begin : size);
+			size_t len = end - pos;
+			if(len > 0 && begin[end-1] == '\r') {
+				len--;
+			}
+			if(len > 0 && !(len >= commentPrefix.size() && memcmp(begin + pos, commentPrefix.data(), commentPrefix.size()) == 0)) {
+				data.push_back(ofxCsvRow());
+				data.back().loadLazy(text, pos, len);
+			}
+			lineCount++;
+			pos = end + 1;
+		}
+		if(format == ofxCsvCompression::None) {
+			endsWithNewline = (size == 0 || begin[size-1] == '\n');
+		}
+		stats.parseTime = elapsed();
+	}
+	else if(format == ofxCsvCompression::None) {
+		string text;
+		if(!readFileText(absolutePath, text, reader)) {
+			OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": couldn't read file";
+			return endStats(false);
+		}
+		stats.readTime = elapsed();
+		stats.bytes = text.size();
+		reserve(text.data(), text.size(), fieldsHint);
+		string line;
+		size_t pos = 0;
+		while(pos < text.size()) {
+			size_t end = text.find('\n', pos);
+			if(end == string::npos) {
+				end = text.size();
+			}
+			size_t len = end - pos;
+			if(len > 0 && text[end-1] == '\r') {
+				len--;
+			}
+			line.assign(text, pos, len);
+			parseLine(line);
+			pos = end + 1;
+		}
+		endsWithNewline = (text.empty() || text.back() == '\n');
+		stats.parseTime = elapsed();
+	}
+	else {
+		// decompress & parse block by block
+		reader.setEncoding(encoding);
+		if(!reader.open(absolutePath, format)) {
+			OFX_CSV_LOG_ERROR << "Cannot load " << filePath << ": "
+			                  << (ofxCsvReader::isSupported(format) ? "couldn't open file" : "compression format not supported");
+			return endStats(false);
+		}
+		string line;
+		while(reader.readLine(line)) {
+			parseLine(line);
+		}
+		if(reader.hasError()) {
+			OFX_CSV_LOG_ERROR << "Error reading " << filePath << ": data may be incomplete or corrupt";
+		}
+		// blocks are decompressed as lines are read, so split the time
+		stats.readTime = reader.getReadTime();
+		stats.parseTime = std::max(elapsed() - stats.readTime, 0.0);
+		stats.bytes = reader.getBytesRead();
+	}
+	if(reader.getNumInvalid() > 0) {
+		OFX_CSV_LOG_WARNING << "Loaded " << filePath << " with " << reader.getNumInvalid() << " invalid "
+		                    << ofxCsvDecoder::getName(reader.getEncoding()) << " sequences, first at byte "
+		                    << reader.getFirstInvalid();
+	}
+	stats.encoding = reader.getEncoding();
+	stats.invalidSequences = reader.getNumInvalid();
+	
+	setSaved(absolutePath, data.size(), endsWithNewline, reader.getEncoding());
+	
+	// expand to fill in any missing cols, just in case
+	expand(data.size(), maxCols);
+	for(auto &column : columns) {
+		while(column.size() < data.size()) {
+			column.addNull();
+		}
+	}
+	stats.expandTime = elapsed();
+	
+	// count cells & estimate allocations, short strings are stored inline
+	stats.rows = data.size();
+	stats.maxCols = maxCols;
+	stats.fields = numFields;
+	stats.allocations = (data.capacity() > 0 ? 1 : 0);
+	if(lazy && columns.empty()) {
+		stats.allocations++; // shared file text
+	}
+	else {
+		stats.paddedCells = data.size() * maxCols - numFields;
+		const size_t inlineCapacity = string().capacity();
+		for(auto &row : data) {
+			const vector<string> &fields = row.getData();
+			stats.allocations += (fields.capacity() > 0 ? 1 : 0);
+			for(auto &field : fields) {
+				stats.allocations += (field.capacity() > inlineCapacity ? 1 : 0);
+			}
+		}
+	}
+
+	OFX_CSV_LOG_VERBOSE << "Read " << lineCount << " lines from " << filePath;
+	OFX_CSV_LOG_VERBOSE << "Loaded a " << data.size() << "x" << maxCols << " table";
+	
+	return endStats(true);
+}
+
+//--------------------------------------------------
+bool ofxCsv::reload(bool all) {
+	string absolutePath = ofxCsvFileUtils::toDataPath(filePath);
+	struct stat info;
+	string text;
+	ofxCsvReader reader;
+	if(stat(absolutePath.c_str(), &info) != 0 || !readFileText(absolutePath, text, reader)) {
+		OFX_CSV_LOG_ERROR << "Cannot reload " << filePath << ": couldn't read file";
+		return false;
+	}
+
+	// mtime only has second resolution on some file systems, so keep
+	// checking the contents while a same-sized edit could go unnoticed
+	watched.mtime = info.st_mtime;
+	watched.size = info.st_size;
+	watched.racy = (info.st_mtime >= time(nullptr) - 1);
+
+	ofxCsvFileIndex index;
+	index.build(text.data(), text.size(), commentPrefix);
+	watched.changes.clear();
+	if(!all) {
+		watched.changes = index.diff(watched.index);
+	}
+	else if(!data.empty() || index.getNumRows() > 0) {
+		ofxCsvChange change;
+		change.removed = data.size();
+		change.added = index.getNumRows();
+		watched.changes.push_back(change);
+	}
+	applyChanges(index, watched.changes);
+	index.releaseText();
+	watched.index = std::move(index);
+	setSaved(absolutePath, data.size(), (text.empty() || text.back() == '\n'), reader.getEncoding());
+
+	if(!watched.changes.empty()) {
+		OFX_CSV_LOG_VERBOSE << "Reloaded " << watched.changes.size() << " changed row ranges from " << filePath;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsv::readFileText(const string &absolutePath, string &text, ofxCsvReader &reader) const {
+	reader.setEncoding(encoding);
+	if(!reader.open(absolutePath, getFileCompression())) {
+		return false;
+	}
+	return reader.readAll(text);
+}
+
+//--------------------------------------------------
+void ofxCsv::applyChanges(const ofxCsvFileIndex &index, const vector<ofxCsvChange> &changes) {
+	// the width of unchanged rows, unless all rows are replaced
+	bool all = (changes.size() == 1 && changes[0].row == 0 && changes[0].removed == data.size());
+	size_t cols = (all ? 0 : getNumCols());
+	size_t maxCols = 0;
+	for(auto &change : changes) {
+
+		// replace rows in place, then remove or insert the difference
+		size_t common = std::min(change.removed, change.added);
+		for(size_t i = 0; i < common; i++) {
+			data[change.row + i].getData() = ofxCsvRow::fromString(index.getLine(change.row + i), fieldSeparator);
+		}
+		if(change.removed > common) {
+			data.erase(data.begin() + change.row + common, data.begin() + change.row + change.removed);
+		}
+		else if(change.added > common) {
+			vector<ofxCsvRow> rows;
+			rows.reserve(change.added - common);
+			for(size_t i = common; i < change.added; i++) {
+				rows.push_back(ofxCsvRow::fromString(index.getLine(change.row + i), fieldSeparator));
+			}
+			data.insert(data.begin() + change.row + common,
+			            std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+		}
+		for(size_t i = 0; i < change.added; i++) {
+			maxCols = std::max(maxCols, data[change.row + i].size());
+		}
+		// later rows shift if the number of rows changed
+		markRows(change.row, (change.removed == change.added ? change.row + change.added : data.size() + 1));
+	}
+
+	// keep all rows the same width like load()
+	if(maxCols > cols) {
+		for(auto &row : data) {
+			row.expand(maxCols - 1);
+		}
+		snapshots.all = true;
+	}
+	else if(cols > 0) {
+		for(auto &change : changes) {
+			for(size_t i = 0; i < change.added; i++) {
+				data[change.row + i].expand(cols - 1);
+			}
+		}
+	}
+	if(!columns.empty() && !changes.empty()) {
+		updateColumns();
+	}
+}
+
+//--------------------------------------------------
+void ofxCsv::parseColumns(const vector<string> &fields, size_t row) {
+	if(row == 0 && schema.hasHeader()) {
+		for(auto &column : columns) {
+			column.addNull();
+		}
+		return;
+	}
+	for(size_t col = 0; col < columns.size(); col++) {
+		if(col < fields.size()) {
+			columns[col].add(fields[col]);
+		}
+		else {
+			columns[col].addNull();
+		}
+	}
+}
+
+//--------------------------------------------------
+vector<string> ofxCsv::getColumnNames(bool header) const {
+	if(header && !data.empty()) {
+		return data[0].getData();
+	}
+	vector<string> names;
+	for(auto &column : schema.getColumns()) {
+		names.push_back(column.name);
+	}
+	return names;
+}
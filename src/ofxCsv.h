@@ -31,6 +31,28 @@
 #pragma once
 
 #include "ofxCsvRow.h"
+#include "ofxCsvAggregate.h"
+#include "ofxCsvAppender.h"
+#include "ofxCsvArrow.h"
+#include "ofxCsvColumn.h"
+#include "ofxCsvDiff.h"
+#include "ofxCsvFileIndex.h"
+#include "ofxCsvPartition.h"
+#include "ofxCsvQuery.h"
+#include "ofxCsvRolling.h"
+#include "ofxCsvSampler.h"
+#include "ofxCsvSimd.h"
+#include "ofxCsvSnapshot.h"
+#include "ofxCsvStats.h"
+#include "ofxCsvThreadPool.h"
+#include "ofxCsvWriter.h"
+
+#ifndef OFX_CSV_STANDALONE
+	#include "ofxCsvGeometry.h"
+#endif
+
+#include <chrono>
+#include <functional>
 
 /// \class ofxCsv
 /// \brief table data loaded from & saved to CSV (Character Separated Value) files
@@ -45,6 +67,11 @@
 ///   * Fields are saved without quotes by default.
 ///   * ALL Fields can be quoted if desired, ie. 1.23 -> "1.23"
 ///
+/// Compression notes:
+///   * Files ending in .gz (gzip) or .zst (Zstandard) are decompressed while
+///     loading & compressed while saving, in blocks.
+///   * Zstandard support requires libzstd & OFX_CSV_ZSTD to be defined.
+///
 /// See https://en.wikipedia.org/wiki/Comma-separated_values for format info.
 ///
 class ofxCsv {
@@ -89,9 +116,80 @@ class ofxCsv {
 		/// \returns true if file loaded successfully
 		bool load(const string &path="");
 	
+		/// Load a CSV File directly into typed columns.
+		///
+		/// Clears any currently loaded data, sets the current path & schema,
+		/// & parses each field into the typed column given by the schema,
+		/// skipping type inference. If the schema has a header, the first row
+		/// is kept as strings only.
+		///
+		/// Uses the current field separator & comment line prefix.
+		///
+		/// \param path File path to load.
+		/// \param schema Column types.
+		/// \returns true if file loaded successfully
+		bool load(const string &path, const ofxCsvSchema &schema);
+	
+		/// Load a random sample of rows from a CSV file.
+		///
+		/// Clears any currently loaded data but does not change the current
+		/// file path, so the sample can't accidentally overwrite the file.
+		/// Uses the current field separator & comment line prefix. Rows are
+		/// kept in file order.
+		///
+		/// By default, rows are read at random byte offsets which only reads
+		/// about two rows per sample, even for very large files, but favors
+		/// rows which follow long rows. The exact mode streams the whole file
+		/// with reservoir sampling in constant memory & is always used for
+		/// compressed or small files.
+		///
+		/// \param path File path to load.
+		/// \param numRows Number of rows to sample.
+		/// \param header Always include the first row? default false.
+		/// \param exact Use exact uniform sampling? default false.
+		/// \param seed Random seed for repeatable samples, 0 seeds randomly.
+		/// \returns true if file loaded successfully
+		bool loadSample(const string &path, size_t numRows, bool header=false,
+		                bool exact=false, uint64_t seed=0);
+	
+		/// Load multiple CSV files into a single table, ie. rotated shards.
+		///
+		/// Clears any currently loaded data but does not change the current
+		/// file path. Files are loaded concurrently on the shared thread pool
+		/// & their rows moved into the table in the given order. All files
+		/// must have the same number of columns &, if there is a header, the
+		/// same header row which is kept only once. Uses the current field
+		/// separator, comment line prefix, compression, encoding, & lazy
+		/// loading setting.
+		///
+		/// \param paths File paths to load, in order.
+		/// \param header Does each file start with a header row? default false.
+		/// \returns true if all files loaded successfully & agree, the table
+		///          is left empty otherwise
+		bool loadFiles(const vector<string> &paths, bool header=false);
+	
+		/// Load all CSV files matching a pattern into a single table.
+		///
+		/// \param pattern File path pattern, see findFiles().
+		/// \param header Does each file start with a header row? default false.
+		/// \returns true if at least one file matched, all files loaded
+		///          successfully, & agree
+		bool loadMatching(const string &pattern, bool header=false);
+	
+		/// Find the files matching a pattern, ie. "logs/data_*.csv".
+		///
+		/// The file name may contain * to match any characters & ? to match a
+		/// single character. Matches are sorted naturally, so data_2.csv comes
+		/// before data_10.csv.
+		///
+		/// \param pattern File path pattern, relative to the data path.
+		/// \returns matching file paths, sorted
+		static vector<string> findFiles(const string &pattern);
+	
 		/// Save a CSV file.
 		///
-		/// Creates any required folders in the path, if needed.
+		/// Creates any required folders in the path, if needed. Writes to a
+		/// temporary file first & replaces the original when done.
 		///
 		/// \param filePath File path to save.
 		/// \param quote Should the fields be double quoted?
@@ -109,6 +207,87 @@ class ofxCsv {
 		/// \returns true if file saved successfully
 		bool save(const string &path="", bool quote=false);
 	
+		/// Save only the changes since the last load or save.
+		///
+		/// Appends rows added since to the end of the file if nothing before
+		/// them changed, the file wasn't modified by someone else, & the
+		/// field separator & quoting are the same. Otherwise rewrites the whole
+		/// file like save(). Loaded files are assumed to be unquoted.
+		///
+		/// Changes via getRow() & the row editing functions are tracked.
+		/// Changes made via raw access (operator[], at(), getData(),
+		/// iterators, etc) are not, call markModified() after editing
+		/// existing rows this way.
+		///
+		/// \param path File path to save. Leave empty to save current file.
+		/// \param quote Should the fields be double quoted? default false.
+		/// \returns true if file saved successfully
+		bool saveChanges(const string &path="", bool quote=false);
+	
+		/// Save the table split into multiple CSV files in a directory.
+		///
+		/// Files are written concurrently on the shared thread pool through
+		/// buffered writers, using the current field separator & compression,
+		/// & named prefix_<key value>.csv for Value partitions or
+		/// prefix_00000.csv, prefix_00001.csv, etc otherwise. Hash file N
+		/// always holds hash bucket N, so it may only contain the header. When
+		/// all files are written, a manifest.csv listing each file with its
+		/// number of rows & size in bytes, & key value for Value partitions, is
+		/// written last.
+		/// Creates the directory, if needed. Doesn't change the current path.
+		///
+		/// \param directory Directory path to save to.
+		/// \param partition How to split the rows, see ofxCsvPartition.
+		/// \param header Is the first row a header? If so, it is written at
+		///               the start of each file. default false.
+		/// \param quote Should the fields be double quoted? default false.
+		/// \param prefix File name prefix. default "part"
+		/// \returns true if all files saved successfully
+		bool savePartitioned(const string &directory, const ofxCsvPartition &partition,
+		                     bool header=false, bool quote=false,
+		                     const string &prefix="part") const;
+	
+		/// Mark existing rows as modified, forcing the next saveChanges() to
+		/// rewrite the whole file & the next publish() to copy all rows.
+		void markModified();
+	
+		/// Mark a row edited via raw access as modified.
+		///
+		/// Like markModified() but the next publish() only copies the block
+		/// containing the row.
+		///
+		/// \param row Row number.
+		void markModified(size_t row);
+	
+		/// Are there any unsaved changes?
+		///
+		/// \returns true if rows were added or tracked edits were made since
+		///          the last load or save
+		bool isModified() const;
+	
+		/// Load an Apache Arrow IPC file or stream.
+		///
+		/// Clears any currently loaded data & fills the rows, schema, & typed
+		/// columns directly from the Arrow column buffers. Does not change the
+		/// current file path. See ofxCsvArrow for the supported types.
+		///
+		/// \param path File path to load, .arrows for the stream format.
+		/// \param header Add a header row with the field names? default false.
+		/// \returns true if file loaded successfully
+		bool loadArrow(const string &path, bool header=false);
+	
+		/// Save as an Apache Arrow IPC file or stream.
+		///
+		/// Uses the current schema & typed columns, if set, otherwise infers
+		/// the column types from all rows. Other tools can then memory map
+		/// the columns without parsing. See ofxCsvArrow for the type mapping.
+		///
+		/// \param path File path to save, .arrows for the stream format.
+		/// \param header Is the first row a header with column names? If so,
+		///               it's used for the Arrow field names. default false.
+		/// \returns true if file saved successfully
+		bool saveArrow(const string &path, bool header=false) const;
+	
 		/// Create an empty CSV file.
 		///
 		/// Creates any required folders in the path, if needed.
@@ -117,6 +296,49 @@ class ofxCsv {
 		/// \returns true if file saved successfully
 		bool createFile(const string &path);
 	
+	/// \section Live Reload
+	
+		/// Watch the current file for changes, ie. a config table edited live.
+		///
+		/// (Re)loads the file & indexes it with block & row content hashes.
+		/// Call update() regularly to apply changes. The schema, if set, is
+		/// kept & the typed columns are re-parsed after each change.
+		///
+		///     csv.load("levels.csv");
+		///     csv.watch();
+		///     ...
+		///     if(csv.update()) { // in ofApp::update()
+		///         for(auto &change : csv.getChanges()) {
+		///             // rebuild objects for rows [change.row, change.row+change.added)
+		///         }
+		///     }
+		///
+		/// \param interval Minimum seconds between file checks, default 0.5.
+		/// \returns true if the file was loaded & is being watched
+		bool watch(float interval=0.5f);
+	
+		/// Stop watching the current file.
+		void unwatch();
+	
+		/// Is the current file being watched?
+		bool isWatching() const;
+	
+		/// Check the watched file for changes & reload them.
+		///
+		/// Only the file size & modification time are checked until the file
+		/// changes. The new text is then hashed block by block & only the rows
+		/// in changed blocks which differ are parsed & patched. Edited rows
+		/// are replaced in place, so references to them stay valid, unless
+		/// rows were inserted or removed. Local edits to rows which didn't
+		/// change in the file are kept. If rows were added to or removed from
+		/// the table since, all rows are reloaded instead.
+		///
+		/// \returns true if any rows changed, see getChanges()
+		bool update();
+	
+		/// Get the row ranges changed by the last update() call.
+		const vector<ofxCsvChange>& getChanges() const;
+	
 	/// \section Data IO
 	
 		/// Load from a vector of rows.
@@ -158,7 +380,9 @@ class ofxCsv {
 	
 		/// Get a row at a given positon.
 		///
-		/// Expands to fit the required number of rows.
+		/// Expands to fit the required number of rows. The row is assumed to
+		/// be edited & marked as modified for saveChanges() & publish(), so
+		/// use the const getData() or iterators to only read rows.
 		///
 		/// \param index Desired position.
 		/// \returns row 
@@ -200,6 +424,7 @@ class ofxCsv {
 	
 		/// Get the underlying vector.
 		vector<ofxCsvRow>& getData();
+		const vector<ofxCsvRow>& getData() const;
 	
 		// iterator wrappers for easy looping:
 		//
@@ -240,6 +465,199 @@ class ofxCsv {
 		/// \returns true if there is no row data.
 		bool empty() const;
 	
+	/// \section Parallel Processing
+	
+		/// Run a function for each row in parallel.
+		///
+		/// Rows are processed in chunks on the shared ofxCsvThreadPool. The
+		/// function may modify the given row but must not add or remove rows.
+		///
+		///     csv.parallelForEachRow([](ofxCsvRow &row, size_t index) {
+		///         row.setFloat(2, row.getFloat(0) * row.getFloat(1));
+		///     });
+		///
+		/// \param function Row function, called with each row & its index.
+		/// \param grainSize Number of rows per chunk, 0 chooses automatically.
+		void parallelForEachRow(const std::function<void(ofxCsvRow &row, size_t index)> &function,
+		                        size_t grainSize=0);
+	
+		/// Create a new table by mapping each row in parallel.
+		///
+		/// The new table has the same number of rows & uses the current field
+		/// separator & comment prefix.
+		///
+		/// \param function Row function, returns the new row for a given row
+		///                 & its index.
+		/// \param grainSize Number of rows per chunk, 0 chooses automatically.
+		/// \returns a new table with the mapped rows
+		ofxCsv parallelMapRows(const std::function<ofxCsvRow(const ofxCsvRow &row, size_t index)> &function,
+		                       size_t grainSize=0) const;
+	
+	/// \section Snapshots
+	
+		/// Publish the current rows as a new immutable snapshot.
+		///
+		/// Readers on other threads get the new snapshot from getSnapshot()
+		/// while those still holding the previous one keep reading it
+		/// unchanged. Row blocks which weren't modified since the last publish
+		/// are shared with the previous snapshot, the others are copied. Edits
+		/// via raw access must be marked with markModified().
+		///
+		/// Lazy rows in copied blocks are split first, so snapshot rows can be
+		/// read concurrently.
+		///
+		/// Publish from the thread which edits the table.
+		///
+		/// \returns the new snapshot
+		std::shared_ptr<const ofxCsvSnapshot> publish();
+	
+		/// Get the last published snapshot.
+		///
+		/// Safe to call from any thread while the table is being edited or
+		/// published & never waits for a publish to finish.
+		///
+		/// \returns the snapshot or an empty snapshot if none was published
+		std::shared_ptr<const ofxCsvSnapshot> getSnapshot() const;
+	
+	/// \section Typed Columns
+	
+		/// Infer column types from the current rows.
+		///
+		/// \param header Is the first row a header with column names?
+		/// \param sampleSize Number of rows to examine, 0 scans all rows in
+		///                   parallel. default 1000
+		/// \param threads Maximum number of partitions scanned in parallel on
+		///                the shared thread pool, 0 for automatic.
+		/// \returns inferred schema
+		ofxCsvSchema inferSchema(bool header=false, size_t sampleSize=1000,
+		                         unsigned int threads=0) const;
+	
+		/// Set the schema & parse the current rows into typed columns.
+		void setSchema(const ofxCsvSchema &schema);
+	
+		/// Get the current schema, empty if none was set.
+		const ofxCsvSchema& getSchema() const;
+	
+		/// Get the typed values for a given column.
+		///
+		/// Typed columns reflect the rows when loaded or when the schema was
+		/// set, call updateColumns() after editing rows.
+		///
+		/// \param col Column number.
+		/// \returns the column or an empty String column if it doesn't exist
+		const ofxCsvColumn& getColumn(int col) const;
+	
+		/// Find a column number by name.
+		///
+		/// Names are looked up in the header row, if set, or the schema
+		/// column names.
+		///
+		/// \param name Column name.
+		/// \param header Is the first row a header with column names?
+		/// \returns the first matching column number or -1 if not found
+		int getColumnIndex(const string &name, bool header=false) const;
+	
+		/// Re-parse the current rows into typed columns using the current schema.
+		void updateColumns();
+	
+	/// \section Analysis
+
+		/// Group rows by key columns & compute aggregates for each group.
+		///
+		/// Each value is parsed once & rows are processed in parallel for
+		/// large tables. The result table has one row per group, in order of
+		/// first appearance, with the key fields followed by the aggregate
+		/// values. Uses the current field separator & comment prefix.
+		///
+		/// \param groupCols Key column numbers, empty for a single group.
+		/// \param aggregates Operations to compute for each group.
+		/// \param header Is the first row a header? If so, it is skipped & a
+		///               header row with key & aggregate names is added to the
+		///               result. default false.
+		/// \param threads Maximum number of partitions processed in parallel
+		///                on the shared thread pool, 0 for automatic.
+		/// \returns a new table with the grouped results
+		ofxCsv aggregate(const vector<int> &groupCols,
+		                 const vector<ofxCsvAggregate> &aggregates,
+		                 bool header=false, unsigned int threads=0) const;
+
+		/// Find the rows matching a filter expression, ie. "speed > 3.5".
+		///
+		/// Named columns are resolved using the header row, if set, or the
+		/// schema column names. See ofxCsvQuery for the expression syntax.
+		///
+		/// \param expression Filter expression.
+		/// \param header Is the first row a header? If so, it never matches.
+		/// \returns matching row indices in order, empty on a compile error
+		vector<size_t> select(const string &expression, bool header=false) const;
+
+		/// Create a new table with the rows matching a filter expression.
+		///
+		/// \param expression Filter expression.
+		/// \param header Is the first row a header? If so, it is kept.
+		/// \returns a new table with the matching rows, empty on a compile error
+		ofxCsv filter(const string &expression, bool header=false) const;
+
+		/// Create a new table with the rows matching a compiled query.
+		///
+		/// Compile a query once to reuse it across tables.
+		///
+		/// \param query Compiled query.
+		/// \param header Is the first row a header? If so, it is kept.
+		/// \returns a new table with the matching rows
+		ofxCsv filter(const ofxCsvQuery &query, bool header=false) const;
+
+		/// Get the numeric values of a column, parsing each field once.
+		///
+		/// Uses the typed column if a numeric schema type is set.
+		///
+		/// \param col Column number.
+		/// \param header Is the first row a header? If so, it is skipped.
+		/// \returns one value per row, NAN if a field is empty or non-numeric
+		vector<double> getValues(int col, bool header=false) const;
+
+		/// Get the timestamps of a column in nanoseconds since the Unix epoch.
+		///
+		/// Uses the typed column if the schema type is Timestamp & the format
+		/// is ISO-8601, otherwise fields are parsed in parallel on the shared
+		/// thread pool without allocating, see ofxCsvTimestamp.
+		///
+		/// \param col Column number.
+		/// \param header Is the first row a header? If so, it is skipped.
+		/// \param format Field format, default ISO-8601.
+		/// \returns one value per row, ofxCsvTimestamp::Missing if a field is
+		///          empty or invalid
+		vector<int64_t> getTimestamps(int col, bool header=false,
+		                              ofxCsvTimestamp::Format format=ofxCsvTimestamp::Iso8601) const;
+
+		/// Compute a rolling statistic over a sliding window of a column.
+		///
+		/// Runs in O(n) for any window size, see ofxCsvRolling.
+		///
+		/// \param col Column number.
+		/// \param op Statistic type.
+		/// \param window Window size in rows.
+		/// \param header Is the first row a header? If so, it is skipped.
+		/// \param minValues Minimum number of values in the window for a result.
+		/// \returns one result per row, NAN if there are too few values
+		vector<double> rolling(int col, ofxCsvRolling::Op op, size_t window,
+		                       bool header=false, size_t minValues=1) const;
+
+		/// Append a column with a rolling statistic over a sliding window of
+		/// a column.
+		///
+		/// Rows with too few values in the window get an empty field. If there
+		/// is a header, the new column is named ie. "mean(speed,10)".
+		///
+		/// \param col Column number.
+		/// \param op Statistic type.
+		/// \param window Window size in rows.
+		/// \param header Is the first row a header?
+		/// \param minValues Minimum number of values in the window for a result.
+		/// \returns the new column number
+		int addRollingColumn(int col, ofxCsvRolling::Op op, size_t window,
+		                     bool header=false, size_t minValues=1);
+
 	/// \section Util
 	
 		/// Trim leading & trailing whitespace from all non-quoted fields.
@@ -279,6 +697,58 @@ class ofxCsv {
 		/// Get the current comment line prefix, default "#".
 		string getComment() const;
 	
+		/// Set the file compression format used by load & save.
+		///
+		/// \param compression Format, default Auto detects by file extension.
+		void setCompression(ofxCsvCompression compression);
+	
+		/// Get the file compression format, default Auto.
+		ofxCsvCompression getCompression() const;
+	
+		/// Set the text encoding used by load.
+		///
+		/// UTF-16 files are transcoded to UTF-8 while loading & a UTF-8 byte
+		/// order mark is skipped. Invalid UTF-8 is kept as is, but logged.
+		/// Files are always saved as UTF-8 without a byte order mark.
+		///
+		/// \param encoding Encoding, default Auto detects by byte order mark.
+		void setEncoding(ofxCsvEncoding encoding);
+	
+		/// Get the text encoding used by load, default Auto.
+		ofxCsvEncoding getEncoding() const;
+	
+		/// Split rows into fields lazily when loading?
+		///
+		/// Lazy loading only finds the lines & keeps the file text, each row
+		/// is split the first time one of its fields is accessed. Useful for
+		/// lookups or previews in large or wide tables. Rows aren't padded to
+		/// the widest row & splitting isn't thread safe, so avoid accessing
+		/// the same unsplit row from several threads. Loading with a schema
+		/// is never lazy.
+		///
+		/// \param lazy Split rows lazily? default false.
+		void setLazy(bool lazy);
+	
+		/// Are rows split into fields lazily when loading?
+		bool isLazy() const;
+	
+	/// \section Statistics
+	
+		/// Get the counts & phase timings of the last load or save.
+		///
+		/// Covers load(), save(), & saveChanges(), ie:
+		///
+		///     csv.load("file.csv");
+		///     ofLog() << csv.getStats().toString();
+		///
+		const ofxCsvStats& getStats() const;
+	
+		/// Set a function called with the stats after each load or save,
+		/// including failed ones. Called on the loading thread.
+		///
+		/// \param callback Stats function, pass nullptr to remove.
+		void setStatsCallback(std::function<void(const ofxCsvStats &stats)> callback);
+	
 	protected:
 	
 		/// Expand to include a required row.
@@ -289,10 +759,101 @@ class ofxCsv {
 		/// \param cols Number of desired columns in the row.
 		void expandRow(int row, int cols);
 	
+		/// Mark a range of rows as modified for the next publish().
+		void markRows(size_t begin, size_t end);
+	
+		/// Read the current file path into the row data.
+		bool loadFile();
+	
+		/// Reset the stats & start timing a load or save.
+		void beginStats(ofxCsvStats::Operation operation);
+	
+		/// Finish timing & call the stats callback, if set.
+		///
+		/// \param success Did the load or save succeed?
+		/// \returns success
+		bool endStats(bool success);
+	
+		/// Reserve row & typed column storage for a file buffer.
+		///
+		/// Counts lines & estimates the number of fields per row.
+		///
+		/// \param text File text.
+		/// \param size Text size in bytes.
+		/// \param numFields Set to the estimated number of fields per row.
+		void reserve(const char *text, size_t size, size_t &numFields);
+	
+		/// Get the compression format for the current file path.
+		ofxCsvCompression getFileCompression() const;
+	
+		/// Store the file state after loading or saving.
+		void setSaved(const string &absolutePath, size_t rows, bool newline,
+		              ofxCsvEncoding encoding=ofxCsvEncoding::Utf8, bool quote=false);
+	
+		/// Reload the watched file, patching the changed rows.
+		///
+		/// \param all Replace all rows instead of comparing hashes?
+		/// \returns false if the file couldn't be read
+		bool reload(bool all);
+	
+		/// Read the current file's text, decompressing & decoding if needed.
+		bool readFileText(const string &absolutePath, string &text, ofxCsvReader &reader) const;
+	
+		/// Apply row changes from an index of the current file text.
+		void applyChanges(const ofxCsvFileIndex &index, const vector<ofxCsvChange> &changes);
+	
+		/// Parse the fields of a given row into the typed columns.
+		void parseColumns(const vector<string> &fields, size_t row);
+	
+		/// Get column names from the header row or the schema, if set.
+		vector<string> getColumnNames(bool header) const;
+	
 		/// row data
 		vector<ofxCsvRow> data;
 	
+		ofxCsvSchema schema;          //< column types
+		vector<ofxCsvColumn> columns; //< typed column data, if schema is set
+	
 		string filePath;       //< Current file path
 		string fieldSeparator; //< Field separator, default: comma ","
 		string commentPrefix;  //< Comment line prefix, default: "#"
+		ofxCsvCompression compression; //< File compression, default: Auto
+		ofxCsvEncoding encoding;       //< Text encoding, default: Auto
+		bool lazy;             //< Split rows on first access? default: false
+	
+		ofxCsvStats stats; //< stats of the last load or save
+		std::function<void(const ofxCsvStats &stats)> statsCallback; //< optional stats function
+		std::chrono::steady_clock::time_point statsStarted; //< stats timing start
+	
+		/// file state as of the last load or save, used by saveChanges()
+		struct SavedState {
+			string path;                   //< absolute file path
+			string separator;              //< field separator
+			ofxCsvCompression compression = ofxCsvCompression::None;
+			ofxCsvEncoding encoding = ofxCsvEncoding::Utf8; //< text encoding
+			bool quote = false;            //< were the fields double quoted?
+			size_t rows = 0;               //< number of rows in the file
+			uint64_t size = 0;             //< file size in bytes
+			bool newline = true;           //< does the file end with a newline?
+			bool modified = true;          //< were any of the rows changed?
+		} saved;
+	
+		/// published snapshot state, used by publish()
+		struct SnapshotState {
+			std::shared_ptr<const ofxCsvSnapshot> current; //< last published, accessed atomically
+			vector<uint8_t> modified;      //< modified flags per row block since
+			bool all = true;               //< were all rows modified since?
+		} snapshots;
+	
+		/// watched file state, used by update()
+		struct WatchState {
+			bool enabled = false;          //< is the file being watched?
+			float interval = 0.5f;         //< minimum seconds between checks
+			std::chrono::steady_clock::time_point checked; //< last check time
+			int64_t mtime = 0;             //< file modification time
+			uint64_t size = 0;             //< file size in bytes
+			bool racy = false;             //< modified within the mtime resolution?
+			ofxCsvFileIndex index;         //< content hashes of the loaded text
+			vector<ofxCsvChange> changes;  //< changes of the last update
+		} watched;
 };
@@ -0,0 +1,370 @@
+/**
+ *  ofxCsvAggregate.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvAggregate.h"
+#include "ofxCsvThreadPool.h"
+
+#include <cfloat>
+#include <cmath>
+
+/// minimum number of rows in each partition
+static const size_t s_minRowsPerThread = 16384;
+
+/// marks an unused group table slot
+static const uint32_t s_emptySlot = 0xffffffff;
+
+namespace {
+
+//--------------------------------------------------
+// running values for a single aggregate within a single group
+struct Accumulator {
+	double sum = 0;
+	double min = DBL_MAX;
+	double max = -DBL_MAX;
+	uint64_t count = 0;
+
+	void add(double v) {
+		sum += v;
+		if(v < min) {min = v;}
+		if(v > max) {max = v;}
+		count++;
+	}
+
+	void merge(const Accumulator &other) {
+		sum += other.sum;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+		count += other.count;
+	}
+};
+
+// parse a field as a double, returns NAN if empty or not a number
+static double parseValue(const string &field) {
+	const char *begin = field.c_str();
+	char *end = nullptr;
+	double v = strtod(begin, &end);
+	if(end == begin) {
+		return NAN;
+	}
+	while(*end == ' ' || *end == '\t' || *end == '\r') {
+		end++;
+	}
+	return (*end == '\0' ? v : NAN);
+}
+
+// FNV-1a over the key fields, fields are terminated by a 0 byte so
+// "a","bc" & "ab","c" hash differently
+static uint64_t hashKey(const ofxCsvRow &row, const vector<int> &groupCols) {
+	static const string s_empty;
+	uint64_t h = 14695981039346656037ULL;
+	for(int col : groupCols) {
+		const string &field = (col >= 0 && (size_t)col < row.size() ? row.getData()[col] : s_empty);
+		for(unsigned char c : field) {
+			h = (h ^ c) * 1099511628211ULL;
+		}
+		h = (h ^ 0xff) * 1099511628211ULL;
+	}
+	// final avalanche, the low bits select the slot
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/// group table using open addressing with linear probing
+///
+/// Slots only store the hash & group index, key fields & accumulators live in
+/// flat arrays indexed by group so growing the table never moves them.
+class GroupTable {
+
+	public:
+
+		GroupTable(size_t numKeys, size_t numAggregates) :
+			numKeys(numKeys), numAggregates(numAggregates) {
+			resize(64);
+		}
+
+		size_t size() const {
+			return hashes.size();
+		}
+
+		/// find a group for the given key fields or add a new one
+		/// \returns group index
+		size_t find(uint64_t hash, const string *fields) {
+			size_t mask = slots.size()-1;
+			size_t i = hash & mask;
+			while(true) {
+				uint32_t g = slots[i];
+				if(g == s_emptySlot) {
+					break;
+				}
+				if(hashes[g] == hash && equals(g, fields)) {
+					return g;
+				}
+				i = (i+1) & mask;
+			}
+			// add new group
+			size_t g = hashes.size();
+			hashes.push_back(hash);
+			keys.insert(keys.end(), fields, fields+numKeys);
+			accumulators.resize(accumulators.size()+numAggregates);
+			slots[i] = g;
+			if(hashes.size()*2 > slots.size()) { // keep load factor <= 0.5
+				resize(slots.size()*2);
+			}
+			return g;
+		}
+
+		/// add the groups & accumulators from another table
+		void merge(const GroupTable &other) {
+			for(size_t g = 0; g < other.size(); g++) {
+				size_t dest = find(other.hashes[g], other.keys.data() + g*numKeys);
+				for(size_t a = 0; a < numAggregates; a++) {
+					accumulators[dest*numAggregates+a].merge(other.accumulators[g*numAggregates+a]);
+				}
+			}
+		}
+
+		Accumulator* getAccumulators(size_t group) {
+			return accumulators.data() + group*numAggregates;
+		}
+
+		const Accumulator* getAccumulators(size_t group) const {
+			return accumulators.data() + group*numAggregates;
+		}
+
+		const string* getKeys(size_t group) const {
+			return keys.data() + group*numKeys;
+		}
+
+	protected:
+
+		bool equals(size_t group, const string *fields) const {
+			const string *k = keys.data() + group*numKeys;
+			for(size_t i = 0; i < numKeys; i++) {
+				if(k[i] != fields[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void resize(size_t capacity) {
+			slots.assign(capacity, s_emptySlot);
+			size_t mask = capacity-1;
+			for(size_t g = 0; g < hashes.size(); g++) {
+				size_t i = hashes[g] & mask;
+				while(slots[i] != s_emptySlot) {
+					i = (i+1) & mask;
+				}
+				slots[i] = g;
+			}
+		}
+
+		size_t numKeys;
+		size_t numAggregates;
+		vector<uint32_t> slots;           //< group index per slot
+		vector<uint64_t> hashes;          //< key hash per group
+		vector<string> keys;              //< key fields per group
+		vector<Accumulator> accumulators; //< accumulators per group
+};
+
+} // namespace
+
+// aggregate a range of rows into a table
+static void aggregateRange(const vector<ofxCsvRow> &rows, size_t begin, size_t end,
+                           const vector<int> &groupCols,
+                           const vector<ofxCsvAggregate> &aggregates,
+                           const vector<int> &valueCols, const vector<int> &valueIndex,
+                           GroupTable &table) {
+	static const string s_empty;
+	vector<string> fields(groupCols.size());
+	vector<double> values(valueCols.size());
+	for(size_t r = begin; r < end; r++) {
+		const ofxCsvRow &row = rows[r];
+		const vector<string> &cols = row.getData();
+
+		// key fields
+		for(size_t k = 0; k < groupCols.size(); k++) {
+			int col = groupCols[k];
+			fields[k] = (col >= 0 && (size_t)col < cols.size() ? cols[col] : s_empty);
+		}
+		Accumulator *acc = table.getAccumulators(table.find(hashKey(row, groupCols), fields.data()));
+
+		// parse each referenced column once per row
+		for(size_t v = 0; v < valueCols.size(); v++) {
+			int col = valueCols[v];
+			values[v] = ((size_t)col < cols.size() ? parseValue(cols[col]) : NAN);
+		}
+		for(size_t a = 0; a < aggregates.size(); a++) {
+			if(valueIndex[a] < 0) { // row count
+				acc[a].count++;
+			}
+			else {
+				double v = values[valueIndex[a]];
+				if(!std::isnan(v)) {
+					acc[a].add(v);
+				}
+			}
+		}
+	}
+}
+
+// format a result value, up to 15 significant digits
+static string formatValue(double v) {
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.15g", v);
+	return buffer;
+}
+
+//--------------------------------------------------
+ofxCsvAggregate::ofxCsvAggregate(Op op, int col) : op(op), col(col) {}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::count() {
+	return ofxCsvAggregate(Count, -1);
+}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::count(int col) {
+	return ofxCsvAggregate(Count, col);
+}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::sum(int col) {
+	return ofxCsvAggregate(Sum, col);
+}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::mean(int col) {
+	return ofxCsvAggregate(Mean, col);
+}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::min(int col) {
+	return ofxCsvAggregate(Min, col);
+}
+
+//--------------------------------------------------
+ofxCsvAggregate ofxCsvAggregate::max(int col) {
+	return ofxCsvAggregate(Max, col);
+}
+
+//--------------------------------------------------
+string ofxCsvAggregate::getName(const string &colName) const {
+	string name;
+	switch(op) {
+		case Count: name = "count"; break;
+		case Sum:   name = "sum"; break;
+		case Mean:  name = "mean"; break;
+		case Min:   name = "min"; break;
+		case Max:   name = "max"; break;
+	}
+	if(col < 0) {
+		return name + "()";
+	}
+	return name + "(" + (colName.empty() ? std::to_string(col) : colName) + ")";
+}
+
+//--------------------------------------------------
+vector<ofxCsvRow> ofxCsvAggregate::apply(const vector<ofxCsvRow> &rows, size_t first,
+                                         const vector<int> &groupCols,
+                                         const vector<ofxCsvAggregate> &aggregates,
+                                         unsigned int threads) {
+
+	// map each aggregate to a distinct value column so shared columns are
+	// only parsed once
+	vector<int> valueCols;
+	vector<int> valueIndex;
+	for(auto &aggregate : aggregates) {
+		if(aggregate.col < 0) {
+			valueIndex.push_back(-1);
+			continue;
+		}
+		auto found = std::find(valueCols.begin(), valueCols.end(), aggregate.col);
+		valueIndex.push_back(found - valueCols.begin());
+		if(found == valueCols.end()) {
+			valueCols.push_back(aggregate.col);
+		}
+	}
+
+	// partition rows, each partition is aggregated separately on the shared
+	// thread pool & merged afterwards
+	first = std::min(first, rows.size());
+	size_t numRows = rows.size() - first;
+	if(threads == 0) {
+		threads = ofxCsvThreadPool::shared().getNumThreads();
+	}
+	size_t partitions = std::max<size_t>(std::min<size_t>(threads, numRows / s_minRowsPerThread), 1);
+	size_t partitionSize = (numRows + partitions - 1) / partitions;
+	vector<GroupTable> tables(partitions, GroupTable(groupCols.size(), aggregates.size()));
+	ofxCsvThreadPool::shared().parallelFor(0, partitions, 1, [&](size_t begin, size_t end) {
+		for(size_t p = begin; p < end; p++) {
+			size_t b = first + p * partitionSize;
+			size_t e = std::min(b + partitionSize, rows.size());
+			aggregateRange(rows, b, e, groupCols, aggregates, valueCols, valueIndex, tables[p]);
+		}
+	});
+	// merge in partition order to keep groups in order of appearance
+	for(size_t p = 1; p < partitions; p++) {
+		tables[0].merge(tables[p]);
+	}
+
+	// build result rows
+	const GroupTable &table = tables[0];
+	vector<ofxCsvRow> result;
+	result.reserve(table.size());
+	for(size_t g = 0; g < table.size(); g++) {
+		vector<string> fields(table.getKeys(g), table.getKeys(g)+groupCols.size());
+		const Accumulator *acc = table.getAccumulators(g);
+		for(size_t a = 0; a < aggregates.size(); a++) {
+			const Accumulator &values = acc[a];
+			switch(aggregates[a].op) {
+				case Count:
+					fields.push_back(std::to_string(values.count));
+					break;
+				case Sum:
+					fields.push_back(formatValue(values.sum));
+					break;
+				case Mean:
+					fields.push_back(values.count > 0 ? formatValue(values.sum / values.count) : "");
+					break;
+				case Min:
+					fields.push_back(values.count > 0 ? formatValue(values.min) : "");
+					break;
+				case Max:
+					fields.push_back(values.count > 0 ? formatValue(values.max) : "");
+					break;
+			}
+		}
+		result.push_back(ofxCsvRow(fields));
+	}
+	return result;
+}
@@ -0,0 +1,112 @@
+/**
+ *  ofxCsvAggregate.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+/// \class ofxCsvAggregate
+/// \brief an aggregate operation over a numeric table column
+///
+/// Used with ofxCsv::aggregate() to summarize rows grouped by key columns:
+///
+///     // per zone: number of rows, mean speed, max speed
+///     ofxCsv summary = csv.aggregate({2}, {
+///         ofxCsvAggregate::count(),
+///         ofxCsvAggregate::mean(0),
+///         ofxCsvAggregate::max(0)
+///     });
+///
+/// Field values are parsed once as floating point numbers. Empty or
+/// non-numeric fields are treated as missing & skipped by all operations
+/// except a row count.
+///
+class ofxCsvAggregate {
+
+	public:
+
+		/// Aggregate operation type
+		enum Op {
+			Count, //< number of rows or number of numeric values in a column
+			Sum,   //< sum of the column values
+			Mean,  //< arithmetic mean of the column values
+			Min,   //< smallest column value
+			Max    //< largest column value
+		};
+
+		/// Constructor.
+		///
+		/// \param op Operation type.
+		/// \param col Column number, -1 counts rows when used with Count.
+		ofxCsvAggregate(Op op, int col=-1);
+
+		/// Count the number of rows in each group.
+		static ofxCsvAggregate count();
+
+		/// Count the number of numeric values of a column in each group.
+		static ofxCsvAggregate count(int col);
+
+		/// Sum the values of a column in each group.
+		static ofxCsvAggregate sum(int col);
+
+		/// Average the values of a column in each group.
+		static ofxCsvAggregate mean(int col);
+
+		/// Find the smallest value of a column in each group.
+		static ofxCsvAggregate min(int col);
+
+		/// Find the largest value of a column in each group.
+		static ofxCsvAggregate max(int col);
+
+		/// Get a descriptive name, ie. "sum(3)" or "sum(speed)".
+		///
+		/// \param colName Optional column name, uses the column number if empty.
+		string getName(const string &colName="") const;
+
+		/// Group rows by key columns & compute aggregates for each group.
+		///
+		/// Groups are returned in order of their first appearance. Each result
+		/// row contains the key fields followed by one field per aggregate.
+		///
+		/// \param rows Rows to summarize.
+		/// \param first Index of the first row to include, ie. 1 to skip a header.
+		/// \param groupCols Key column numbers, empty for a single group.
+		/// \param aggregates Operations to compute for each group.
+		/// \param threads Maximum number of partitions processed in parallel
+		///                on the shared thread pool, 0 for automatic.
+		/// \returns result rows
+		static vector<ofxCsvRow> apply(const vector<ofxCsvRow> &rows, size_t first,
+		                               const vector<int> &groupCols,
+		                               const vector<ofxCsvAggregate> &aggregates,
+		                               unsigned int threads=0);
+
+		Op op;   //< operation type
+		int col; //< column number
+};
@@ -0,0 +1,371 @@
+/**
+ *  ofxCsvAppender.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvAppender.h"
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+
+#include <chrono>
+
+// 1 ms naps of the writer thread before it waits to be woken
+static const int s_maxNaps = 10;
+
+//--------------------------------------------------
+ofxCsvAppender::ofxCsvAppender() {
+	mask = 0;
+	head = 0;
+	tail = 0;
+	numWritten = 0;
+	dropped = 0;
+	flushedPosition = 0;
+	flushRequest = 0;
+	stopping = false;
+	sleeping = false;
+	running = false;
+	error = false;
+	queueSize = 65536;
+	overflow = Block;
+	flushInterval = 1;
+	separator = ",";
+	quote = false;
+}
+
+//--------------------------------------------------
+ofxCsvAppender::~ofxCsvAppender() {
+	close();
+}
+
+// SETUP
+
+//--------------------------------------------------
+void ofxCsvAppender::setQueueSize(size_t rows) {
+	queueSize = rows;
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::setOverflow(Overflow overflow) {
+	this->overflow = overflow;
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::setFlushInterval(float seconds) {
+	flushInterval = seconds;
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::setSeparator(const string &separator) {
+	this->separator = separator;
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::setQuote(bool quote) {
+	this->quote = quote;
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::open(const string &path, bool append, ofxCsvCompression compression) {
+	close();
+	string absolutePath = ofxCsvFileUtils::toDataPath(path);
+	if(!ofxCsvFileUtils::createFile(absolutePath) || !writer.open(absolutePath, compression, append)) {
+		OFX_CSV_LOG_ERROR << "Cannot append to " << path << ": couldn't open file";
+		return false;
+	}
+
+	// positions wrap around the ring by masking
+	size_t size = 2;
+	while(size < queueSize) {
+		size <<= 1;
+	}
+	slots.reset(new Slot[size]);
+	for(size_t i = 0; i < size; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	mask = size - 1;
+	head = 0;
+	tail = 0;
+	numWritten = 0;
+	dropped = 0;
+	flushedPosition = 0;
+	flushRequest = 0;
+	stopping = false;
+	sleeping = false;
+	error = false;
+	running = true;
+	thread = std::thread(&ofxCsvAppender::run, this);
+	OFX_CSV_LOG_VERBOSE << "Appending to " << path << " with a queue of " << size << " rows";
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::close() {
+	if(!running) {
+		return !error;
+	}
+	running = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		sleeping = false;
+	}
+	wake.notify_one();
+	thread.join();
+	if(!writer.close()) {
+		error = true;
+	}
+	slots.reset();
+	if(dropped > 0) {
+		OFX_CSV_LOG_WARNING << "Dropped " << dropped << " rows while appending, the queue was full";
+	}
+	return !error;
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::isOpen() const {
+	return running;
+}
+
+// ADDING ROWS
+
+//--------------------------------------------------
+bool ofxCsvAppender::addRow(const vector<string> &fields) {
+	return addFields(fields.data(), fields.size());
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::addRow(const ofxCsvRow &row) {
+	return addRow(row.getData());
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::addRow(std::initializer_list<string> fields) {
+	return addFields(fields.begin(), fields.size());
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::addLine(const string &line) {
+	return push([&](string &slotLine) {
+		slotLine += line;
+	});
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::flush() {
+	if(!running) {
+		return !error;
+	}
+	size_t position = head.load();
+	std::unique_lock<std::mutex> lock(mutex);
+	flushRequest = std::max(flushRequest, position);
+	sleeping = false;
+	wake.notify_one();
+	flushed.wait(lock, [&] {
+		return flushedPosition >= position || stopping;
+	});
+	return !error;
+}
+
+// STATUS
+
+//--------------------------------------------------
+uint64_t ofxCsvAppender::getNumWritten() const {
+	return numWritten;
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvAppender::getNumDropped() const {
+	return dropped;
+}
+
+//--------------------------------------------------
+size_t ofxCsvAppender::getNumPending() const {
+	if(!running) {
+		return 0;
+	}
+	return head.load() - numWritten.load();
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::hasError() const {
+	return error;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+template<typename Format>
+bool ofxCsvAppender::push(const Format &format) {
+	if(!running) {
+		return false;
+	}
+
+	// each slot's sequence is its position when free & position + 1 when
+	// filled, so producers claim the next free slot with a single CAS
+	size_t position = head.load(std::memory_order_relaxed);
+	Slot *slot;
+	for(;;) {
+		slot = &slots[position & mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		if(sequence == position) {
+			if(head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if((ptrdiff_t)(sequence - position) < 0) { // full
+			if(overflow == Drop) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			notify();
+			std::this_thread::yield();
+			position = head.load(std::memory_order_relaxed);
+		}
+		else { // claimed by another producer
+			position = head.load(std::memory_order_relaxed);
+		}
+	}
+	slot->line.clear();
+	format(slot->line);
+	slot->line += '\n';
+	slot->sequence.store(position + 1, std::memory_order_release);
+
+	// pairs with the fence in run() so either the writer sees the line or
+	// the producer sees it sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(sleeping.load(std::memory_order_relaxed)) {
+		notify();
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvAppender::addFields(const string *fields, size_t numFields) {
+	return push([&](string &line) {
+		for(size_t i = 0; i < numFields; i++) {
+			if(i > 0) {
+				line += separator;
+			}
+			if(quote) {
+				line += '"';
+				line += fields[i];
+				line += '"';
+			}
+			else {
+				line += fields[i];
+			}
+		}
+	});
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::run() {
+	auto interval = std::chrono::duration<float>(std::max(flushInterval, 0.001f));
+	auto lastFlush = std::chrono::steady_clock::now();
+	int naps = 0;
+	for(;;) {
+		size_t count = drain();
+
+		// flush when requested or when lines have been buffered too long
+		std::unique_lock<std::mutex> lock(mutex);
+		auto now = std::chrono::steady_clock::now();
+		if(flushRequest > flushedPosition ||
+		   (tail > flushedPosition && now - lastFlush >= interval)) {
+			lock.unlock();
+			if(!writer.flush()) {
+				error = true;
+			}
+			lock.lock();
+			flushedPosition = tail;
+			lastFlush = now;
+			flushed.notify_all();
+		}
+		if(count > 0) {
+			naps = 0;
+			continue;
+		}
+		if(stopping) {
+			if(drain() == 0) {
+				flushed.notify_all();
+				return;
+			}
+			continue;
+		}
+
+		// while rows keep coming, nap without asking producers to wake us
+		if(naps < s_maxNaps && flushRequest <= flushedPosition) {
+			naps++;
+			lock.unlock();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		// sleep until woken by a producer, a flush, or the flush interval
+		naps = 0;
+		sleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(slots[tail & mask].sequence.load(std::memory_order_acquire) == tail + 1) {
+			sleeping = false;
+			continue;
+		}
+		wake.wait_for(lock, interval, [&] {
+			return !sleeping || stopping;
+		});
+		sleeping = false;
+	}
+}
+
+//--------------------------------------------------
+size_t ofxCsvAppender::drain() {
+	size_t count = 0;
+	for(;;) {
+		Slot &slot = slots[tail & mask];
+		if(slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+			break;
+		}
+		if(!writer.write(slot.line)) {
+			error = true;
+		}
+		// free the slot for the position one lap ahead
+		slot.sequence.store(tail + mask + 1, std::memory_order_release);
+		tail++;
+		count++;
+	}
+	if(count > 0) {
+		numWritten.fetch_add(count, std::memory_order_release);
+	}
+	return count;
+}
+
+//--------------------------------------------------
+void ofxCsvAppender::notify() {
+	if(sleeping.exchange(false)) {
+		std::lock_guard<std::mutex> lock(mutex);
+		wake.notify_one();
+	}
+}
@@ -0,0 +1,209 @@
+/**
+ *  ofxCsvAppender.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+#include "ofxCsvWriter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+
+/// \class ofxCsvAppender
+/// \brief appends rows from multiple threads to a single file in the background
+///
+/// Producer threads format each row straight into a slot of a bounded
+/// lock-free queue, which takes one atomic operation & reuses the slot's
+/// memory, so adding a row doesn't lock or allocate once the slots have
+/// grown to the row size. A single background thread drains the queue in
+/// batches through a buffered ofxCsvWriter & flushes the file when idle:
+///
+///     ofxCsvAppender events;
+///     events.open("events.csv");
+///
+///     // any thread
+///     events.addRow({ofToString(ofGetElapsedTimef()), "click", ofToString(x)});
+///
+/// When the queue is full, producers either wait for the writer thread to
+/// catch up or drop the row, see setOverflow().
+///
+class ofxCsvAppender {
+
+	public:
+
+		/// Queue overflow policy
+		enum Overflow {
+			Block, //< wait for a free slot
+			Drop   //< drop the row & count it, see getNumDropped()
+		};
+
+		/// Constructor.
+		ofxCsvAppender();
+
+		/// Destructor, writes pending rows & closes the file.
+		virtual ~ofxCsvAppender();
+
+	/// \section Setup
+
+		/// Set the queue size, used when opening. default 65536 rows
+		///
+		/// \param rows Maximum number of pending rows, rounded up to a power
+		///             of 2.
+		void setQueueSize(size_t rows);
+
+		/// Set what happens to new rows when the queue is full. default Block
+		void setOverflow(Overflow overflow);
+
+		/// Set the longest time rows stay buffered before they are flushed to
+		/// the file. default 1 second
+		void setFlushInterval(float seconds);
+
+		/// Set the field separator. default comma ","
+		void setSeparator(const string &separator);
+
+		/// Should fields be double quoted? default false
+		void setQuote(bool quote);
+
+		/// Open a file & start the writer thread.
+		///
+		/// Closes any currently open file. Creates the file & any required
+		/// folders, if needed.
+		///
+		/// \param path File path, relative to the data folder.
+		/// \param append Append to an existing file instead of truncating it?
+		///               default true
+		/// \param compression File compression, default detects by extension.
+		/// \returns true if the file was opened
+		bool open(const string &path, bool append=true,
+		          ofxCsvCompression compression=ofxCsvCompression::Auto);
+
+		/// Write all pending rows, stop the writer thread, & close the file.
+		///
+		/// Call from the thread which opened the file once no other threads
+		/// are adding rows.
+		///
+		/// \returns false if any write error occured
+		bool close();
+
+		/// Is a file currently open?
+		bool isOpen() const;
+
+	/// \section Adding Rows
+
+		/// Add a row, safe to call from any thread.
+		///
+		/// \param fields Row fields.
+		/// \returns false if the row was dropped or no file is open
+		bool addRow(const vector<string> &fields);
+
+		/// Add a row, safe to call from any thread.
+		bool addRow(const ofxCsvRow &row);
+
+		/// Add a row from braced fields, ie. addRow({time, "click"}), safe to
+		/// call from any thread.
+		bool addRow(std::initializer_list<string> fields);
+
+		/// Add a pre-formatted line, safe to call from any thread.
+		///
+		/// \param line Row text without a trailing newline.
+		/// \returns false if the line was dropped or no file is open
+		bool addLine(const string &line);
+
+		/// Wait until all rows added so far are written to the file.
+		///
+		/// \returns false if any write error occured
+		bool flush();
+
+	/// \section Status
+
+		/// Get the number of rows written to the file.
+		uint64_t getNumWritten() const;
+
+		/// Get the number of rows dropped because the queue was full.
+		uint64_t getNumDropped() const;
+
+		/// Get the number of rows waiting in the queue.
+		size_t getNumPending() const;
+
+		/// Did a write error occur?
+		bool hasError() const;
+
+	protected:
+
+		/// queue slot, holding one formatted line
+		struct Slot {
+			std::atomic<size_t> sequence; //< slot state, see push()
+			string line;                  //< formatted line incl. newline
+		};
+
+		/// claim a slot, format a line into it, & publish it
+		template<typename Format>
+		bool push(const Format &format);
+
+		/// add a row from an array of fields
+		bool addFields(const string *fields, size_t numFields);
+
+		/// write queued lines until stopped
+		void run();
+
+		/// write all currently published lines, returns the number written
+		size_t drain();
+
+		/// wake the writer thread if it's waiting
+		void notify();
+
+		std::unique_ptr<Slot[]> slots;    //< ring buffer
+		size_t mask;                      //< number of slots - 1
+		std::atomic<size_t> head;         //< next position claimed by producers
+		size_t tail;                      //< next position read by the writer
+		std::atomic<uint64_t> numWritten; //< number of lines written
+		std::atomic<uint64_t> dropped;    //< number of dropped rows
+
+		ofxCsvWriter writer;              //< buffered file writer
+		std::thread thread;               //< writer thread
+		std::mutex mutex;                 //< guards the flush & stop state
+		std::condition_variable wake;     //< wakes the writer thread
+		std::condition_variable flushed;  //< signals flushes to waiting threads
+		size_t flushedPosition;           //< position up to which lines are flushed
+		size_t flushRequest;              //< position to flush up to, for flush()
+		bool stopping;                    //< is the writer thread stopping?
+		std::atomic<bool> sleeping;       //< is the writer thread waiting?
+		std::atomic<bool> running;        //< is a file open?
+		std::atomic<bool> error;          //< did a write error occur?
+
+		size_t queueSize;              //< queue size used when opening
+		Overflow overflow;             //< queue overflow policy
+		float flushInterval;           //< max seconds between file flushes
+		string separator;              //< field separator
+		bool quote;                    //< double quote fields?
+};
@@ -0,0 +1,1101 @@
+/**
+ *  ofxCsvArrow.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvArrow.h"
+#include "ofxCsvTimestamp.h"
+#include "ofxCsvWriter.h"
+
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	#define OFX_CSV_BIG_ENDIAN
+#endif
+
+// Arrow format constants, see https://arrow.apache.org/docs/format/Columnar.html
+// & the Schema.fbs, Message.fbs, & File.fbs flatbuffer definitions
+namespace {
+
+	const char s_magic[] = "ARROW1";
+	const int16_t s_metadataV5 = 4;
+
+	// Message.header union
+	enum MessageHeader {HeaderSchema = 1, HeaderDictionaryBatch = 2, HeaderRecordBatch = 3};
+
+	// Field.type union
+	enum ArrowType {
+		TypeNull = 1, TypeInt = 2, TypeFloatingPoint = 3, TypeBinary = 4, TypeUtf8 = 5,
+		TypeBool = 6, TypeDate = 8, TypeTimestamp = 10, TypeLargeBinary = 19, TypeLargeUtf8 = 20
+	};
+
+	// table field ids
+	enum {MessageVersion = 0, MessageHeaderType = 1, MessageHeaderTable = 2, MessageBodyLength = 3};
+	enum {SchemaEndianness = 0, SchemaFields = 1};
+	enum {FieldName = 0, FieldNullable = 1, FieldTypeType = 2, FieldType = 3, FieldDictionary = 4, FieldChildren = 5};
+	enum {BatchLength = 0, BatchNodes = 1, BatchBuffers = 2, BatchCompression = 3};
+	enum {FooterVersion = 0, FooterSchema = 1, FooterDictionaries = 2, FooterRecordBatches = 3};
+
+	// FieldNode & Buffer structs
+	struct FieldNode {int64_t length; int64_t nullCount;};
+	struct BufferRef {int64_t offset; int64_t length;};
+
+	// File footer Block struct
+	struct Block {int64_t offset; int32_t metaDataLength; int32_t pad; int64_t bodyLength;};
+
+	// round up to a multiple of 8 bytes
+	inline size_t pad8(size_t size) {
+		return (size + 7) & ~size_t(7);
+	}
+
+	/// Minimal flatbuffer builder.
+	///
+	/// Objects are described first & laid out front to back by finish(), so
+	/// a parent always comes before its children & all offsets are positive.
+	class FlatBuilder {
+
+		public:
+
+			// add an empty table
+			int table() {
+				objects.push_back(Object(Object::Table));
+				return objects.size()-1;
+			}
+
+			// add a scalar field of 1, 2, 4, or 8 bytes to a table
+			template<typename T>
+			void scalar(int table, int id, T value) {
+				Field field;
+				field.id = id;
+				field.size = sizeof(T);
+				memcpy(field.value, &value, sizeof(T));
+				objects[table].fields.push_back(field);
+			}
+
+			// add a table, vector, or string reference field to a table
+			void offset(int table, int id, int child) {
+				Field field;
+				field.id = id;
+				field.size = 4;
+				field.child = child;
+				objects[table].fields.push_back(field);
+			}
+
+			// add a string
+			int addString(const string &text) {
+				objects.push_back(Object(Object::String));
+				objects.back().bytes.assign(text.begin(), text.end());
+				return objects.size()-1;
+			}
+
+			// add a vector of tables
+			int tables(const vector<int> &children) {
+				objects.push_back(Object(Object::Tables));
+				objects.back().children = children;
+				return objects.size()-1;
+			}
+
+			// add a vector of structs
+			template<typename T>
+			int structs(const vector<T> &values) {
+				objects.push_back(Object(Object::Structs));
+				Object &o = objects.back();
+				o.bytes.resize(values.size() * sizeof(T));
+				if(!values.empty()) {
+					memcpy(o.bytes.data(), values.data(), o.bytes.size());
+				}
+				o.count = values.size();
+				o.align = 8;
+				return objects.size()-1;
+			}
+
+			// lay out all objects from a root table, padded to 8 bytes
+			vector<uint8_t> finish(int root) {
+				buffer.assign(4, 0);
+				patch(0, write(root));
+				buffer.resize(pad8(buffer.size()), 0);
+				return std::move(buffer);
+			}
+
+		protected:
+
+			struct Field {
+				int id = 0;
+				int size = 0;
+				uint8_t value[8] = {0};
+				int child = -1; //< referenced object or -1 for a scalar
+			};
+
+			struct Object {
+				enum Type {Table, String, Tables, Structs} type;
+				vector<Field> fields;   //< table fields
+				vector<int> children;   //< vector of tables elements
+				vector<uint8_t> bytes;  //< string or struct data
+				size_t count = 0;       //< number of structs
+				size_t align = 4;       //< struct alignment
+				Object(Type type) : type(type) {}
+			};
+
+			// append zeros until the size plus an offset is aligned
+			void pad(size_t align, size_t offset=0) {
+				while((buffer.size() + offset) % align != 0) {
+					buffer.push_back(0);
+				}
+			}
+
+			// append bytes
+			void put(const void *data, size_t size) {
+				const uint8_t *p = static_cast<const uint8_t *>(data);
+				buffer.insert(buffer.end(), p, p + size);
+			}
+
+			// set a forward offset at a position
+			void patch(size_t at, size_t target) {
+				uint32_t offset = static_cast<uint32_t>(target - at);
+				memcpy(&buffer[at], &offset, 4);
+			}
+
+			// write an object, returns its position
+			size_t write(int index) {
+				const Object &o = objects[index];
+				size_t pos = 0;
+				switch(o.type) {
+					case Object::Table: {
+						// fields from largest to smallest after the vtable offset,
+						// the table start is 8 byte aligned so relative alignment is
+						// also absolute
+						vector<Field> fields = o.fields;
+						std::stable_sort(fields.begin(), fields.end(), [](const Field &a, const Field &b) {
+							return a.size > b.size;
+						});
+						int maxId = -1;
+						for(auto &f : fields) {
+							maxId = std::max(maxId, f.id);
+						}
+						vector<uint16_t> vtable(2 + maxId + 1, 0);
+						size_t size = 4;
+						vector<size_t> slots;
+						for(auto &f : fields) {
+							size = (size + f.size - 1) / f.size * f.size;
+							vtable[2 + f.id] = size;
+							slots.push_back(size);
+							size += f.size;
+						}
+						vtable[0] = vtable.size() * 2;
+						vtable[1] = size;
+						pad(2);
+						size_t vt = buffer.size();
+						put(vtable.data(), vtable.size() * 2);
+						pad(8);
+						pos = buffer.size();
+						int32_t soffset = static_cast<int32_t>(pos - vt);
+						buffer.resize(pos + size, 0);
+						memcpy(&buffer[pos], &soffset, 4);
+						for(size_t i = 0; i < fields.size(); i++) {
+							if(fields[i].child < 0) {
+								memcpy(&buffer[pos + slots[i]], fields[i].value, fields[i].size);
+							}
+						}
+						for(size_t i = 0; i < fields.size(); i++) {
+							if(fields[i].child >= 0) {
+								patch(pos + slots[i], write(fields[i].child));
+							}
+						}
+						break;
+					}
+					case Object::String: {
+						pad(4);
+						pos = buffer.size();
+						uint32_t len = o.bytes.size();
+						put(&len, 4);
+						put(o.bytes.data(), o.bytes.size());
+						buffer.push_back(0);
+						break;
+					}
+					case Object::Tables: {
+						pad(4);
+						pos = buffer.size();
+						uint32_t len = o.children.size();
+						put(&len, 4);
+						buffer.resize(buffer.size() + len * 4, 0);
+						vector<int> children = o.children; // objects may not be reallocated, but be safe
+						for(size_t i = 0; i < children.size(); i++) {
+							patch(pos + 4 + i * 4, write(children[i]));
+						}
+						break;
+					}
+					case Object::Structs: {
+						pad(o.align, 4);
+						pos = buffer.size();
+						uint32_t len = o.count;
+						put(&len, 4);
+						put(o.bytes.data(), o.bytes.size());
+						break;
+					}
+				}
+				return pos;
+			}
+
+			vector<Object> objects;
+			vector<uint8_t> buffer;
+	};
+
+	/// Bounds checked flatbuffer table reader.
+	class FlatTable {
+
+		public:
+
+			FlatTable() : data(nullptr), size(0), pos(0), vtable(0), vtableSize(0) {}
+
+			// read a table at a position
+			FlatTable(const uint8_t *data, size_t size, size_t pos) :
+				data(data), size(size), pos(pos), vtable(0), vtableSize(0) {
+				if(pos % 4 != 0 || pos + 4 > size) {
+					this->data = nullptr;
+					return;
+				}
+				int32_t soffset;
+				memcpy(&soffset, data + pos, 4);
+				int64_t vt = static_cast<int64_t>(pos) - soffset;
+				if(vt < 0 || vt % 2 != 0 || vt + 4 > (int64_t)size) {
+					this->data = nullptr;
+					return;
+				}
+				vtable = vt;
+				uint16_t vs;
+				memcpy(&vs, data + vtable, 2);
+				if(vs < 4 || vs % 2 != 0 || vtable + vs > size) {
+					this->data = nullptr;
+					return;
+				}
+				vtableSize = vs;
+			}
+
+			// read the root table of a buffer
+			static FlatTable root(const uint8_t *data, size_t size) {
+				if(size < 4) {
+					return FlatTable();
+				}
+				uint32_t offset;
+				memcpy(&offset, data, 4);
+				return FlatTable(data, size, offset);
+			}
+
+			bool valid() const {return data != nullptr;}
+
+			// get the position of a field or 0 if absent or out of bounds
+			size_t field(int id, size_t fieldSize) const {
+				if(!data || id < 0 || 4 + (size_t)id * 2 + 2 > vtableSize) {
+					return 0;
+				}
+				uint16_t offset;
+				memcpy(&offset, data + vtable + 4 + id * 2, 2);
+				if(offset == 0 || pos + offset + fieldSize > size) {
+					return 0;
+				}
+				return pos + offset;
+			}
+
+			// read a scalar field
+			template<typename T>
+			T scalar(int id, T defaultValue) const {
+				size_t at = field(id, sizeof(T));
+				if(!at) {
+					return defaultValue;
+				}
+				T value;
+				memcpy(&value, data + at, sizeof(T));
+				return value;
+			}
+
+			// read a referenced table field
+			FlatTable table(int id) const {
+				size_t at = target(id);
+				return (at ? FlatTable(data, size, at) : FlatTable());
+			}
+
+			// read a vector field, returns the element position & count
+			bool getVector(int id, size_t elementSize, size_t &elements, size_t &count) const {
+				size_t at = target(id);
+				if(!at || at + 4 > size) {
+					return false;
+				}
+				uint32_t len;
+				memcpy(&len, data + at, 4);
+				if((uint64_t)len * elementSize > size - at - 4) {
+					return false;
+				}
+				elements = at + 4;
+				count = len;
+				return true;
+			}
+
+			// read the table element of a vector of tables
+			FlatTable element(size_t elements, size_t index) const {
+				size_t at = elements + index * 4;
+				uint32_t offset;
+				memcpy(&offset, data + at, 4);
+				if(at + offset >= size) {
+					return FlatTable();
+				}
+				return FlatTable(data, size, at + offset);
+			}
+
+			// read a string field
+			string text(int id) const {
+				size_t elements, count;
+				if(!getVector(id, 1, elements, count)) {
+					return "";
+				}
+				return string(reinterpret_cast<const char *>(data + elements), count);
+			}
+
+			const uint8_t *data;
+
+		protected:
+
+			// get the position referenced by an offset field, 0 if invalid
+			size_t target(int id) const {
+				size_t at = field(id, 4);
+				if(!at) {
+					return 0;
+				}
+				uint32_t offset;
+				memcpy(&offset, data + at, 4);
+				if(at + offset >= size) {
+					return 0;
+				}
+				return at + offset;
+			}
+
+			size_t size;
+			size_t pos;
+			size_t vtable;
+			size_t vtableSize;
+	};
+
+	// column type info read from a schema Field
+	struct ArrowField {
+		string name;
+		int type = 0;           //< ArrowType
+		int bitWidth = 0;       //< Int bit width
+		bool isSigned = true;   //< Int signedness
+		int precision = 0;      //< FloatingPoint precision: 0 half, 1 single, 2 double
+		int64_t unitNanos = 1;  //< Timestamp & Date nanoseconds per unit
+		bool date = false;      //< Date type?
+	};
+
+	// build a Schema table
+	int buildSchema(FlatBuilder &fb, const ofxCsvSchema &schema) {
+		vector<int> fields;
+		for(size_t col = 0; col < schema.size(); col++) {
+			int type = fb.table();
+			uint8_t typeType = TypeUtf8;
+			switch(schema[col].type) {
+				case ofxCsvSchema::Int:
+					typeType = TypeInt;
+					fb.scalar<int32_t>(type, 0, 64);  // bitWidth
+					fb.scalar<uint8_t>(type, 1, 1);   // is_signed
+					break;
+				case ofxCsvSchema::Float:
+					typeType = TypeFloatingPoint;
+					fb.scalar<int16_t>(type, 0, 2);   // precision: DOUBLE
+					break;
+				case ofxCsvSchema::Bool:
+					typeType = TypeBool;
+					break;
+				case ofxCsvSchema::Timestamp:
+					typeType = TypeTimestamp;
+					fb.scalar<int16_t>(type, 0, 3);   // unit: NANOSECOND
+					fb.offset(type, 1, fb.addString("UTC"));
+					break;
+				case ofxCsvSchema::String:
+					break;
+			}
+			string name = schema[col].name;
+			if(name.empty()) {
+				name = "f" + std::to_string(col);
+			}
+			int field = fb.table();
+			fb.offset(field, FieldName, fb.addString(name));
+			fb.scalar<uint8_t>(field, FieldNullable, 1);
+			fb.scalar<uint8_t>(field, FieldTypeType, typeType);
+			fb.offset(field, FieldType, type);
+			fb.offset(field, FieldChildren, fb.tables(vector<int>()));
+			fields.push_back(field);
+		}
+		int table = fb.table();
+#ifdef OFX_CSV_BIG_ENDIAN
+		fb.scalar<int16_t>(table, SchemaEndianness, 1);
+#else
+		fb.scalar<int16_t>(table, SchemaEndianness, 0);
+#endif
+		fb.offset(table, SchemaFields, fb.tables(fields));
+		return table;
+	}
+
+	// build an encapsulated message, returns the metadata flatbuffer
+	vector<uint8_t> buildMessage(FlatBuilder &fb, uint8_t headerType, int header, int64_t bodyLength) {
+		int message = fb.table();
+		fb.scalar<int16_t>(message, MessageVersion, s_metadataV5);
+		fb.scalar<uint8_t>(message, MessageHeaderType, headerType);
+		fb.offset(message, MessageHeaderTable, header);
+		fb.scalar<int64_t>(message, MessageBodyLength, bodyLength);
+		return fb.finish(message);
+	}
+
+	// write an encapsulated message: continuation marker, metadata length,
+	// metadata, & body
+	bool writeMessage(ofxCsvWriter &writer, const vector<uint8_t> &metadata,
+	                  const vector<uint8_t> &body, Block &block) {
+		block.offset = writer.getBytesWritten();
+		block.metaDataLength = 8 + metadata.size();
+		block.pad = 0;
+		block.bodyLength = body.size();
+		int32_t prefix[2] = {-1, static_cast<int32_t>(metadata.size())};
+		writer.write(reinterpret_cast<const char *>(prefix), 8);
+		writer.write(reinterpret_cast<const char *>(metadata.data()), metadata.size());
+		return writer.write(reinterpret_cast<const char *>(body.data()), body.size());
+	}
+
+	// append a buffer to a record batch body, 8 byte aligned
+	void addBuffer(vector<uint8_t> &body, vector<BufferRef> &buffers, const void *data, size_t size) {
+		BufferRef ref;
+		ref.offset = body.size();
+		ref.length = size;
+		if(size > 0) {
+			const uint8_t *p = static_cast<const uint8_t *>(data);
+			body.insert(body.end(), p, p + size);
+		}
+		body.resize(pad8(body.size()), 0);
+		buffers.push_back(ref);
+	}
+
+	// format a double with as few digits as round trip exactly
+	string formatDouble(double v) {
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.15g", v);
+		if(strtod(buffer, nullptr) != v) {
+			snprintf(buffer, sizeof(buffer), "%.17g", v);
+		}
+		return buffer;
+	}
+
+	// format a float with as few digits as round trip exactly
+	string formatFloat(float v) {
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.7g", v);
+		if(strtof(buffer, nullptr) != v) {
+			snprintf(buffer, sizeof(buffer), "%.9g", v);
+		}
+		return buffer;
+	}
+
+	// is bit i set in a bitmap?
+	inline bool getBit(const uint8_t *bits, size_t i) {
+		return (bits[i >> 3] >> (i & 7)) & 1;
+	}
+
+	// read a Field type from a schema
+	bool readField(const FlatTable &field, ArrowField &info, string &error) {
+		info.name = field.text(FieldName);
+		if(field.table(FieldDictionary).valid()) {
+			error = "dictionary encoded field \"" + info.name + "\" not supported";
+			return false;
+		}
+		info.type = field.scalar<uint8_t>(FieldTypeType, 0);
+		FlatTable type = field.table(FieldType);
+		switch(info.type) {
+			case TypeNull: case TypeBool: case TypeUtf8: case TypeBinary:
+			case TypeLargeUtf8: case TypeLargeBinary:
+				return true;
+			case TypeInt:
+				info.bitWidth = type.scalar<int32_t>(0, 0);
+				info.isSigned = type.scalar<uint8_t>(1, 0) != 0;
+				if(info.bitWidth != 8 && info.bitWidth != 16 && info.bitWidth != 32 && info.bitWidth != 64) {
+					error = "invalid int bit width for field \"" + info.name + "\"";
+					return false;
+				}
+				return true;
+			case TypeFloatingPoint:
+				info.precision = type.scalar<int16_t>(0, 0);
+				if(info.precision != 1 && info.precision != 2) {
+					error = "half float field \"" + info.name + "\" not supported";
+					return false;
+				}
+				return true;
+			case TypeTimestamp: {
+				static const int64_t s_units[] = {1000000000LL, 1000000LL, 1000LL, 1LL};
+				int16_t unit = type.scalar<int16_t>(0, 0);
+				if(unit < 0 || unit > 3) {
+					error = "invalid timestamp unit for field \"" + info.name + "\"";
+					return false;
+				}
+				info.unitNanos = s_units[unit];
+				return true;
+			}
+			case TypeDate: {
+				int16_t unit = type.scalar<int16_t>(0, 1); // default MILLISECOND
+				info.date = true;
+				info.unitNanos = (unit == 0 ? 86400 * 1000000000LL : 1000000LL);
+				info.bitWidth = (unit == 0 ? 32 : 64);
+				return true;
+			}
+			default:
+				error = "type of field \"" + info.name + "\" not supported";
+				return false;
+		}
+	}
+
+	// get the table column type for an Arrow field
+	ofxCsvSchema::Type getColumnType(const ArrowField &info) {
+		switch(info.type) {
+			case TypeInt:           return ofxCsvSchema::Int;
+			case TypeFloatingPoint: return ofxCsvSchema::Float;
+			case TypeBool:          return ofxCsvSchema::Bool;
+			case TypeTimestamp:
+			case TypeDate:          return ofxCsvSchema::Timestamp;
+			default:                return ofxCsvSchema::String;
+		}
+	}
+}
+
+//--------------------------------------------------
+bool ofxCsvArrow::write(const string &path, const vector<ofxCsvRow> &rows, size_t first,
+                        const ofxCsvSchema &schema, const vector<ofxCsvColumn> &columns,
+                        size_t batchSize) {
+	bool stream = isStreamPath(path);
+	batchSize = std::max<size_t>(batchSize, 1);
+	ofxCsvWriter writer;
+	if(!writer.open(path, ofxCsvCompression::None)) {
+		return false;
+	}
+	if(!stream) {
+		writer.write(s_magic, 6);
+		writer.write("\0\0", 2);
+	}
+
+	// schema
+	{
+		FlatBuilder fb;
+		int header = buildSchema(fb, schema);
+		Block block;
+		writeMessage(writer, buildMessage(fb, HeaderSchema, header, 0), vector<uint8_t>(), block);
+	}
+
+	// record batches
+	vector<Block> blocks;
+	vector<uint8_t> body, bits;
+	vector<int32_t> offsets;
+	for(size_t begin = first; begin < rows.size(); begin += batchSize) {
+		size_t end = std::min(begin + batchSize, rows.size());
+		size_t length = end - begin;
+		vector<FieldNode> nodes;
+		vector<BufferRef> buffers;
+		body.clear();
+		for(size_t col = 0; col < schema.size(); col++) {
+			const ofxCsvColumn &column = columns[col];
+			ofxCsvSchema::Type type = schema[col].type;
+
+			// validity bitmap, strings are null if empty or missing
+			FieldNode node;
+			node.length = length;
+			node.nullCount = 0;
+			bits.assign((length + 7) / 8, 0);
+			for(size_t i = 0; i < length; i++) {
+				bool valid;
+				if(type == ofxCsvSchema::String) {
+					const vector<string> &fields = rows[begin + i].getData();
+					valid = (col < fields.size() && !fields[col].empty());
+				}
+				else {
+					valid = !column.isNull(begin + i);
+				}
+				if(valid) {
+					bits[i >> 3] |= (1 << (i & 7));
+				}
+				else {
+					node.nullCount++;
+				}
+			}
+			nodes.push_back(node);
+			addBuffer(body, buffers, bits.data(), (node.nullCount > 0 ? bits.size() : 0));
+
+			// values
+			switch(type) {
+				case ofxCsvSchema::Int:
+				case ofxCsvSchema::Timestamp:
+					addBuffer(body, buffers, column.getInts().data() + begin, length * 8);
+					break;
+				case ofxCsvSchema::Float:
+					addBuffer(body, buffers, column.getDoubles().data() + begin, length * 8);
+					break;
+				case ofxCsvSchema::Bool: {
+					const vector<int64_t> &values = column.getInts();
+					bits.assign((length + 7) / 8, 0);
+					for(size_t i = 0; i < length; i++) {
+						if(values[begin + i]) {
+							bits[i >> 3] |= (1 << (i & 7));
+						}
+					}
+					addBuffer(body, buffers, bits.data(), bits.size());
+					break;
+				}
+				case ofxCsvSchema::String: {
+					offsets.assign(length + 1, 0);
+					size_t total = 0;
+					for(size_t i = 0; i < length; i++) {
+						const vector<string> &fields = rows[begin + i].getData();
+						if(col < fields.size()) {
+							total += fields[col].size();
+						}
+						if(total > INT32_MAX) {
+							OFX_CSV_LOG_ERROR << "Cannot write Arrow file " << path
+							                  << ": strings in column " << col << " exceed 2 GB per batch";
+							writer.close();
+							remove(path.c_str());
+							return false;
+						}
+						offsets[i + 1] = total;
+					}
+					addBuffer(body, buffers, offsets.data(), offsets.size() * 4);
+					BufferRef ref;
+					ref.offset = body.size();
+					ref.length = total;
+					for(size_t i = 0; i < length; i++) {
+						const vector<string> &fields = rows[begin + i].getData();
+						if(col < fields.size()) {
+							body.insert(body.end(), fields[col].begin(), fields[col].end());
+						}
+					}
+					body.resize(pad8(body.size()), 0);
+					buffers.push_back(ref);
+					break;
+				}
+			}
+		}
+		FlatBuilder fb;
+		int batch = fb.table();
+		fb.scalar<int64_t>(batch, BatchLength, length);
+		fb.offset(batch, BatchNodes, fb.structs(nodes));
+		fb.offset(batch, BatchBuffers, fb.structs(buffers));
+		Block block;
+		writeMessage(writer, buildMessage(fb, HeaderRecordBatch, batch, body.size()), body, block);
+		blocks.push_back(block);
+	}
+
+	// end of stream marker
+	int32_t eos[2] = {-1, 0};
+	writer.write(reinterpret_cast<const char *>(eos), 8);
+
+	// file footer
+	if(!stream) {
+		FlatBuilder fb;
+		int footer = fb.table();
+		fb.scalar<int16_t>(footer, FooterVersion, s_metadataV5);
+		fb.offset(footer, FooterSchema, buildSchema(fb, schema));
+		fb.offset(footer, FooterDictionaries, fb.structs(vector<Block>()));
+		fb.offset(footer, FooterRecordBatches, fb.structs(blocks));
+		vector<uint8_t> metadata = fb.finish(footer);
+		int32_t len = metadata.size();
+		writer.write(reinterpret_cast<const char *>(metadata.data()), metadata.size());
+		writer.write(reinterpret_cast<const char *>(&len), 4);
+		writer.write(s_magic, 6);
+	}
+	return writer.close();
+}
+
+//--------------------------------------------------
+bool ofxCsvArrow::read(const string &path, bool header, vector<ofxCsvRow> &rows,
+                       ofxCsvSchema &schema, vector<ofxCsvColumn> &columns, string &error) {
+	rows.clear();
+	schema = ofxCsvSchema();
+	columns.clear();
+
+	string buffer;
+	if(!ofxCsvFileUtils::readFile(path, buffer)) {
+		error = "couldn't read file";
+		return false;
+	}
+	const uint8_t *data = reinterpret_cast<const uint8_t *>(buffer.data());
+	size_t size = buffer.size();
+
+	// file format: skip the leading magic & stop at the footer
+	size_t pos = 0;
+	if(size >= 8 && memcmp(data, s_magic, 6) == 0) {
+		if(size < 18 || memcmp(data + size - 6, s_magic, 6) != 0) {
+			error = "truncated file";
+			return false;
+		}
+		int32_t footerLength;
+		memcpy(&footerLength, data + size - 10, 4);
+		if(footerLength < 0 || (size_t)footerLength > size - 18) {
+			error = "invalid footer";
+			return false;
+		}
+		size -= 10 + footerLength;
+		pos = 8;
+	}
+
+	vector<ArrowField> fields;
+	vector<bool> hasRange;
+	bool hasSchema = false;
+	while(pos + 4 <= size) {
+
+		// message prefix: continuation marker & length, or a legacy length
+		int32_t length;
+		memcpy(&length, data + pos, 4);
+		pos += 4;
+		if(length == -1) {
+			if(pos + 4 > size) {
+				break;
+			}
+			memcpy(&length, data + pos, 4);
+			pos += 4;
+		}
+		if(length == 0) { // end of stream
+			break;
+		}
+		if(length < 0 || (size_t)length > size - pos) {
+			error = "invalid message length";
+			return false;
+		}
+		FlatTable message = FlatTable::root(data + pos, length);
+		if(!message.valid()) {
+			error = "invalid message";
+			return false;
+		}
+		pos += length;
+		int64_t bodyLength = message.scalar<int64_t>(MessageBodyLength, 0);
+		if(bodyLength < 0 || (uint64_t)bodyLength > size - pos) {
+			error = "invalid message body length";
+			return false;
+		}
+		const uint8_t *body = data + pos;
+		pos += bodyLength;
+
+		uint8_t headerType = message.scalar<uint8_t>(MessageHeaderType, 0);
+		FlatTable headerTable = message.table(MessageHeaderTable);
+		if(headerType == HeaderSchema) {
+			if(hasSchema) {
+				continue;
+			}
+#ifdef OFX_CSV_BIG_ENDIAN
+			if(headerTable.scalar<int16_t>(SchemaEndianness, 0) != 1) {
+#else
+			if(headerTable.scalar<int16_t>(SchemaEndianness, 0) != 0) {
+#endif
+				error = "byte order not supported";
+				return false;
+			}
+			size_t elements, count;
+			if(!headerTable.getVector(SchemaFields, 4, elements, count)) {
+				error = "invalid schema";
+				return false;
+			}
+			ofxCsvRow names;
+			for(size_t i = 0; i < count; i++) {
+				FlatTable field = headerTable.element(elements, i);
+				ArrowField info;
+				if(!field.valid() || !readField(field, info, error)) {
+					if(error.empty()) {
+						error = "invalid schema field";
+					}
+					return false;
+				}
+				fields.push_back(info);
+				hasRange.push_back(false);
+				schema.addColumn(getColumnType(info), info.name);
+				columns.push_back(ofxCsvColumn(getColumnType(info)));
+				names.addString(info.name);
+			}
+			schema.setHeader(header);
+			if(header) {
+				rows.push_back(names);
+				for(auto &column : columns) {
+					column.addNull();
+				}
+			}
+			hasSchema = true;
+		}
+		else if(headerType == HeaderDictionaryBatch) {
+			error = "dictionary batches not supported";
+			return false;
+		}
+		else if(headerType == HeaderRecordBatch) {
+			if(!hasSchema) {
+				error = "record batch before schema";
+				return false;
+			}
+			if(headerTable.table(BatchCompression).valid()) {
+				error = "compressed record batches not supported";
+				return false;
+			}
+			int64_t length = headerTable.scalar<int64_t>(BatchLength, 0);
+			size_t nodesAt, numNodes, buffersAt, numBuffers;
+			// every non-null column needs at least a bit per row in the body,
+			// so a corrupt length can't trigger a huge allocation
+			bool allNull = true;
+			for(const ArrowField &info : fields) {
+				allNull = allNull && info.type == TypeNull;
+			}
+			if(length < 0 || length > INT32_MAX || (!allNull && length / 8 > bodyLength) ||
+			   !headerTable.getVector(BatchNodes, sizeof(FieldNode), nodesAt, numNodes) ||
+			   !headerTable.getVector(BatchBuffers, sizeof(BufferRef), buffersAt, numBuffers) ||
+			   numNodes != fields.size()) {
+				error = "invalid record batch";
+				return false;
+			}
+			size_t start = rows.size();
+			rows.resize(start + length);
+			for(size_t r = start; r < rows.size(); r++) {
+				rows[r].getData().resize(fields.size());
+			}
+
+			// get a body buffer, checking its bounds & size
+			size_t nextBuffer = 0;
+			auto getBuffer = [&](size_t minSize, const uint8_t *&p, size_t &len) {
+				if(nextBuffer >= numBuffers) {
+					return false;
+				}
+				BufferRef ref;
+				memcpy(&ref, headerTable.data + buffersAt + nextBuffer * sizeof(BufferRef), sizeof(BufferRef));
+				nextBuffer++;
+				if(ref.offset < 0 || ref.length < 0 || ref.offset > bodyLength ||
+				   ref.length > bodyLength - ref.offset || (uint64_t)ref.length < minSize) {
+					return false;
+				}
+				p = body + ref.offset;
+				len = ref.length;
+				return true;
+			};
+
+			for(size_t col = 0; col < fields.size(); col++) {
+				const ArrowField &info = fields[col];
+				ofxCsvColumn &column = columns[col];
+				ofxCsvSchema::Column &stats = schema[col];
+				FieldNode node;
+				memcpy(&node, headerTable.data + nodesAt + col * sizeof(FieldNode), sizeof(FieldNode));
+				if(node.length != length || node.nullCount < 0) {
+					error = "invalid field node for \"" + info.name + "\"";
+					return false;
+				}
+				size_t n = length;
+				stats.count += n;
+				stats.nullCount += node.nullCount;
+				if(info.type == TypeNull) { // no buffers
+					for(size_t i = 0; i < n; i++) {
+						column.addNull();
+					}
+					continue;
+				}
+
+				// validity
+				const uint8_t *validity, *values;
+				size_t validityLen, valuesLen;
+				bool ok = getBuffer(0, validity, validityLen);
+				bool hasNulls = (node.nullCount > 0);
+				if(ok && hasNulls && validityLen < (n + 7) / 8) {
+					ok = false;
+				}
+				auto isValid = [&](size_t i) {
+					return !hasNulls || getBit(validity, i);
+				};
+
+				switch(info.type) {
+					case TypeInt: {
+						size_t width = info.bitWidth / 8;
+						if(!ok || !getBuffer(n * width, values, valuesLen)) {
+							ok = false;
+							break;
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!isValid(i)) {
+								column.addNull();
+								continue;
+							}
+							int64_t v = 0;
+							const uint8_t *p = values + i * width;
+							switch(info.bitWidth) {
+								case 8:  v = (info.isSigned ? (int64_t)(int8_t)*p : (int64_t)*p); break;
+								case 16: {int16_t s; memcpy(&s, p, 2); v = (info.isSigned ? (int64_t)s : (int64_t)(uint16_t)s); break;}
+								case 32: {int32_t s; memcpy(&s, p, 4); v = (info.isSigned ? (int64_t)s : (int64_t)(uint32_t)s); break;}
+								case 64: memcpy(&v, p, 8); break;
+							}
+							column.addInt(v);
+							rows[start + i].getData()[col] = (info.isSigned || info.bitWidth < 64 ?
+							                                  std::to_string(v) : std::to_string((uint64_t)v));
+						}
+						break;
+					}
+					case TypeFloatingPoint: {
+						size_t width = (info.precision == 1 ? 4 : 8);
+						if(!ok || !getBuffer(n * width, values, valuesLen)) {
+							ok = false;
+							break;
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!isValid(i)) {
+								column.addNull();
+								continue;
+							}
+							double v;
+							if(width == 4) {
+								float f;
+								memcpy(&f, values + i * 4, 4);
+								v = f;
+								rows[start + i].getData()[col] = formatFloat(f);
+							}
+							else {
+								memcpy(&v, values + i * 8, 8);
+								rows[start + i].getData()[col] = formatDouble(v);
+							}
+							column.addDouble(v);
+						}
+						break;
+					}
+					case TypeBool: {
+						if(!ok || !getBuffer((n + 7) / 8, values, valuesLen)) {
+							ok = false;
+							break;
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!isValid(i)) {
+								column.addNull();
+								continue;
+							}
+							bool v = getBit(values, i);
+							column.addInt(v ? 1 : 0);
+							rows[start + i].getData()[col] = (v ? "true" : "false");
+						}
+						break;
+					}
+					case TypeTimestamp:
+					case TypeDate: {
+						size_t width = (info.date ? info.bitWidth / 8 : 8);
+						if(!ok || !getBuffer(n * width, values, valuesLen)) {
+							ok = false;
+							break;
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!isValid(i)) {
+								column.addNull();
+								continue;
+							}
+							int64_t v;
+							if(width == 4) {
+								int32_t days;
+								memcpy(&days, values + i * 4, 4);
+								v = days;
+							}
+							else {
+								memcpy(&v, values + i * 8, 8);
+							}
+							if(v > INT64_MAX / info.unitNanos || v < INT64_MIN / info.unitNanos) {
+								column.addNull(); // out of the nanosecond range
+								continue;
+							}
+							v *= info.unitNanos;
+							column.addInt(v);
+							rows[start + i].getData()[col] = ofxCsvTimestamp::toString(v, info.date);
+						}
+						break;
+					}
+					case TypeUtf8: case TypeBinary:
+					case TypeLargeUtf8: case TypeLargeBinary: {
+						bool large = (info.type == TypeLargeUtf8 || info.type == TypeLargeBinary);
+						size_t width = (large ? 8 : 4);
+						const uint8_t *offsets;
+						size_t offsetsLen;
+						if(!ok || !getBuffer((n + 1) * width, offsets, offsetsLen) ||
+						   !getBuffer(0, values, valuesLen)) {
+							ok = false;
+							break;
+						}
+						for(size_t i = 0; i < n && ok; i++) {
+							if(!isValid(i)) {
+								column.addNull();
+								continue;
+							}
+							int64_t a, b;
+							if(large) {
+								memcpy(&a, offsets + i * 8, 8);
+								memcpy(&b, offsets + i * 8 + 8, 8);
+							}
+							else {
+								int32_t a32, b32;
+								memcpy(&a32, offsets + i * 4, 4);
+								memcpy(&b32, offsets + i * 4 + 4, 4);
+								a = a32;
+								b = b32;
+							}
+							if(a < 0 || b < a || (uint64_t)b > valuesLen) {
+								ok = false;
+								break;
+							}
+							string &field = rows[start + i].getData()[col];
+							field.assign(reinterpret_cast<const char *>(values + a), b - a);
+							column.add(field);
+						}
+						break;
+					}
+				}
+				if(!ok) {
+					error = "invalid buffers for field \"" + info.name + "\"";
+					return false;
+				}
+				if(info.type != TypeUtf8 && info.type != TypeBinary &&
+				   info.type != TypeLargeUtf8 && info.type != TypeLargeBinary) {
+					// numeric & timestamp value range
+					for(size_t row = start; row < start + n; row++) {
+						if(!column.isNull(row)) {
+							double v = column.getDouble(row);
+							if(!hasRange[col] || v < stats.min) {stats.min = v;}
+							if(!hasRange[col] || v > stats.max) {stats.max = v;}
+							hasRange[col] = true;
+						}
+					}
+				}
+			}
+		}
+	}
+	if(!hasSchema) {
+		error = "no schema found";
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvArrow::isStreamPath(const string &path) {
+	return path.size() >= 7 && path.compare(path.size() - 7, 7, ".arrows") == 0;
+}
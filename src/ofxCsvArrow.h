@@ -0,0 +1,92 @@
+/**
+ *  ofxCsvArrow.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+#include "ofxCsvColumn.h"
+
+/// \class ofxCsvArrow
+/// \brief Apache Arrow IPC file & stream reading & writing
+///
+/// Writes typed table columns as Arrow record batches which other tools,
+/// ie. pyarrow, pandas, polars, or DuckDB, can memory map without parsing:
+///
+///     import pyarrow as pa
+///     table = pa.ipc.open_file("data.arrow").read_all()
+///
+/// Column types map to Arrow types as follows:
+///
+///   * Int: int64
+///   * Float: float64 (double)
+///   * Bool: bool
+///   * Timestamp: timestamp[ns, tz=UTC]
+///   * String: utf8, empty fields are null
+///
+/// Reading accepts signed & unsigned 8-64 bit ints, float32 & float64,
+/// bool, utf8, large utf8, binary, timestamp & date, & null columns without
+/// IPC body compression or dictionary encoding.
+///
+/// Uses the IPC file format, "ARROW1" with a footer, & the stream format
+/// for paths ending in .arrows. The flatbuffer metadata is read & written
+/// directly, no Arrow library is required.
+///
+class ofxCsvArrow {
+
+	public:
+
+		/// Write rows & typed columns to an Arrow IPC file or stream.
+		///
+		/// \param path Absolute file path, .arrows uses the stream format.
+		/// \param rows Table rows, used for String column text.
+		/// \param first Index of the first row to write, ie. 1 to skip a header.
+		/// \param schema Column names & types.
+		/// \param columns Typed column values, indexed by table row.
+		/// \param batchSize Number of rows per record batch.
+		/// \returns true on success
+		static bool write(const string &path, const vector<ofxCsvRow> &rows, size_t first,
+		                  const ofxCsvSchema &schema, const vector<ofxCsvColumn> &columns,
+		                  size_t batchSize=65536);
+
+		/// Read an Arrow IPC file or stream into rows & typed columns.
+		///
+		/// \param path Absolute file path.
+		/// \param header Add a header row with the field names?
+		/// \param rows Set to the table rows.
+		/// \param schema Set to the column names & types.
+		/// \param columns Set to the typed column values, indexed by table row.
+		/// \param error Set to an error message on failure.
+		/// \returns true on success
+		static bool read(const string &path, bool header, vector<ofxCsvRow> &rows,
+		                 ofxCsvSchema &schema, vector<ofxCsvColumn> &columns, string &error);
+
+		/// Does a path use the stream format, ie. ends with .arrows?
+		static bool isStreamPath(const string &path);
+};
@@ -0,0 +1,319 @@
+/**
+ *  ofxCsvColumn.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvColumn.h"
+#include "ofxCsvTimestamp.h"
+
+#include <climits>
+
+// is a char surrounding whitespace?
+static inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// find the field bounds without surrounding whitespace
+static inline void trimBounds(const string &field, const char *&begin, const char *&end) {
+	begin = field.c_str();
+	end = begin + field.size();
+	while(begin < end && isSpace(*begin)) {begin++;}
+	while(end > begin && isSpace(*(end-1))) {end--;}
+}
+
+// compare to a lowercase word, ignoring case
+static inline bool equalsWord(const char *p, size_t len, const char *word) {
+	if(len != strlen(word)) {
+		return false;
+	}
+	for(size_t i = 0; i < len; i++) {
+		if(tolower((unsigned char)p[i]) != word[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------
+ofxCsvColumn::ofxCsvColumn(ofxCsvSchema::Type type) : type(type) {}
+
+// DATA IO
+
+//--------------------------------------------------
+bool ofxCsvColumn::add(const string &field) {
+	bool ok = false;
+	switch(type) {
+		case ofxCsvSchema::Int: {
+			int64_t v = 0;
+			ok = parseInt(field, v);
+			ints.push_back(v);
+			break;
+		}
+		case ofxCsvSchema::Float: {
+			double v = 0;
+			ok = parseFloat(field, v);
+			doubles.push_back(v);
+			break;
+		}
+		case ofxCsvSchema::Bool: {
+			bool v = false;
+			ok = parseBool(field, v);
+			ints.push_back(v ? 1 : 0);
+			break;
+		}
+		case ofxCsvSchema::Timestamp: {
+			int64_t v = 0;
+			ok = parseTimestamp(field, v);
+			ints.push_back(v);
+			break;
+		}
+		case ofxCsvSchema::String:
+			ok = !ofxCsvSchema::isNull(field);
+			break;
+	}
+	valid.push_back(ok ? 1 : 0);
+	return ok;
+}
+
+//--------------------------------------------------
+void ofxCsvColumn::addInt(int64_t value) {
+	switch(type) {
+		case ofxCsvSchema::Float:
+			doubles.push_back(value);
+			break;
+		case ofxCsvSchema::String:
+			break;
+		default:
+			ints.push_back(value);
+			break;
+	}
+	valid.push_back(1);
+}
+
+//--------------------------------------------------
+void ofxCsvColumn::addDouble(double value) {
+	switch(type) {
+		case ofxCsvSchema::Float:
+			doubles.push_back(value);
+			break;
+		case ofxCsvSchema::String:
+			break;
+		default:
+			ints.push_back(static_cast<int64_t>(value));
+			break;
+	}
+	valid.push_back(1);
+}
+
+//--------------------------------------------------
+void ofxCsvColumn::addNull() {
+	switch(type) {
+		case ofxCsvSchema::Float:
+			doubles.push_back(0);
+			break;
+		case ofxCsvSchema::String:
+			break;
+		default:
+			ints.push_back(0);
+			break;
+	}
+	valid.push_back(0);
+}
+
+//--------------------------------------------------
+void ofxCsvColumn::reserve(size_t size) {
+	switch(type) {
+		case ofxCsvSchema::Float:
+			doubles.reserve(size);
+			break;
+		case ofxCsvSchema::String:
+			break;
+		default:
+			ints.reserve(size);
+			break;
+	}
+	valid.reserve(size);
+}
+
+//--------------------------------------------------
+void ofxCsvColumn::clear() {
+	ints.clear();
+	doubles.clear();
+	valid.clear();
+}
+
+// GET VALUES
+
+//--------------------------------------------------
+ofxCsvSchema::Type ofxCsvColumn::getType() const {
+	return type;
+}
+
+//--------------------------------------------------
+size_t ofxCsvColumn::size() const {
+	return valid.size();
+}
+
+//--------------------------------------------------
+bool ofxCsvColumn::isNull(size_t row) const {
+	return row >= valid.size() || !valid[row];
+}
+
+//--------------------------------------------------
+int64_t ofxCsvColumn::getInt(size_t row) const {
+	if(isNull(row)) {
+		return 0;
+	}
+	switch(type) {
+		case ofxCsvSchema::Float:
+			return static_cast<int64_t>(doubles[row]);
+		case ofxCsvSchema::String:
+			return 0;
+		default:
+			return ints[row];
+	}
+}
+
+//--------------------------------------------------
+double ofxCsvColumn::getDouble(size_t row) const {
+	if(isNull(row)) {
+		return 0.0;
+	}
+	switch(type) {
+		case ofxCsvSchema::Float:
+			return doubles[row];
+		case ofxCsvSchema::String:
+			return 0.0;
+		default:
+			return static_cast<double>(ints[row]);
+	}
+}
+
+//--------------------------------------------------
+bool ofxCsvColumn::getBool(size_t row) const {
+	return getDouble(row) != 0.0;
+}
+
+//--------------------------------------------------
+const vector<int64_t>& ofxCsvColumn::getInts() const {
+	return ints;
+}
+
+//--------------------------------------------------
+const vector<double>& ofxCsvColumn::getDoubles() const {
+	return doubles;
+}
+
+//--------------------------------------------------
+const vector<uint8_t>& ofxCsvColumn::getValid() const {
+	return valid;
+}
+
+// UTIL
+
+//--------------------------------------------------
+bool ofxCsvColumn::parseInt(const string &field, int64_t &value) {
+	const char *p, *end;
+	trimBounds(field, p, end);
+	bool negative = false;
+	if(p < end && (*p == '-' || *p == '+')) {
+		negative = (*p == '-');
+		p++;
+	}
+	if(p == end) {
+		return false;
+	}
+	uint64_t v = 0;
+	const uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+	for(; p < end; p++) {
+		if(*p < '0' || *p > '9') {
+			return false;
+		}
+		unsigned digit = *p - '0';
+		if(v > (limit - digit) / 10) { // overflow
+			return false;
+		}
+		v = v * 10 + digit;
+	}
+	value = negative ? (int64_t)(0 - v) : (int64_t)v;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvColumn::parseFloat(const string &field, double &value) {
+	const char *begin, *end;
+	trimBounds(field, begin, end);
+
+	// validate the decimal syntax first as strtod also accepts hex, inf, etc
+	const char *p = begin;
+	if(p < end && (*p == '-' || *p == '+')) {p++;}
+	size_t digits = 0;
+	while(p < end && *p >= '0' && *p <= '9') {p++; digits++;}
+	if(p < end && *p == '.') {
+		p++;
+		while(p < end && *p >= '0' && *p <= '9') {p++; digits++;}
+	}
+	if(digits == 0) {
+		return false;
+	}
+	if(p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if(p < end && (*p == '-' || *p == '+')) {p++;}
+		size_t exponent = 0;
+		while(p < end && *p >= '0' && *p <= '9') {p++; exponent++;}
+		if(exponent == 0) {
+			return false;
+		}
+	}
+	if(p != end) {
+		return false;
+	}
+	value = strtod(begin, nullptr);
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvColumn::parseBool(const string &field, bool &value) {
+	const char *begin, *end;
+	trimBounds(field, begin, end);
+	size_t len = end - begin;
+	if(equalsWord(begin, len, "true")) {
+		value = true;
+		return true;
+	}
+	if(equalsWord(begin, len, "false")) {
+		value = false;
+		return true;
+	}
+	return false;
+}
+
+//--------------------------------------------------
+bool ofxCsvColumn::parseTimestamp(const string &field, int64_t &value) {
+	return ofxCsvTimestamp::parse(field, value);
+}
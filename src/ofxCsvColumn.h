@@ -0,0 +1,146 @@
+/**
+ *  ofxCsvColumn.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvSchema.h"
+
+/// \class ofxCsvColumn
+/// \brief typed values of a single table column
+///
+/// Integer, boolean & timestamp values are stored as 64 bit integers (bools
+/// as 0 or 1, timestamps as nanoseconds since the Unix epoch) & float values
+/// as doubles. String columns only track nulls as the text is already
+/// available in the table rows.
+///
+/// Values are indexed by table row. Fields which are null or can't be parsed
+/// as the column type are marked as null.
+///
+class ofxCsvColumn {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param type Column value type, default String.
+		ofxCsvColumn(ofxCsvSchema::Type type=ofxCsvSchema::String);
+
+	/// \section Data IO
+
+		/// Parse & append a field value.
+		///
+		/// \param field Field value.
+		/// \returns false if the value is null or couldn't be parsed
+		bool add(const string &field);
+
+		/// Append an integer value, for Int, Bool, & Timestamp columns.
+		void addInt(int64_t value);
+
+		/// Append a floating point value, for Float columns.
+		void addDouble(double value);
+
+		/// Append a null value.
+		void addNull();
+
+		/// Reserve storage for a given number of values.
+		void reserve(size_t size);
+
+		/// Clear all values.
+		void clear();
+
+	/// \section Get Values
+
+		/// Get the column value type.
+		ofxCsvSchema::Type getType() const;
+
+		/// Get the number of values.
+		size_t size() const;
+
+		/// Is a value null?
+		bool isNull(size_t row) const;
+
+		/// Get a value as an integer.
+		///
+		/// Float values are truncated.
+		///
+		/// \returns the value or 0 if null or a string.
+		int64_t getInt(size_t row) const;
+
+		/// Get a value as a double.
+		///
+		/// \returns the value or 0.0 if null or a string.
+		double getDouble(size_t row) const;
+
+		/// Get a value as a boolean.
+		///
+		/// \returns true if the value is non-zero.
+		bool getBool(size_t row) const;
+
+		/// Get the raw integer values, used by Int, Bool, & Timestamp columns.
+		const vector<int64_t>& getInts() const;
+
+		/// Get the raw double values, used by Float columns.
+		const vector<double>& getDoubles() const;
+
+		/// Get the value validity flags, 1 for a value & 0 for null.
+		const vector<uint8_t>& getValid() const;
+
+	/// \section Util
+
+		/// Parse a whole field as a 64 bit integer.
+		/// \returns true on success
+		static bool parseInt(const string &field, int64_t &value);
+
+		/// Parse a whole field as a decimal floating point number.
+		/// \returns true on success
+		static bool parseFloat(const string &field, double &value);
+
+		/// Parse a whole field as a boolean: true or false (case insensitive).
+		/// \returns true on success
+		static bool parseBool(const string &field, bool &value);
+
+		/// Parse a whole field as an ISO-8601 timestamp.
+		///
+		/// Accepts a date with optional time, fractional seconds, & UTC offset:
+		/// 2019-05-15, 2019-05-15 12:00, 2019-05-15T12:00:01.250Z, or
+		/// 2019-05-15T12:00:01+02:00.
+		///
+		/// \param value Set to nanoseconds since the Unix epoch.
+		/// \returns true on success
+		/// \see ofxCsvTimestamp
+		static bool parseTimestamp(const string &field, int64_t &value);
+
+	protected:
+
+		ofxCsvSchema::Type type; //< value type
+		vector<int64_t> ints;    //< Int, Bool, & Timestamp values
+		vector<double> doubles;  //< Float values
+		vector<uint8_t> valid;   //< 1 if value exists, 0 if null
+};
@@ -0,0 +1,303 @@
+/**
+ *  ofxCsvDecoder.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvDecoder.h"
+#include "ofxCsvSimd.h"
+
+/// Unicode replacement character for invalid UTF-16
+static const uint32_t s_replacement = 0xFFFD;
+
+//--------------------------------------------------
+ofxCsvDecoder::ofxCsvDecoder(ofxCsvEncoding encoding) {
+	reset(encoding);
+}
+
+//--------------------------------------------------
+void ofxCsvDecoder::reset(ofxCsvEncoding encoding) {
+	this->encoding = encoding;
+	bom = false;
+	pendingByte = -1;
+	pendingHigh = 0;
+	pendingCount = 0;
+	pendingLow = 0x80;
+	pendingHighest = 0xBF;
+	sequenceStart = 0;
+	position = 0;
+	numInvalid = 0;
+	firstInvalid = 0;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::detect(const char *text, size_t size) {
+	const uint8_t *bytes = (const uint8_t *)text;
+	bom = true;
+	if(size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF &&
+	   (encoding == ofxCsvEncoding::Auto || encoding == ofxCsvEncoding::Utf8)) {
+		encoding = ofxCsvEncoding::Utf8;
+		return 3;
+	}
+	if(size >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE &&
+	   (encoding == ofxCsvEncoding::Auto || encoding == ofxCsvEncoding::Utf16LE)) {
+		encoding = ofxCsvEncoding::Utf16LE;
+		return 2;
+	}
+	if(size >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF &&
+	   (encoding == ofxCsvEncoding::Auto || encoding == ofxCsvEncoding::Utf16BE)) {
+		encoding = ofxCsvEncoding::Utf16BE;
+		return 2;
+	}
+	bom = false;
+	if(encoding == ofxCsvEncoding::Auto) {
+		// no byte order mark, but ASCII UTF-16 has every other byte zero
+		if(size >= 4 && bytes[0] && !bytes[1] && bytes[2] && !bytes[3]) {
+			encoding = ofxCsvEncoding::Utf16LE;
+		}
+		else if(size >= 4 && !bytes[0] && bytes[1] && !bytes[2] && bytes[3]) {
+			encoding = ofxCsvEncoding::Utf16BE;
+		}
+		else {
+			encoding = ofxCsvEncoding::Utf8;
+		}
+	}
+	return 0;
+}
+
+//--------------------------------------------------
+ofxCsvEncoding ofxCsvDecoder::getEncoding() const {
+	return encoding;
+}
+
+//--------------------------------------------------
+bool ofxCsvDecoder::isUtf16() const {
+	return encoding == ofxCsvEncoding::Utf16LE || encoding == ofxCsvEncoding::Utf16BE;
+}
+
+//--------------------------------------------------
+bool ofxCsvDecoder::hasByteOrderMark() const {
+	return bom;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::transcode(const char *text, size_t size, char *out) {
+	const bool bigEndian = (encoding == ofxCsvEncoding::Utf16BE);
+	size_t len = 0;
+	auto put = [&](uint16_t unit) {
+		if(pendingHigh) {
+			if(unit >= 0xDC00 && unit <= 0xDFFF) {
+				len += encode(0x10000 + ((pendingHigh - 0xD800) << 10) + (unit - 0xDC00), out + len);
+				pendingHigh = 0;
+				return;
+			}
+			// unpaired high surrogate
+			invalid(position + len);
+			len += encode(s_replacement, out + len);
+			pendingHigh = 0;
+		}
+		if(unit >= 0xD800 && unit <= 0xDBFF) {
+			pendingHigh = unit;
+		}
+		else if(unit >= 0xDC00 && unit <= 0xDFFF) { // unpaired low surrogate
+			invalid(position + len);
+			len += encode(s_replacement, out + len);
+		}
+		else {
+			len += encode(unit, out + len);
+		}
+	};
+	auto unitAt = [bigEndian](uint8_t first, uint8_t second) {
+		return (uint16_t)(bigEndian ? (first << 8 | second) : (second << 8 | first));
+	};
+
+	size_t i = 0;
+	if(pendingByte >= 0 && size > 0) { // unit split across blocks
+		put(unitAt((uint8_t)pendingByte, (uint8_t)text[0]));
+		pendingByte = -1;
+		i = 1;
+	}
+	while(i + 1 < size) {
+		if(!pendingHigh) {
+			size_t n = ofxCsvSimd::narrowAscii(text + i, (size - i) / 2, bigEndian, out + len);
+			i += n * 2;
+			len += n;
+			if(i + 1 >= size) {
+				break;
+			}
+		}
+		put(unitAt((uint8_t)text[i], (uint8_t)text[i + 1]));
+		i += 2;
+	}
+	if(i < size) {
+		pendingByte = (uint8_t)text[i];
+	}
+	position += len;
+	return len;
+}
+
+//--------------------------------------------------
+void ofxCsvDecoder::validate(const char *text, size_t size) {
+	size_t i = 0;
+	while(i < size) {
+		uint8_t c;
+		if(pendingCount == 0) {
+			i += ofxCsvSimd::findNonAscii(text + i, size - i);
+			if(i >= size) {
+				break;
+			}
+			// lead byte, the valid ranges for the next byte exclude overlong
+			// forms, surrogates, & code points above U+10FFFF
+			c = text[i];
+			if(c < 0xC2 || c > 0xF4) {
+				invalid(position + i);
+				i++;
+				continue;
+			}
+			if(c < 0xE0) {
+				pendingCount = 1;
+			}
+			else if(c < 0xF0) {
+				pendingCount = 2;
+				pendingLow = (c == 0xE0 ? 0xA0 : 0x80);
+				pendingHighest = (c == 0xED ? 0x9F : 0xBF);
+			}
+			else {
+				pendingCount = 3;
+				pendingLow = (c == 0xF0 ? 0x90 : 0x80);
+				pendingHighest = (c == 0xF4 ? 0x8F : 0xBF);
+			}
+			sequenceStart = position + i;
+			i++;
+		}
+		else {
+			c = text[i];
+			if(c < pendingLow || c > pendingHighest) {
+				// truncated sequence, check this byte again as a lead byte
+				invalid(sequenceStart);
+				pendingCount = 0;
+			}
+			else {
+				pendingCount--;
+				i++;
+			}
+			pendingLow = 0x80;
+			pendingHighest = 0xBF;
+		}
+	}
+	position += size;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::finish(char *out) {
+	size_t len = 0;
+	if(pendingByte >= 0) {
+		pendingByte = -1;
+		if(pendingHigh) {
+			invalid(position);
+			len += encode(s_replacement, out + len);
+			pendingHigh = 0;
+		}
+		invalid(position + len);
+		len += encode(s_replacement, out + len);
+	}
+	else if(pendingHigh) {
+		invalid(position);
+		len += encode(s_replacement, out + len);
+		pendingHigh = 0;
+	}
+	if(pendingCount > 0) {
+		invalid(sequenceStart);
+		pendingCount = 0;
+	}
+	position += len;
+	return len;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::getNumInvalid() const {
+	return numInvalid;
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvDecoder::getFirstInvalid() const {
+	return firstInvalid;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::getMaxTranscodedSize(size_t size) {
+	// up to 3 bytes per unit, plus a replaced unpaired surrogate
+	return (size + 1) / 2 * 3 + 3;
+}
+
+//--------------------------------------------------
+string ofxCsvDecoder::getName(ofxCsvEncoding encoding) {
+	switch(encoding) {
+		case ofxCsvEncoding::Utf8:
+			return "UTF-8";
+		case ofxCsvEncoding::Utf16LE:
+			return "UTF-16LE";
+		case ofxCsvEncoding::Utf16BE:
+			return "UTF-16BE";
+		default:
+			return "auto";
+	}
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+void ofxCsvDecoder::invalid(uint64_t offset) {
+	if(numInvalid == 0) {
+		firstInvalid = offset;
+	}
+	numInvalid++;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDecoder::encode(uint32_t codePoint, char *out) {
+	if(codePoint < 0x80) {
+		out[0] = (char)codePoint;
+		return 1;
+	}
+	if(codePoint < 0x800) {
+		out[0] = (char)(0xC0 | (codePoint >> 6));
+		out[1] = (char)(0x80 | (codePoint & 0x3F));
+		return 2;
+	}
+	if(codePoint < 0x10000) {
+		out[0] = (char)(0xE0 | (codePoint >> 12));
+		out[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (codePoint & 0x3F));
+		return 3;
+	}
+	out[0] = (char)(0xF0 | (codePoint >> 18));
+	out[1] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (codePoint & 0x3F));
+	return 4;
+}
@@ -0,0 +1,151 @@
+/**
+ *  ofxCsvDecoder.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+/// text encodings
+enum class ofxCsvEncoding {
+	Auto,    //< detect by byte order mark, UTF-8 if there is none
+	Utf8,    //< UTF-8, with or without a byte order mark
+	Utf16LE, //< UTF-16 little endian, ie. Excel "Unicode Text"
+	Utf16BE  //< UTF-16 big endian
+};
+
+/// \class ofxCsvDecoder
+/// \brief streaming text decoder: byte order marks, UTF-16 to UTF-8, & UTF-8
+///        validation
+///
+/// Text is passed through in blocks. Sequences split across blocks are
+/// continued by the next block, so the blocks can be any size:
+///
+///     ofxCsvDecoder decoder;
+///     size_t skip = decoder.detect(first, size); // skip the byte order mark
+///     if(decoder.isUtf16()) {
+///         size_t len = decoder.transcode(block, size, utf8);
+///     }
+///     else {
+///         decoder.validate(block, size);
+///     }
+///     ...
+///     decoder.finish(utf8); // at the end of the text
+///
+/// ASCII runs are checked & converted 16 bytes at a time with ofxCsvSimd.
+/// Invalid UTF-8 is counted but left as is, invalid UTF-16 is replaced with
+/// U+FFFD.
+///
+class ofxCsvDecoder {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param encoding Text encoding, default detects by byte order mark.
+		ofxCsvDecoder(ofxCsvEncoding encoding=ofxCsvEncoding::Auto);
+
+		/// Restart decoding a new text.
+		///
+		/// \param encoding Text encoding, default detects by byte order mark.
+		void reset(ofxCsvEncoding encoding=ofxCsvEncoding::Auto);
+
+		/// Detect the encoding from the start of the text.
+		///
+		/// Looks for a UTF-8 or UTF-16 byte order mark, or ASCII characters
+		/// interleaved with zero bytes for UTF-16 without one. Call once
+		/// with at least the first 4 bytes, if the text is that long.
+		///
+		/// \param text Start of the text.
+		/// \param size Text size in bytes.
+		/// \returns size of the byte order mark to skip, 0 if there is none
+		size_t detect(const char *text, size_t size);
+
+		/// Get the text encoding, Auto until detected.
+		ofxCsvEncoding getEncoding() const;
+
+		/// Does the text need transcoding to UTF-8?
+		bool isUtf16() const;
+
+		/// Did the text start with a byte order mark?
+		bool hasByteOrderMark() const;
+
+		/// Transcode UTF-16 to UTF-8.
+		///
+		/// \param text UTF-16 text.
+		/// \param size Text size in bytes, need not be even.
+		/// \param out Destination, must hold getMaxTranscodedSize(size) bytes.
+		/// \returns number of UTF-8 bytes written
+		size_t transcode(const char *text, size_t size, char *out);
+
+		/// Validate UTF-8 text.
+		///
+		/// \param text UTF-8 text.
+		/// \param size Text size in bytes.
+		void validate(const char *text, size_t size);
+
+		/// Finish the text, unfinished sequences are invalid.
+		///
+		/// \param out Destination for any replacement characters, must hold 6
+		///            bytes.
+		/// \returns number of UTF-8 bytes written
+		size_t finish(char *out);
+
+		/// Get the number of invalid sequences found.
+		size_t getNumInvalid() const;
+
+		/// Get the decoded UTF-8 byte offset of the first invalid sequence.
+		uint64_t getFirstInvalid() const;
+
+		/// Get the largest possible transcoded size for a UTF-16 block.
+		static size_t getMaxTranscodedSize(size_t size);
+
+		/// Get the name of an encoding, ie. "UTF-16LE".
+		static string getName(ofxCsvEncoding encoding);
+
+	protected:
+
+		/// count an invalid sequence at a decoded offset
+		void invalid(uint64_t offset);
+
+		/// write a code point as UTF-8
+		static size_t encode(uint32_t codePoint, char *out);
+
+		ofxCsvEncoding encoding; //< text encoding
+		bool bom;                //< was there a byte order mark?
+		int pendingByte;         //< first byte of a split UTF-16 unit, or -1
+		uint32_t pendingHigh;    //< high surrogate waiting for its pair, or 0
+		int pendingCount;        //< UTF-8 continuation bytes still expected
+		uint8_t pendingLow;      //< lowest valid next continuation byte
+		uint8_t pendingHighest;  //< highest valid next continuation byte
+		uint64_t sequenceStart;  //< offset of the current UTF-8 sequence
+		uint64_t position;       //< decoded UTF-8 bytes so far
+		size_t numInvalid;       //< number of invalid sequences
+		uint64_t firstInvalid;   //< offset of the first invalid sequence
+};
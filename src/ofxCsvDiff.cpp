@@ -0,0 +1,580 @@
+/**
+ *  ofxCsvDiff.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvDiff.h"
+#include "ofxCsv.h"
+#include "ofxCsvFileIndex.h"
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+#include "ofxCsvThreadPool.h"
+#include "ofxCsvWriter.h"
+
+#include <algorithm>
+#include <atomic>
+
+// lines hashed in parallel at a time while partitioning
+static const size_t s_batchSize = 65536;
+
+// max partition files, all are open while partitioning a file so this
+// stays well below the default limit of 256 open files on macOS
+static const size_t s_maxPartitions = 128;
+
+// write buffer per partition file
+static const size_t s_partitionBuffer = 64*1024;
+
+// estimated memory per byte of row text once parsed & hashed
+static const size_t s_memoryFactor = 3;
+
+// number of fields up to the last non-empty field
+static size_t numFields(const vector<string> &fields) {
+	size_t size = fields.size();
+	while(size > 0 && fields[size-1].empty()) {
+		size--;
+	}
+	return size;
+}
+
+// field value, empty if missing
+static const string& getField(const vector<string> &fields, size_t col) {
+	static const string s_empty;
+	return (col < fields.size() ? fields[col] : s_empty);
+}
+
+// row fields, empty if missing
+static const vector<string>& getRowFields(const vector<ofxCsvRow> &rows, size_t row) {
+	static const vector<string> s_empty;
+	return (row < rows.size() ? rows[row].getData() : s_empty);
+}
+
+// mix a field hash into a row hash
+static uint64_t combine(uint64_t h, const string &field) {
+	h = (h ^ ofxCsvFileIndex::hash(field.data(), field.size())) * 0x9E3779B97F4A7C15ULL;
+	return h ^ (h >> 32);
+}
+
+//--------------------------------------------------
+ofxCsvDiff::ofxCsvDiff(const vector<int> &keyCols) :
+	keyCols(keyCols), memoryBudget(256*1024*1024), separator(","), commentPrefix("#"),
+	numAdded(0), numRemoved(0), numChanged(0), numUnchanged(0), numPartitions(0),
+	partitionCounter(0) {}
+
+//--------------------------------------------------
+void ofxCsvDiff::setKey(const vector<int> &keyCols) {
+	this->keyCols = keyCols;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::setMemoryBudget(size_t bytes) {
+	memoryBudget = std::max<size_t>(bytes, 1024*1024);
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::setTempDirectory(const string &directory) {
+	tempDirectory = directory;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::setSeparator(const string &separator) {
+	this->separator = separator;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::setCommentPrefix(const string &comment) {
+	commentPrefix = comment;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::setCallback(std::function<void(const ofxCsvDifference &difference)> callback) {
+	this->callback = callback;
+}
+
+// COMPARING
+
+//--------------------------------------------------
+bool ofxCsvDiff::compare(const ofxCsv &oldTable, const ofxCsv &newTable, bool header) {
+	reset();
+	compareData(oldTable.getData(), newTable.getData(), header);
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::compareFiles(const string &oldPath, const string &newPath, bool header) {
+	reset();
+	string absoluteOld = ofxCsvFileUtils::toDataPath(oldPath);
+	string absoluteNew = ofxCsvFileUtils::toDataPath(newPath);
+	for(auto &path : {absoluteOld, absoluteNew}) {
+		if(!ofxCsvFileUtils::canRead(path)) {
+			OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": couldn't read file";
+			return false;
+		}
+	}
+
+	// compressed files are assumed to expand about 4 times
+	uint64_t estimate = 0;
+	for(auto &path : {absoluteOld, absoluteNew}) {
+		bool compressed = (ofxCsvReader::detectCompression(path) != ofxCsvCompression::None);
+		estimate += ofxCsvFileUtils::getSize(path) * (compressed ? 4 : 1) * s_memoryFactor;
+	}
+
+	// small enough to compare in memory
+	if(estimate <= memoryBudget) {
+		vector<ofxCsvRow> oldRows, newRows;
+		if(!readRows(absoluteOld, oldRows) || !readRows(absoluteNew, newRows)) {
+			return false;
+		}
+		compareData(oldRows, newRows, header);
+		return true;
+	}
+	return comparePartitioned(absoluteOld, absoluteNew, header, estimate);
+}
+
+// RESULTS
+
+//--------------------------------------------------
+const vector<ofxCsvDifference>& ofxCsvDiff::getDifferences() const {
+	return differences;
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::isEqual() const {
+	return numAdded == 0 && numRemoved == 0 && numChanged == 0;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDiff::getNumAdded() const {
+	return numAdded;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDiff::getNumRemoved() const {
+	return numRemoved;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDiff::getNumChanged() const {
+	return numChanged;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDiff::getNumUnchanged() const {
+	return numUnchanged;
+}
+
+//--------------------------------------------------
+size_t ofxCsvDiff::getNumPartitions() const {
+	return numPartitions;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+void ofxCsvDiff::reset() {
+	differences.clear();
+	numAdded = 0;
+	numRemoved = 0;
+	numChanged = 0;
+	numUnchanged = 0;
+	numPartitions = 0;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::compareData(const vector<ofxCsvRow> &oldRows, const vector<ofxCsvRow> &newRows, bool header) {
+	size_t oldFirst = (header && !oldRows.empty() ? 1 : 0);
+	size_t newFirst = (header && !newRows.empty() ? 1 : 0);
+	if(header) {
+		Result result;
+		compareRows(getRowFields(oldRows, 0), getRowFields(newRows, 0), 0, 0, result);
+		addResult(result);
+	}
+
+	// hash all rows in parallel
+	vector<Entry> oldEntries(oldRows.size() - oldFirst);
+	vector<Entry> newEntries(newRows.size() - newFirst);
+	auto hashRows = [&](const vector<ofxCsvRow> &rows, size_t first, vector<Entry> &entries) {
+		ofxCsvThreadPool::shared().parallelFor(0, entries.size(), 16384, [&](size_t begin, size_t end) {
+			for(size_t i = begin; i < end; i++) {
+				entries[i].row = entries[i].index = first + i;
+				hashRow(rows[first + i].getData(), entries[i]);
+			}
+		});
+	};
+	hashRows(oldRows, oldFirst, oldEntries);
+	hashRows(newRows, newFirst, newEntries);
+
+	// split by key hash & match the partitions in parallel
+	size_t numParts = ofxCsvThreadPool::shared().getNumThreads() * 8;
+	vector<vector<Entry>> oldParts(numParts), newParts(numParts);
+	for(auto &entry : oldEntries) {
+		oldParts[entry.key % numParts].push_back(entry);
+	}
+	for(auto &entry : newEntries) {
+		newParts[entry.key % numParts].push_back(entry);
+	}
+	vector<Entry>().swap(oldEntries);
+	vector<Entry>().swap(newEntries);
+	ofxCsvThreadPool::shared().parallelFor(0, numParts, 1, [&](size_t begin, size_t end) {
+		for(size_t p = begin; p < end; p++) {
+			Result result;
+			match(oldParts[p], newParts[p], oldRows, newRows, result);
+			addResult(result);
+		}
+	});
+	finish();
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::comparePartitioned(const string &absoluteOld, const string &absoluteNew,
+                                    bool header, uint64_t estimate) {
+	// split both files into partitions small enough to compare a few at a
+	// time, rows with the same key end up in the same partition
+	size_t threads = ofxCsvThreadPool::shared().getNumThreads();
+	numPartitions = (estimate + memoryBudget - 1) / memoryBudget * threads;
+	numPartitions = std::min(std::max(numPartitions, threads), s_maxPartitions);
+	string tempName = ofxCsvFileUtils::getFileName(absoluteNew);
+	string tempBase = (tempDirectory.empty() ? ofxCsvFileUtils::getEnclosingDirectory(absoluteNew) :
+	                   ofxCsvFileUtils::toDataPath(tempDirectory));
+	vector<string> oldParts, newParts;
+	vector<string> oldHeader, newHeader;
+	auto cleanup = [&]() {
+		for(auto &path : oldParts) {
+			remove(path.c_str());
+		}
+		for(auto &path : newParts) {
+			remove(path.c_str());
+		}
+	};
+	if(!partition(absoluteOld, header, numPartitions, ofxCsvFileUtils::join(tempBase, tempName), oldParts, oldHeader) ||
+	   !partition(absoluteNew, header, numPartitions, ofxCsvFileUtils::join(tempBase, tempName), newParts, newHeader)) {
+		cleanup();
+		return false;
+	}
+	OFX_CSV_LOG_VERBOSE << "Comparing " << absoluteOld << " & " << absoluteNew << " in " << numPartitions << " partitions";
+	if(header) {
+		Result result;
+		compareRows(oldHeader, newHeader, 0, 0, result);
+		addResult(result);
+	}
+
+	// compare as many partitions at once as fit the memory budget, in waves
+	// when very large files need more partitions than the cap allows
+	uint64_t partitionSize = std::max<uint64_t>(estimate / numPartitions, 1);
+	size_t concurrent = (size_t)std::min<uint64_t>(std::max<uint64_t>(memoryBudget / partitionSize, 1), threads);
+	std::atomic<bool> error(false);
+	for(size_t wave = 0; wave < numPartitions && !error; wave += concurrent) {
+		size_t waveEnd = std::min(wave + concurrent, numPartitions);
+		ofxCsvThreadPool::shared().parallelFor(wave, waveEnd, 1, [&](size_t begin, size_t end) {
+			for(size_t p = begin; p < end; p++) {
+				vector<ofxCsvRow> oldRows, newRows;
+				vector<Entry> oldEntries, newEntries;
+				if(!readPartition(oldParts[p], oldRows, oldEntries) ||
+				   !readPartition(newParts[p], newRows, newEntries)) {
+					error = true;
+					continue;
+				}
+				remove(oldParts[p].c_str());
+				remove(newParts[p].c_str());
+				Result result;
+				match(oldEntries, newEntries, oldRows, newRows, result);
+				addResult(result);
+			}
+		});
+	}
+	cleanup();
+	if(error) {
+		OFX_CSV_LOG_ERROR << "Cannot compare " << absoluteOld << " & " << absoluteNew << ": couldn't read temp files";
+		reset();
+		return false;
+	}
+	finish();
+	return true;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::hashRow(const vector<string> &fields, Entry &entry) const {
+	uint64_t hash = 0x243F6A8885A308D3ULL;
+	size_t size = numFields(fields);
+	for(size_t col = 0; col < size; col++) {
+		hash = combine(hash, fields[col]);
+	}
+	entry.hash = hash;
+	if(keyCols.empty()) {
+		entry.key = hash;
+		return;
+	}
+	uint64_t key = 0x13198A2E03707344ULL;
+	for(int col : keyCols) {
+		key = combine(key, getField(fields, col));
+	}
+	entry.key = key;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::compareRows(const vector<string> &oldFields, const vector<string> &newFields,
+                             size_t oldRow, size_t newRow, Result &result) const {
+	ofxCsvDifference difference;
+	size_t size = std::max(numFields(oldFields), numFields(newFields));
+	for(size_t col = 0; col < size; col++) {
+		if(getField(oldFields, col) != getField(newFields, col)) {
+			difference.columns.push_back(col);
+		}
+	}
+	if(difference.columns.empty()) {
+		result.unchanged++;
+		return;
+	}
+	difference.type = ofxCsvDifference::Changed;
+	difference.oldRow = oldRow;
+	difference.newRow = newRow;
+	difference.oldFields = oldFields;
+	difference.newFields = newFields;
+	result.differences.push_back(std::move(difference));
+	result.changed++;
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::match(vector<Entry> &oldEntries, vector<Entry> &newEntries,
+                       const vector<ofxCsvRow> &oldRows, const vector<ofxCsvRow> &newRows,
+                       Result &result) const {
+	// sort by key, then walk both sides & pair rows with equal keys in row order
+	auto byKey = [](const Entry &a, const Entry &b) {
+		return (a.key != b.key ? a.key < b.key : a.row < b.row);
+	};
+	std::sort(oldEntries.begin(), oldEntries.end(), byKey);
+	std::sort(newEntries.begin(), newEntries.end(), byKey);
+	auto removed = [&](const Entry &entry) {
+		ofxCsvDifference difference;
+		difference.type = ofxCsvDifference::Removed;
+		difference.oldRow = entry.row;
+		difference.oldFields = oldRows[entry.index].getData();
+		result.differences.push_back(std::move(difference));
+		result.removed++;
+	};
+	auto added = [&](const Entry &entry) {
+		ofxCsvDifference difference;
+		difference.type = ofxCsvDifference::Added;
+		difference.newRow = entry.row;
+		difference.newFields = newRows[entry.index].getData();
+		result.differences.push_back(std::move(difference));
+		result.added++;
+	};
+	size_t o = 0, n = 0;
+	while(o < oldEntries.size() && n < newEntries.size()) {
+		const Entry &oldEntry = oldEntries[o];
+		const Entry &newEntry = newEntries[n];
+		if(oldEntry.key < newEntry.key) {
+			removed(oldEntry);
+			o++;
+		}
+		else if(newEntry.key < oldEntry.key) {
+			added(newEntry);
+			n++;
+		}
+		else {
+			if(oldEntry.hash == newEntry.hash) {
+				result.unchanged++;
+			}
+			else {
+				compareRows(oldRows[oldEntry.index].getData(), newRows[newEntry.index].getData(),
+				            oldEntry.row, newEntry.row, result);
+			}
+			o++;
+			n++;
+		}
+	}
+	for(; o < oldEntries.size(); o++) {
+		removed(oldEntries[o]);
+	}
+	for(; n < newEntries.size(); n++) {
+		added(newEntries[n]);
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::addResult(Result &result) {
+	std::lock_guard<std::mutex> lock(mutex);
+	numAdded += result.added;
+	numRemoved += result.removed;
+	numChanged += result.changed;
+	numUnchanged += result.unchanged;
+	if(callback) {
+		for(auto &difference : result.differences) {
+			callback(difference);
+		}
+	}
+	else {
+		differences.insert(differences.end(), std::make_move_iterator(result.differences.begin()),
+		                   std::make_move_iterator(result.differences.end()));
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvDiff::finish() {
+	std::sort(differences.begin(), differences.end(), [](const ofxCsvDifference &a, const ofxCsvDifference &b) {
+		bool aRemoved = (a.type == ofxCsvDifference::Removed);
+		bool bRemoved = (b.type == ofxCsvDifference::Removed);
+		if(aRemoved != bRemoved) {
+			return aRemoved;
+		}
+		return (aRemoved ? a.oldRow < b.oldRow : a.newRow < b.newRow);
+	});
+	OFX_CSV_LOG_VERBOSE << "Compared: " << numAdded << " added, " << numRemoved << " removed, "
+	                    << numChanged << " changed, " << numUnchanged << " unchanged rows";
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::partition(const string &path, bool header, size_t numParts,
+                           const string &tempName, vector<string> &paths,
+                           vector<string> &headerFields) {
+	ofxCsvReader reader;
+	if(!reader.open(path)) {
+		OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": couldn't open file";
+		return false;
+	}
+	vector<std::unique_ptr<ofxCsvWriter>> writers;
+	for(size_t p = 0; p < numParts; p++) {
+		paths.push_back(getPartitionPath(tempName));
+		writers.emplace_back(new ofxCsvWriter(s_partitionBuffer));
+		if(!writers.back()->open(paths.back(), ofxCsvCompression::None)) {
+			OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": couldn't write temp file " << paths.back();
+			return false;
+		}
+	}
+
+	// key hashes are computed in parallel for batches of lines, then each
+	// line is written to its partition prefixed with its row number
+	vector<string> lines;
+	vector<size_t> parts;
+	size_t row = 0;
+	auto writeBatch = [&]() {
+		parts.resize(lines.size());
+		ofxCsvThreadPool::shared().parallelFor(0, lines.size(), 1024, [&](size_t begin, size_t end) {
+			for(size_t i = begin; i < end; i++) {
+				Entry entry;
+				hashRow(ofxCsvRow::fromString(lines[i], separator), entry);
+				parts[i] = entry.key % numParts;
+			}
+		});
+		string number;
+		for(size_t i = 0; i < lines.size(); i++) {
+			number = std::to_string(row++);
+			ofxCsvWriter &writer = *writers[parts[i]];
+			writer.write(number);
+			writer.write(separator);
+			writer.write(lines[i]);
+			writer.write("\n", 1);
+		}
+		lines.clear();
+	};
+	string line;
+	bool first = true;
+	while(reader.readLine(line)) {
+		if(line.empty() || (!commentPrefix.empty() && line.compare(0, commentPrefix.size(), commentPrefix) == 0)) {
+			continue;
+		}
+		if(header && first) {
+			headerFields = ofxCsvRow::fromString(line, separator);
+			first = false;
+			row++;
+			continue;
+		}
+		first = false;
+		lines.push_back(std::move(line));
+		line = string();
+		if(lines.size() >= s_batchSize) {
+			writeBatch();
+		}
+	}
+	writeBatch();
+	bool ok = !reader.hasError();
+	for(auto &writer : writers) {
+		ok = writer->close() && ok;
+	}
+	if(!ok) {
+		OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": couldn't partition file";
+	}
+	return ok;
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::readRows(const string &path, vector<ofxCsvRow> &rows) const {
+	ofxCsvReader reader;
+	if(!reader.open(path)) {
+		OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": couldn't open file";
+		return false;
+	}
+	vector<string> lines;
+	string line;
+	while(reader.readLine(line)) {
+		if(line.empty() || (!commentPrefix.empty() && line.compare(0, commentPrefix.size(), commentPrefix) == 0)) {
+			continue;
+		}
+		lines.push_back(std::move(line));
+		line = string();
+	}
+	if(reader.hasError()) {
+		OFX_CSV_LOG_ERROR << "Cannot compare " << path << ": read error";
+		return false;
+	}
+	rows.resize(lines.size());
+	ofxCsvThreadPool::shared().parallelFor(0, lines.size(), 4096, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			rows[i] = ofxCsvRow(ofxCsvRow::fromString(lines[i], separator));
+			string().swap(lines[i]);
+		}
+	});
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvDiff::readPartition(const string &path, vector<ofxCsvRow> &rows,
+                               vector<Entry> &entries) const {
+	ofxCsvReader reader;
+	reader.setEncoding(ofxCsvEncoding::Utf8);
+	if(!reader.open(path, ofxCsvCompression::None)) {
+		return false;
+	}
+	string line;
+	while(reader.readLine(line)) {
+		vector<string> fields = ofxCsvRow::fromString(line, separator);
+		Entry entry;
+		entry.row = std::stoull(fields[0]);
+		entry.index = rows.size();
+		fields.erase(fields.begin());
+		hashRow(fields, entry);
+		rows.emplace_back(std::move(fields));
+		entries.push_back(entry);
+	}
+	return !reader.hasError();
+}
+
+//--------------------------------------------------
+string ofxCsvDiff::getPartitionPath(const string &name) {
+	return name + ".part" + std::to_string(partitionCounter++) + ".tmp";
+}
@@ -0,0 +1,241 @@
+/**
+ *  ofxCsvDiff.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+#include <functional>
+#include <mutex>
+
+class ofxCsv;
+
+/// a row difference between two tables, see ofxCsvDiff
+struct ofxCsvDifference {
+
+	/// Difference type
+	enum Type {
+		Added,   //< row only in the new table
+		Removed, //< row only in the old table
+		Changed  //< row with the same key in both tables & different fields
+	};
+
+	Type type = Changed;      //< difference type
+	size_t oldRow = 0;        //< row number in the old table, for Removed & Changed
+	size_t newRow = 0;        //< row number in the new table, for Added & Changed
+	vector<int> columns;      //< changed column numbers, for Changed
+	vector<string> oldFields; //< old row fields, for Removed & Changed
+	vector<string> newFields; //< new row fields, for Added & Changed
+};
+
+/// \class ofxCsvDiff
+/// \brief hash based comparison of two tables or files
+///
+/// Rows are matched by the hash of their key columns & compared by the hash
+/// of all their fields, so tables of any order are compared in O(n). Rows
+/// are hashed & matched in parallel on the shared ofxCsvThreadPool:
+///
+///     ofxCsvDiff diff({0}); // rows are identified by column 0
+///     diff.compareFiles("export-monday.csv.gz", "export-tuesday.csv.gz", true);
+///     for(auto &difference : diff.getDifferences()) {
+///         // added, removed, or changed rows
+///     }
+///
+/// Rows with the same key are matched in row order. Without key columns,
+/// whole rows are matched, so a changed row is reported as removed & added.
+/// Trailing empty fields are ignored, so padded & unpadded rows are equal.
+///
+/// Files larger than the memory budget are split into partitions by key
+/// hash in temp files, which are then compared a few at a time. Like
+/// ofxCsv::load(), files are read line by line, so quoted fields can't
+/// contain newlines. Empty & comment lines are skipped & don't count as
+/// rows.
+///
+class ofxCsvDiff {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param keyCols Key column numbers, empty to match whole rows.
+		ofxCsvDiff(const vector<int> &keyCols=vector<int>());
+
+		/// Set the key column numbers, empty to match whole rows.
+		void setKey(const vector<int> &keyCols);
+
+		/// Set the approximate amount of memory used to compare files,
+		/// default 256 MB. Larger files are compared in partitions.
+		void setMemoryBudget(size_t bytes);
+
+		/// Set the directory for temp partition files, default is the new
+		/// file's directory. Needs free space for about the size of both
+		/// files, uncompressed.
+		void setTempDirectory(const string &directory);
+
+		/// Set the field separator for files, default ",".
+		void setSeparator(const string &separator);
+
+		/// Set the comment line prefix for files, default "#".
+		void setCommentPrefix(const string &comment);
+
+		/// Set a function to receive the differences instead of storing
+		/// them, ie. to write huge diffs to a file.
+		///
+		/// The function is called once per difference in no particular
+		/// order, one call at a time but possibly from other threads.
+		void setCallback(std::function<void(const ofxCsvDifference &difference)> callback);
+
+	/// \section Comparing
+
+		/// Compare two tables.
+		///
+		/// \param oldTable Previous table.
+		/// \param newTable Current table.
+		/// \param header Is the first row a header? If so, the headers are
+		///               compared with each other & never matched by key.
+		/// \returns true on success
+		bool compare(const ofxCsv &oldTable, const ofxCsv &newTable, bool header=false);
+
+		/// Compare two files.
+		///
+		/// Files may be compressed, detected by file extension.
+		///
+		/// \param oldPath Previous file path.
+		/// \param newPath Current file path.
+		/// \param header Is the first row a header? If so, the headers are
+		///               compared with each other & never matched by key.
+		/// \returns true on success, false if a file couldn't be read
+		bool compareFiles(const string &oldPath, const string &newPath, bool header=false);
+
+	/// \section Results
+
+		/// Get the differences found by the last comparison.
+		///
+		/// Removed rows come first in old row order, followed by changed &
+		/// added rows in new row order. Empty if a callback is set.
+		const vector<ofxCsvDifference>& getDifferences() const;
+
+		/// Were the tables equal in the last comparison?
+		bool isEqual() const;
+
+		/// Get the number of added rows.
+		size_t getNumAdded() const;
+
+		/// Get the number of removed rows.
+		size_t getNumRemoved() const;
+
+		/// Get the number of changed rows.
+		size_t getNumChanged() const;
+
+		/// Get the number of matched rows without changes.
+		size_t getNumUnchanged() const;
+
+		/// Get the number of partitions the last file comparison was split
+		/// into, 0 if it was compared in memory.
+		size_t getNumPartitions() const;
+
+	protected:
+
+		/// a row's hashes & position
+		struct Entry {
+			uint64_t key;  //< key column hash
+			uint64_t hash; //< all fields hash
+			size_t row;    //< row number in its table
+			size_t index;  //< index in the compared rows
+		};
+
+		/// differences & counts of a part of the comparison
+		struct Result {
+			vector<ofxCsvDifference> differences;
+			size_t added = 0;
+			size_t removed = 0;
+			size_t changed = 0;
+			size_t unchanged = 0;
+		};
+
+		/// clear the results of the last comparison
+		void reset();
+
+		/// compare rows in memory
+		void compareData(const vector<ofxCsvRow> &oldRows, const vector<ofxCsvRow> &newRows, bool header);
+
+		/// compare files larger than the memory budget in partitions
+		bool comparePartitioned(const string &absoluteOld, const string &absoluteNew,
+		                        bool header, uint64_t estimate);
+
+		/// hash the key & all fields of a row
+		void hashRow(const vector<string> &fields, Entry &entry) const;
+
+		/// compare two rows, adding a Changed difference if they differ
+		void compareRows(const vector<string> &oldFields, const vector<string> &newFields,
+		                 size_t oldRow, size_t newRow, Result &result) const;
+
+		/// match the rows of one partition by key
+		void match(vector<Entry> &oldEntries, vector<Entry> &newEntries,
+		           const vector<ofxCsvRow> &oldRows, const vector<ofxCsvRow> &newRows,
+		           Result &result) const;
+
+		/// add a partition's results, passing differences to the callback
+		void addResult(Result &result);
+
+		/// sort the stored differences & log the totals
+		void finish();
+
+		/// split a file into partition files by key hash
+		bool partition(const string &path, bool header, size_t numParts,
+		               const string &tempName, vector<string> &paths,
+		               vector<string> &headerFields);
+
+		/// read the rows of a file
+		bool readRows(const string &path, vector<ofxCsvRow> &rows) const;
+
+		/// read a partition file into rows & hashes
+		bool readPartition(const string &path, vector<ofxCsvRow> &rows,
+		                   vector<Entry> &entries) const;
+
+		/// get a new temp partition file path
+		string getPartitionPath(const string &name);
+
+		vector<int> keyCols;           //< key column numbers
+		size_t memoryBudget;           //< bytes for comparing files in memory
+		string tempDirectory;          //< temp partition directory
+		string separator;              //< field separator
+		string commentPrefix;          //< comment line prefix
+		std::function<void(const ofxCsvDifference &difference)> callback; //< optional difference function
+
+		vector<ofxCsvDifference> differences; //< stored differences
+		size_t numAdded;               //< added rows
+		size_t numRemoved;             //< removed rows
+		size_t numChanged;             //< changed rows
+		size_t numUnchanged;           //< unchanged rows
+		size_t numPartitions;          //< partitions of the last file comparison
+		size_t partitionCounter;       //< temp partition file counter
+		std::mutex mutex;              //< guards results while matching partitions
+};
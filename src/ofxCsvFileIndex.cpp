@@ -0,0 +1,207 @@
+/**
+ *  ofxCsvFileIndex.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvFileIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+// blocks end after a line whose hash has these bits clear, once they have
+// the minimum size, so about every 16th line past 1 kB, or at the maximum size
+static const size_t s_minBlockSize = 1024;
+static const size_t s_maxBlockSize = 64*1024;
+static const uint64_t s_boundaryMask = 0xF;
+
+//--------------------------------------------------
+void ofxCsvFileIndex::build(const char *text, size_t size, const string &comment) {
+	clear();
+	this->text = text;
+	Block block;
+	uint64_t blockHash = 0;
+	size_t blockSize = 0;
+	size_t pos = 0;
+	while(pos < size) {
+		const char *start = text + pos;
+		const char *newline = (const char *)memchr(start, '\n', size - pos);
+		size_t end = (newline ? newline - text : size);
+		size_t len = end - pos;
+		if(len > 0 && start[len-1] == '\r') {
+			len--;
+		}
+		uint64_t lineHash = hash(start, len);
+
+		// skip empty & comment lines like ofxCsv::load()
+		if(len > 0 && !(len >= comment.size() && memcmp(start, comment.data(), comment.size()) == 0)) {
+			rowHashes.push_back(lineHash);
+			lines.push_back({pos, len});
+			block.rows++;
+		}
+		blockHash = (blockHash ^ lineHash) * 0x9E3779B97F4A7C15ULL;
+		blockHash ^= blockHash >> 32;
+		blockSize += end - pos + 1;
+		pos = end + 1;
+
+		if((blockSize >= s_minBlockSize && (lineHash & s_boundaryMask) == 0) ||
+		   blockSize >= s_maxBlockSize || pos >= size) {
+			block.hash = blockHash;
+			blocks.push_back(block);
+			block.row = rowHashes.size();
+			block.rows = 0;
+			blockHash = 0;
+			blockSize = 0;
+		}
+	}
+}
+
+//--------------------------------------------------
+vector<ofxCsvChange> ofxCsvFileIndex::diff(const ofxCsvFileIndex &previous) const {
+	const vector<Block> &before = previous.blocks;
+	const vector<uint64_t> &beforeRows = previous.rowHashes;
+	std::unordered_map<uint64_t, vector<size_t>> positions;
+	for(size_t k = 0; k < before.size(); k++) {
+		positions[before[k].hash].push_back(k);
+	}
+
+	// narrow a differing region down to the changed rows
+	vector<ofxCsvChange> changes;
+	size_t oldStart = 0, newStart = 0;
+	auto addChange = [&](size_t oldEnd, size_t newEnd) {
+		while(oldStart < oldEnd && newStart < newEnd && beforeRows[oldStart] == rowHashes[newStart]) {
+			oldStart++;
+			newStart++;
+		}
+		while(oldEnd > oldStart && newEnd > newStart && beforeRows[oldEnd-1] == rowHashes[newEnd-1]) {
+			oldEnd--;
+			newEnd--;
+		}
+		if(oldEnd > oldStart || newEnd > newStart) {
+			ofxCsvChange change;
+			change.row = newStart;
+			change.removed = oldEnd - oldStart;
+			change.added = newEnd - newStart;
+			changes.push_back(change);
+		}
+	};
+
+	// walk both block lists, skipping previous blocks when a new block
+	// matches one further ahead & new blocks which don't match at all
+	size_t i = 0, j = 0;
+	bool differing = false;
+	while(i < blocks.size()) {
+		if(j < before.size() && before[j].hash == blocks[i].hash) {
+			if(differing) {
+				addChange(before[j].row, blocks[i].row);
+				differing = false;
+			}
+			i++;
+			j++;
+			continue;
+		}
+		if(!differing) {
+			differing = true;
+			oldStart = (j < before.size() ? before[j].row : beforeRows.size());
+			newStart = blocks[i].row;
+		}
+		size_t k = before.size();
+		auto found = positions.find(blocks[i].hash);
+		if(found != positions.end()) {
+			auto next = std::lower_bound(found->second.begin(), found->second.end(), j);
+			if(next != found->second.end()) {
+				k = *next;
+			}
+		}
+		if(k < before.size()) {
+			j = k;
+		}
+		else {
+			i++;
+		}
+	}
+	if(j < before.size() && !differing) {
+		differing = true;
+		oldStart = before[j].row;
+		newStart = rowHashes.size();
+	}
+	if(differing) {
+		addChange(beforeRows.size(), rowHashes.size());
+	}
+	return changes;
+}
+
+//--------------------------------------------------
+string ofxCsvFileIndex::getLine(size_t row) const {
+	if(!text || row >= lines.size()) {
+		return "";
+	}
+	return string(text + lines[row].offset, lines[row].size);
+}
+
+//--------------------------------------------------
+size_t ofxCsvFileIndex::getNumRows() const {
+	return rowHashes.size();
+}
+
+//--------------------------------------------------
+size_t ofxCsvFileIndex::getNumBlocks() const {
+	return blocks.size();
+}
+
+//--------------------------------------------------
+void ofxCsvFileIndex::releaseText() {
+	text = nullptr;
+	vector<Line>().swap(lines);
+}
+
+//--------------------------------------------------
+void ofxCsvFileIndex::clear() {
+	blocks.clear();
+	rowHashes.clear();
+	lines.clear();
+	text = nullptr;
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvFileIndex::hash(const char *data, size_t size) {
+	uint64_t h = 0x9E3779B97F4A7C15ULL ^ size;
+	while(size >= 8) {
+		uint64_t word;
+		memcpy(&word, data, 8);
+		h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+		h ^= h >> 31;
+		data += 8;
+		size -= 8;
+	}
+	uint64_t word = 0;
+	memcpy(&word, data, size);
+	h = (h ^ word) * 0x94D049BB133111EBULL;
+	h ^= h >> 29;
+	return h;
+}
@@ -0,0 +1,118 @@
+/**
+ *  ofxCsvFileIndex.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+/// a range of changed rows, see ofxCsv::update()
+///
+/// Rows [row, row+removed) of the previous table were replaced by rows
+/// [row, row+added) of the new table. Changes are in row order & row numbers
+/// already include the effect of any earlier changes.
+struct ofxCsvChange {
+	size_t row = 0;     //< first changed row in the new table
+	size_t removed = 0; //< number of previous rows replaced
+	size_t added = 0;   //< number of new rows
+};
+
+/// \class ofxCsvFileIndex
+/// \brief block & row content hashes of a CSV file, used for live reloading
+///
+/// The text is split into blocks of whole lines. Block boundaries are placed
+/// by line content rather than by offset, so inserting or removing lines
+/// only changes the blocks around the edit & the other blocks still match.
+/// Each data row also gets a hash so changed blocks can be narrowed down to
+/// the rows which actually changed.
+///
+/// Empty & comment lines are skipped like ofxCsv::load() but still count
+/// toward the block hashes.
+///
+class ofxCsvFileIndex {
+
+	public:
+
+		/// a run of whole lines
+		struct Block {
+			uint64_t hash = 0; //< content hash
+			size_t row = 0;    //< first data row in the block
+			size_t rows = 0;   //< number of data rows
+		};
+
+		/// Hash a file's text.
+		///
+		/// Keeps the row line positions so changed rows can be parsed from
+		/// the text, which must stay valid until the index is rebuilt.
+		///
+		/// \param text File text.
+		/// \param size Text size in bytes.
+		/// \param comment Comment line prefix.
+		void build(const char *text, size_t size, const string &comment);
+
+		/// Compare with a previous index of the same file.
+		///
+		/// Blocks are matched by hash first, then differing blocks are
+		/// narrowed down by comparing row hashes.
+		///
+		/// \param previous Index of the previous file contents.
+		/// \returns changed row ranges, empty if the rows are identical
+		vector<ofxCsvChange> diff(const ofxCsvFileIndex &previous) const;
+
+		/// Get the line text of a data row, without the newline.
+		string getLine(size_t row) const;
+
+		/// Get the number of data rows.
+		size_t getNumRows() const;
+
+		/// Get the number of blocks.
+		size_t getNumBlocks() const;
+
+		/// Forget the text positions, keeping only the hashes.
+		void releaseText();
+
+		/// Clear the index.
+		void clear();
+
+		/// Hash bytes, 8 at a time.
+		static uint64_t hash(const char *data, size_t size);
+
+	protected:
+
+		/// a data row line position
+		struct Line {
+			size_t offset; //< start of the line in the text
+			size_t size;   //< line size, without the newline or carriage return
+		};
+
+		vector<Block> blocks;       //< blocks in file order
+		vector<uint64_t> rowHashes; //< hash of each data row
+		vector<Line> lines;         //< data row line positions
+		const char *text = nullptr; //< indexed text
+};
@@ -0,0 +1,155 @@
+/**
+ *  ofxCsvFileUtils.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvFileUtils.h"
+
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+	#include <io.h>
+	#define access _access
+	#define R_OK 4
+	#define W_OK 2
+#else
+	#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// openFrameworks builds use the data folder, see ofxCsvOf.cpp
+#ifdef OFX_CSV_STANDALONE
+
+//--------------------------------------------------
+string ofxCsvFileUtils::toDataPath(const string &path) {
+	std::error_code error;
+	fs::path absolute = fs::absolute(fs::path(path), error);
+	return (error ? path : absolute.string());
+}
+
+#endif
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::exists(const string &path) {
+	std::error_code error;
+	return fs::exists(fs::path(path), error);
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::isDirectory(const string &path) {
+	std::error_code error;
+	return fs::is_directory(fs::path(path), error);
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::canRead(const string &path) {
+	return access(path.c_str(), R_OK) == 0;
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::canWrite(const string &path) {
+	return access(path.c_str(), W_OK) == 0;
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvFileUtils::getSize(const string &path) {
+	std::error_code error;
+	uintmax_t size = fs::file_size(fs::path(path), error);
+	return (error ? 0 : size);
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::createFile(const string &path) {
+	string directory = getEnclosingDirectory(path);
+	if(!directory.empty() && !createDirectory(directory)) {
+		return false;
+	}
+	FILE *file = fopen(path.c_str(), "ab");
+	if(!file) {
+		return false;
+	}
+	return fclose(file) == 0;
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::createDirectory(const string &path) {
+	std::error_code error;
+	fs::create_directories(fs::path(path), error);
+	return isDirectory(path);
+}
+
+//--------------------------------------------------
+vector<string> ofxCsvFileUtils::listDirectory(const string &path) {
+	vector<string> paths;
+	std::error_code error;
+	for(fs::directory_iterator it(fs::path(path), error), end; !error && it != end; it.increment(error)) {
+		paths.push_back(it->path().string());
+	}
+	return paths;
+}
+
+//--------------------------------------------------
+string ofxCsvFileUtils::getEnclosingDirectory(const string &path) {
+	return fs::path(path).parent_path().string();
+}
+
+//--------------------------------------------------
+string ofxCsvFileUtils::getFileName(const string &path) {
+	return fs::path(path).filename().string();
+}
+
+//--------------------------------------------------
+string ofxCsvFileUtils::join(const string &directory, const string &name) {
+	return (fs::path(directory) / name).string();
+}
+
+//--------------------------------------------------
+bool ofxCsvFileUtils::readFile(const string &path, string &text) {
+	text.clear();
+	FILE *file = fopen(path.c_str(), "rb");
+	if(!file) {
+		return false;
+	}
+	const size_t blockSize = 256 * 1024;
+	size_t size = 0;
+	text.reserve(getSize(path) + blockSize);
+	while(true) {
+		text.resize(size + blockSize);
+		size_t count = fread(&text[size], 1, blockSize, file);
+		size += count;
+		if(count < blockSize) {
+			break;
+		}
+	}
+	text.resize(size);
+	bool error = (ferror(file) != 0);
+	fclose(file);
+	return !error;
+}
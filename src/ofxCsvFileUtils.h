@@ -0,0 +1,94 @@
+/**
+ *  ofxCsvFileUtils.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+/// \class ofxCsvFileUtils
+/// \brief file system helpers using the standard library
+///
+/// Relative paths are resolved with toDataPath(): to the openFrameworks
+/// data folder, or the working directory in standalone builds.
+///
+class ofxCsvFileUtils {
+
+	public:
+
+		/// Get the absolute path for a file path.
+		///
+		/// \param path File path, relative to the data folder or absolute.
+		/// \returns absolute file path
+		static string toDataPath(const string &path);
+
+		/// Does a file or directory exist?
+		static bool exists(const string &path);
+
+		/// Is a path an existing directory?
+		static bool isDirectory(const string &path);
+
+		/// Can the current user read a file?
+		static bool canRead(const string &path);
+
+		/// Can the current user write a file?
+		static bool canWrite(const string &path);
+
+		/// Get a file's size in bytes, 0 if it doesn't exist.
+		static uint64_t getSize(const string &path);
+
+		/// Create an empty file, including any missing parent directories.
+		///
+		/// \returns true if the file was created
+		static bool createFile(const string &path);
+
+		/// Create a directory, including any missing parent directories.
+		///
+		/// \returns true if the directory exists afterwards
+		static bool createDirectory(const string &path);
+
+		/// Get the paths of the files & directories in a directory.
+		static vector<string> listDirectory(const string &path);
+
+		/// Get the directory of a path, ie. "data/files" for "data/files/a.csv".
+		static string getEnclosingDirectory(const string &path);
+
+		/// Get the file name of a path, ie. "a.csv" for "data/files/a.csv".
+		static string getFileName(const string &path);
+
+		/// Join a directory & a file name.
+		static string join(const string &directory, const string &name);
+
+		/// Read a whole file.
+		///
+		/// \param path Absolute file path.
+		/// \param text Set to the file contents.
+		/// \returns true if the file was read
+		static bool readFile(const string &path, string &text);
+};
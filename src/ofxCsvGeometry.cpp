@@ -0,0 +1,334 @@
+/**
+ *  ofxCsvGeometry.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+// openFrameworks geometry builders, not part of standalone builds
+// (OFX_CSV_STANDALONE)
+#ifndef OFX_CSV_STANDALONE
+
+#include "ofxCsvGeometry.h"
+#include "ofxCsv.h"
+#include "ofxCsvLog.h"
+
+// rows per parallel chunk
+static const size_t s_grainSize = 16384;
+
+//--------------------------------------------------
+ofxCsvGeometry::ofxCsvGeometry() {
+	colorScale = 1;
+	header = false;
+	parallel = true;
+	skipInvalid = true;
+}
+
+// COLUMNS
+
+//--------------------------------------------------
+void ofxCsvGeometry::setPosition(int x, int y, int z) {
+	int cols[] = {x, y, z};
+	for(int i = 0; i < 3; i++) {
+		position[i].index = cols[i];
+		position[i].name = "";
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setPosition(const string &x, const string &y, const string &z) {
+	const string *names[] = {&x, &y, &z};
+	for(int i = 0; i < 3; i++) {
+		position[i].index = -1;
+		position[i].name = *names[i];
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setColor(int r, int g, int b, int a) {
+	int cols[] = {r, g, b, a};
+	for(int i = 0; i < 4; i++) {
+		color[i].index = cols[i];
+		color[i].name = "";
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setColor(const string &r, const string &g, const string &b, const string &a) {
+	const string *names[] = {&r, &g, &b, &a};
+	for(int i = 0; i < 4; i++) {
+		color[i].index = -1;
+		color[i].name = *names[i];
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::clearColor() {
+	for(auto &column : color) {
+		column = Column();
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setColorScale(float scale) {
+	colorScale = scale;
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setHeader(bool header) {
+	this->header = header;
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setParallel(bool parallel) {
+	this->parallel = parallel;
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::setSkipInvalid(bool skip) {
+	skipInvalid = skip;
+}
+
+// BUILDING
+
+//--------------------------------------------------
+bool ofxCsvGeometry::buildMesh(const ofxCsv &csv, ofMesh &mesh) const {
+	bool colors = (color[0].index >= 0 || !color[0].name.empty());
+	if(!colors) {
+		mesh.getColors().clear();
+	}
+	return fill(csv, mesh.getVertices(), colors ? &mesh.getColors() : nullptr);
+}
+
+//--------------------------------------------------
+ofMesh ofxCsvGeometry::getMesh(const ofxCsv &csv) const {
+	ofMesh mesh;
+	mesh.setMode(OF_PRIMITIVE_POINTS);
+	buildMesh(csv, mesh);
+	return mesh;
+}
+
+//--------------------------------------------------
+bool ofxCsvGeometry::buildPolyline(const ofxCsv &csv, ofPolyline &polyline) const {
+	bool ok = fill(csv, polyline.getVertices(), nullptr);
+	polyline.flagHasChanged();
+	return ok;
+}
+
+//--------------------------------------------------
+ofPolyline ofxCsvGeometry::getPolyline(const ofxCsv &csv) const {
+	ofPolyline polyline;
+	buildPolyline(csv, polyline);
+	return polyline;
+}
+
+//--------------------------------------------------
+bool ofxCsvGeometry::buildPixels(const ofxCsv &csv, ofFloatPixels &pixels,
+                                 int firstCol, int numCols) const {
+	const vector<ofxCsvRow> &data = csv.getData();
+	size_t first = (header && !data.empty() ? 1 : 0);
+	firstCol = max(firstCol, 0);
+	if(numCols <= 0) {
+		numCols = 0;
+		for(size_t row = first; row < data.size(); row++) {
+			numCols = max(numCols, (int)data[row].size() - firstCol);
+		}
+	}
+	size_t width = max(numCols, 0);
+	size_t height = data.size() - first;
+	if(width == 0 || height == 0) {
+		pixels.clear();
+		return false;
+	}
+	pixels.allocate(width, height, 1);
+
+	// use numeric typed columns as is
+	vector<Source> sources(width);
+	for(size_t x = 0; x < width; x++) {
+		Column column;
+		column.index = firstCol + x;
+		resolve(csv, column, sources[x]);
+	}
+
+	float *values = pixels.getData();
+	forRows(first, data.size(), [&](size_t begin, size_t end) {
+		for(size_t row = begin; row < end; row++) {
+			float *line = values + (row - first) * width;
+			for(size_t x = 0; x < width; x++) {
+				if(!getValue(csv, sources[x], row, line[x])) {
+					line[x] = 0;
+				}
+			}
+		}
+	});
+	return true;
+}
+
+//--------------------------------------------------
+ofFloatPixels ofxCsvGeometry::getPixels(const ofxCsv &csv, int firstCol, int numCols) const {
+	ofFloatPixels pixels;
+	buildPixels(csv, pixels, firstCol, numCols);
+	return pixels;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+bool ofxCsvGeometry::resolve(const ofxCsv &csv, const Column &column, Source &source) const {
+	source = Source();
+	if(!column.name.empty()) {
+		source.index = csv.getColumnIndex(column.name, header);
+		if(source.index < 0) {
+			OFX_CSV_LOG_ERROR << "Couldn't find column \"" << column.name << "\"";
+			return false;
+		}
+	}
+	else {
+		source.index = column.index;
+	}
+	if(source.index >= 0) {
+		const ofxCsvColumn &typed = csv.getColumn(source.index);
+		if(typed.getType() != ofxCsvSchema::String && typed.size() == csv.getData().size()) {
+			source.typed = &typed;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvGeometry::getValue(const ofxCsv &csv, const Source &source, size_t row, float &value) {
+	if(source.typed) {
+		if(source.typed->isNull(row)) {
+			return false;
+		}
+		value = source.typed->getDouble(row);
+		return true;
+	}
+	const vector<string> &fields = csv.getData()[row].getData();
+	double parsed;
+	if(source.index < 0 || (size_t)source.index >= fields.size() ||
+	   !ofxCsvColumn::parseFloat(fields[source.index], parsed)) {
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvGeometry::fill(const ofxCsv &csv, vector<ofDefaultVertexType> &vertices,
+                          vector<ofDefaultColorType> *colors) const {
+	vertices.clear();
+	if(colors) {
+		colors->clear();
+	}
+	Source positionSources[3], colorSources[4];
+	for(int i = 0; i < 3; i++) {
+		if(!resolve(csv, position[i], positionSources[i])) {
+			return false;
+		}
+	}
+	if(colors) {
+		for(int i = 0; i < 4; i++) {
+			if(!resolve(csv, color[i], colorSources[i])) {
+				return false;
+			}
+		}
+	}
+	if(positionSources[0].index < 0 || positionSources[1].index < 0) {
+		OFX_CSV_LOG_ERROR << "Position columns not set";
+		return false;
+	}
+
+	// convert into pre-sized arrays, marking invalid rows
+	const vector<ofxCsvRow> &data = csv.getData();
+	size_t first = (header && !data.empty() ? 1 : 0);
+	size_t count = data.size() - first;
+	vertices.resize(count);
+	if(colors) {
+		colors->resize(count);
+	}
+	vector<uint8_t> valid(skipInvalid ? count : 0);
+	forRows(first, data.size(), [&](size_t begin, size_t end) {
+		for(size_t row = begin; row < end; row++) {
+			size_t i = row - first;
+			float xyz[3] = {0, 0, 0};
+			bool ok = true;
+			for(int c = 0; c < 3; c++) {
+				if(positionSources[c].index >= 0 && !getValue(csv, positionSources[c], row, xyz[c])) {
+					xyz[c] = 0;
+					ok = false;
+				}
+			}
+			vertices[i] = ofDefaultVertexType(xyz[0], xyz[1], xyz[2]);
+			if(skipInvalid) {
+				valid[i] = ok;
+			}
+			if(colors) {
+				float rgba[4] = {0, 0, 0, 1};
+				for(int c = 0; c < 4; c++) {
+					if(colorSources[c].index >= 0) {
+						float value;
+						rgba[c] = (getValue(csv, colorSources[c], row, value) ? value * colorScale : 0);
+					}
+				}
+				(*colors)[i] = ofDefaultColorType(rgba[0], rgba[1], rgba[2], rgba[3]);
+			}
+		}
+	});
+
+	// drop invalid rows in order
+	if(skipInvalid && std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+		size_t kept = 0;
+		for(size_t i = 0; i < count; i++) {
+			if(valid[i]) {
+				vertices[kept] = vertices[i];
+				if(colors) {
+					(*colors)[kept] = (*colors)[i];
+				}
+				kept++;
+			}
+		}
+		vertices.resize(kept);
+		if(colors) {
+			colors->resize(kept);
+		}
+		OFX_CSV_LOG_VERBOSE << "Skipped " << (count - kept) << " rows with invalid positions";
+	}
+	return true;
+}
+
+//--------------------------------------------------
+void ofxCsvGeometry::forRows(size_t begin, size_t end,
+                             const std::function<void(size_t begin, size_t end)> &function) const {
+	if(parallel && end - begin > s_grainSize) {
+		ofxCsvThreadPool::shared().parallelFor(begin, end, s_grainSize, function);
+	}
+	else {
+		function(begin, end);
+	}
+}
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ *  ofxCsvGeometry.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+// openFrameworks geometry builders, not part of standalone builds
+// (OFX_CSV_STANDALONE)
+#ifndef OFX_CSV_STANDALONE
+
+#include "ofxCsvConstants.h"
+
+#include "ofMesh.h"
+#include "ofPolyline.h"
+#include "ofPixels.h"
+
+#include <functional>
+
+class ofxCsv;
+class ofxCsvColumn;
+
+/// \class ofxCsvGeometry
+/// \brief builds meshes, polylines, & float pixels directly from table columns
+///
+/// Columns are set once by number or by name, then each field is parsed a
+/// single time straight into pre-sized vertex, color, or pixel arrays,
+/// without copying rows. Numeric typed columns (see ofxCsv::setSchema()) are
+/// used without parsing. Large tables are converted in parallel on the
+/// shared ofxCsvThreadPool:
+///
+///     ofxCsvGeometry geometry;
+///     geometry.setHeader(true);
+///     geometry.setPosition("x", "y", "z");
+///     geometry.setColor("r", "g", "b");
+///     geometry.setColorScale(1.0 / 255.0);
+///     ofMesh cloud = geometry.getMesh(csv);
+///
+/// Rows with a missing or non-numeric position value are skipped by default.
+/// Missing color values are 0, or 1 for alpha.
+///
+class ofxCsvGeometry {
+
+	public:
+
+		/// Constructor.
+		ofxCsvGeometry();
+
+	/// \section Columns
+
+		/// Set the vertex position columns by number.
+		///
+		/// \param x X column number.
+		/// \param y Y column number.
+		/// \param z Z column number, -1 for z = 0. default -1
+		void setPosition(int x, int y, int z=-1);
+
+		/// Set the vertex position columns by name.
+		///
+		/// Names are resolved from the header row or the schema when
+		/// building, see ofxCsv::getColumnIndex().
+		///
+		/// \param z Z column name, empty for z = 0.
+		void setPosition(const string &x, const string &y, const string &z="");
+
+		/// Set the vertex color columns by number.
+		///
+		/// \param a Alpha column number, -1 for opaque colors. default -1
+		void setColor(int r, int g, int b, int a=-1);
+
+		/// Set the vertex color columns by name.
+		///
+		/// \param a Alpha column name, empty for opaque colors.
+		void setColor(const string &r, const string &g, const string &b, const string &a="");
+
+		/// Don't add vertex colors.
+		void clearColor();
+
+		/// Set the color value multiplier, ie. 1/255 for 0-255 values.
+		/// default 1
+		void setColorScale(float scale);
+
+		/// Is the first row a header? If so, it is skipped & used to resolve
+		/// column names. default false
+		void setHeader(bool header);
+
+		/// Convert rows in parallel on the shared thread pool? default true
+		void setParallel(bool parallel);
+
+		/// Skip rows with a missing or non-numeric position value? Otherwise
+		/// the value is 0. default true
+		void setSkipInvalid(bool skip);
+
+	/// \section Building
+
+		/// Replace the vertices & colors of a mesh with the table rows.
+		///
+		/// Other mesh data & the primitive mode are kept.
+		///
+		/// \param csv Table to read.
+		/// \param mesh Mesh to fill.
+		/// \returns false if a column name couldn't be resolved
+		bool buildMesh(const ofxCsv &csv, ofMesh &mesh) const;
+
+		/// Create a point mesh from the table rows.
+		ofMesh getMesh(const ofxCsv &csv) const;
+
+		/// Replace the points of a polyline with the table rows.
+		///
+		/// Color columns are ignored.
+		///
+		/// \param csv Table to read.
+		/// \param polyline Polyline to fill.
+		/// \returns false if a column name couldn't be resolved
+		bool buildPolyline(const ofxCsv &csv, ofPolyline &polyline) const;
+
+		/// Create a polyline from the table rows.
+		ofPolyline getPolyline(const ofxCsv &csv) const;
+
+		/// Fill single channel float pixels with a grid of values, one pixel
+		/// row per table row.
+		///
+		/// Position & color columns are ignored. Missing or non-numeric
+		/// values are 0.
+		///
+		/// \param csv Table to read.
+		/// \param pixels Pixels to allocate & fill.
+		/// \param firstCol First column of the grid. default 0
+		/// \param numCols Number of columns, 0 for all columns up to the
+		///                widest row. default 0
+		/// \returns false if the grid is empty
+		bool buildPixels(const ofxCsv &csv, ofFloatPixels &pixels,
+		                 int firstCol=0, int numCols=0) const;
+
+		/// Create single channel float pixels with a grid of values.
+		ofFloatPixels getPixels(const ofxCsv &csv, int firstCol=0, int numCols=0) const;
+
+	protected:
+
+		/// column set by number or name
+		struct Column {
+			int index = -1; //< column number, -1 if unset
+			string name;    //< column name, used if not empty
+		};
+
+		/// resolved column value source
+		struct Source {
+			int index = -1;                       //< column number, -1 if unset
+			const ofxCsvColumn *typed = nullptr; //< numeric typed column, if any
+		};
+
+		/// resolve a column to a value source, false if a name isn't found
+		bool resolve(const ofxCsv &csv, const Column &column, Source &source) const;
+
+		/// read a row value, false if missing or non-numeric
+		static bool getValue(const ofxCsv &csv, const Source &source, size_t row, float &value);
+
+		/// fill vertices & optional colors, false if a column name isn't found
+		bool fill(const ofxCsv &csv, vector<ofDefaultVertexType> &vertices,
+		          vector<ofDefaultColorType> *colors) const;
+
+		/// run a function over a row range, in parallel if enabled
+		void forRows(size_t begin, size_t end, const std::function<void(size_t begin, size_t end)> &function) const;
+
+		Column position[3]; //< x, y, z columns
+		Column color[4];    //< r, g, b, a columns
+		float colorScale;   //< color value multiplier
+		bool header;        //< is the first row a header?
+		bool parallel;      //< convert rows in parallel?
+		bool skipInvalid;   //< skip rows with invalid positions?
+};
+
+#endif
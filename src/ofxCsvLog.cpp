@@ -0,0 +1,85 @@
+/**
+ *  ofxCsvLog.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvLog.h"
+
+#include <cstdio>
+#include <mutex>
+
+std::atomic<int> ofxCsvLog::s_level((int)ofxCsvLogLevel::Notice);
+
+/// current handler, guarded as messages can come from any thread
+static std::mutex s_handlerMutex;
+static ofxCsvLog::Handler s_handler;
+
+//--------------------------------------------------
+ofxCsvLog::ofxCsvLog(ofxCsvLogLevel level) : level(level) {}
+
+//--------------------------------------------------
+ofxCsvLog::~ofxCsvLog() {
+	Handler handler;
+	{
+		std::lock_guard<std::mutex> lock(s_handlerMutex);
+		handler = s_handler;
+	}
+	if(handler) {
+		handler(level, message.str());
+	}
+	else {
+		defaultHandler(level, message.str());
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvLog::setLevel(ofxCsvLogLevel level) {
+	s_level.store((int)level, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------
+ofxCsvLogLevel ofxCsvLog::getLevel() {
+	return (ofxCsvLogLevel)s_level.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------
+void ofxCsvLog::setHandler(Handler handler) {
+	std::lock_guard<std::mutex> lock(s_handlerMutex);
+	s_handler = handler;
+}
+
+// openFrameworks builds pass messages to ofLog, see ofxCsvOf.cpp
+#ifdef OFX_CSV_STANDALONE
+
+//--------------------------------------------------
+void ofxCsvLog::defaultHandler(ofxCsvLogLevel level, const string &message) {
+	static const char *names[] = {"verbose", "notice", "warning", "error", "silent"};
+	fprintf(stderr, "[%s] ofxCsv: %s\n", names[(int)level], message.c_str());
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ *  ofxCsvLog.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+#include <atomic>
+#include <functional>
+#include <sstream>
+
+/// log message levels, in order of severity
+enum class ofxCsvLogLevel {
+	Verbose,
+	Notice,
+	Warning,
+	Error,
+	Silent //< disables all messages
+};
+
+/// \class ofxCsvLog
+/// \brief log message hook
+///
+/// Messages below the current level are skipped before they are formatted,
+/// so the level check is a single atomic load. Use the macros rather than
+/// this class directly:
+///
+///     OFX_CSV_LOG_ERROR << "Cannot load " << path;
+///
+/// Messages are passed to a handler: ofLog() with the "ofxCsv" module in
+/// openFrameworks, stderr in standalone builds, or a custom function.
+/// Verbose messages are compiled out if OFX_CSV_NO_VERBOSE_LOG is defined.
+///
+class ofxCsvLog {
+
+	public:
+
+		/// message handler function
+		typedef std::function<void(ofxCsvLogLevel level, const string &message)> Handler;
+
+		/// Start a message, passed to the handler when destroyed.
+		ofxCsvLog(ofxCsvLogLevel level);
+		~ofxCsvLog();
+
+		/// Append a value to the message.
+		template<typename T>
+		ofxCsvLog& operator<<(const T &value) {
+			message << value;
+			return *this;
+		}
+
+		/// Set the minimum level of messages to handle, default Notice.
+		static void setLevel(ofxCsvLogLevel level);
+
+		/// Get the minimum level of messages to handle.
+		static ofxCsvLogLevel getLevel();
+
+		/// Would a message at a given level be handled?
+		static inline bool isEnabled(ofxCsvLogLevel level) {
+			return (int)level >= s_level.load(std::memory_order_relaxed);
+		}
+
+		/// Set the message handler.
+		///
+		/// Called from the logging thread, which may be a thread pool worker.
+		///
+		/// \param handler Message function, pass nullptr to restore the default.
+		static void setHandler(Handler handler);
+
+		/// The default handler.
+		static void defaultHandler(ofxCsvLogLevel level, const string &message);
+
+	protected:
+
+		ofxCsvLogLevel level;       //< message level
+		std::ostringstream message; //< message text
+
+		static std::atomic<int> s_level; //< minimum level to handle
+};
+
+/// start a message at a given level, if enabled
+#define OFX_CSV_LOG(level) \
+	if(!ofxCsvLog::isEnabled(level)) {} else ofxCsvLog(level)
+
+#ifdef OFX_CSV_NO_VERBOSE_LOG
+	#define OFX_CSV_LOG_VERBOSE if(true) {} else ofxCsvLog(ofxCsvLogLevel::Verbose)
+#else
+	#define OFX_CSV_LOG_VERBOSE OFX_CSV_LOG(ofxCsvLogLevel::Verbose)
+#endif
+#define OFX_CSV_LOG_NOTICE OFX_CSV_LOG(ofxCsvLogLevel::Notice)
+#define OFX_CSV_LOG_WARNING OFX_CSV_LOG(ofxCsvLogLevel::Warning)
+#define OFX_CSV_LOG_ERROR OFX_CSV_LOG(ofxCsvLogLevel::Error)
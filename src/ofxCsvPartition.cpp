@@ -0,0 +1,121 @@
+/**
+ *  ofxCsvPartition.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvPartition.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+// get a field or an empty string if the row is too short
+static inline const string& getField(const ofxCsvRow &row, int col) {
+	static const string s_empty;
+	const vector<string> &fields = row.getData();
+	return (col >= 0 && (size_t)col < fields.size() ? fields[col] : s_empty);
+}
+
+// FNV-1a hash of a field
+static inline uint64_t hashField(const string &field) {
+	uint64_t hash = 14695981039346656037ULL;
+	for(unsigned char c : field) {
+		hash = (hash ^ c) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+//--------------------------------------------------
+ofxCsvPartition::ofxCsvPartition(Mode mode, int col, size_t count) :
+	mode(mode), col(col), count(count) {}
+
+//--------------------------------------------------
+ofxCsvPartition ofxCsvPartition::byValue(int col) {
+	return ofxCsvPartition(Value, col);
+}
+
+//--------------------------------------------------
+ofxCsvPartition ofxCsvPartition::byHash(int col, size_t numFiles) {
+	return ofxCsvPartition(Hash, col, numFiles);
+}
+
+//--------------------------------------------------
+ofxCsvPartition ofxCsvPartition::bySize(size_t maxBytes) {
+	return ofxCsvPartition(Size, -1, maxBytes);
+}
+
+//--------------------------------------------------
+vector<vector<size_t>> ofxCsvPartition::apply(const vector<ofxCsvRow> &rows, size_t first,
+                                              const string &separator, bool quote,
+                                              vector<string> &keys, size_t headerBytes) const {
+	vector<vector<size_t>> partitions;
+	keys.clear();
+	switch(mode) {
+		case Value: {
+			std::unordered_map<string, size_t> index;
+			for(size_t row = first; row < rows.size(); row++) {
+				const string &key = getField(rows[row], col);
+				auto found = index.find(key);
+				if(found == index.end()) {
+					found = index.emplace(key, partitions.size()).first;
+					partitions.push_back(vector<size_t>());
+					keys.push_back(key);
+				}
+				partitions[found->second].push_back(row);
+			}
+			break;
+		}
+		case Hash: {
+			partitions.resize(std::max<size_t>(count, 1));
+			for(size_t row = first; row < rows.size(); row++) {
+				partitions[hashField(getField(rows[row], col)) % partitions.size()].push_back(row);
+			}
+			break;
+		}
+		case Size: {
+			size_t bytes = 0;
+			for(size_t row = first; row < rows.size(); row++) {
+				const vector<string> &fields = rows[row].getData();
+				size_t rowBytes = 1; // newline
+				for(auto &field : fields) {
+					rowBytes += field.size() + (quote ? 2 : 0);
+				}
+				if(!fields.empty()) {
+					rowBytes += separator.size() * (fields.size() - 1);
+				}
+				if(partitions.empty() || (bytes + rowBytes > count && !partitions.back().empty())) {
+					partitions.push_back(vector<size_t>());
+					bytes = headerBytes;
+				}
+				partitions.back().push_back(row);
+				bytes += rowBytes;
+			}
+			break;
+		}
+	}
+	return partitions;
+}
@@ -0,0 +1,98 @@
+/**
+ *  ofxCsvPartition.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+/// \class ofxCsvPartition
+/// \brief a rule for splitting table rows into multiple files
+///
+/// Used with ofxCsv::savePartitioned() to write one file per key value, a
+/// fixed number of files by key hash, or files up to a maximum size:
+///
+///     // one file per device, ie. exports/part_device7.csv
+///     csv.savePartitioned("exports", ofxCsvPartition::byValue(0), true);
+///
+///     // ~256 MB files, ie. exports/part_00000.csv, exports/part_00001.csv...
+///     csv.savePartitioned("exports", ofxCsvPartition::bySize(256*1024*1024), true);
+///
+class ofxCsvPartition {
+
+	public:
+
+		/// Partitioning mode
+		enum Mode {
+			Value, //< one partition per distinct key column value
+			Hash,  //< a fixed number of partitions by key column value hash
+			Size   //< consecutive rows up to a maximum number of bytes
+		};
+
+		/// Constructor.
+		///
+		/// \param mode Partitioning mode.
+		/// \param col Key column number for Value & Hash.
+		/// \param count Number of partitions for Hash or maximum bytes for Size.
+		ofxCsvPartition(Mode mode, int col=-1, size_t count=0);
+
+		/// Partition by distinct key column values.
+		static ofxCsvPartition byValue(int col);
+
+		/// Partition into a fixed number of files by key column value hash.
+		static ofxCsvPartition byHash(int col, size_t numFiles);
+
+		/// Partition consecutive rows into files of a maximum size in bytes,
+		/// estimated from the field sizes. A single larger row gets its own file.
+		static ofxCsvPartition bySize(size_t maxBytes);
+
+		/// Assign rows to partitions.
+		///
+		/// Partitions are ordered by first appearance for Value, by hash for
+		/// Hash, & by row order for Size. Rows keep their order within each
+		/// partition. Hash always returns count partitions, so partition N
+		/// holds the rows of hash bucket N even if it's empty.
+		///
+		/// \param rows Rows to partition.
+		/// \param first Index of the first row to include, ie. 1 to skip a header.
+		/// \param separator Field separator, used to estimate row sizes.
+		/// \param quote Will fields be quoted? Used to estimate row sizes.
+		/// \param keys Set to the key value for each partition with Value,
+		///             empty otherwise.
+		/// \param headerBytes Bytes written at the start of each file, ie. a
+		///                    repeated header, counted towards the Size limit.
+		/// \returns row indices for each partition
+		vector<vector<size_t>> apply(const vector<ofxCsvRow> &rows, size_t first,
+		                             const string &separator, bool quote,
+		                             vector<string> &keys, size_t headerBytes=0) const;
+
+		Mode mode;    //< partitioning mode
+		int col;      //< key column number
+		size_t count; //< number of partitions for Hash or maximum bytes for Size
+};
@@ -0,0 +1,569 @@
+/**
+ *  ofxCsvQuery.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvQuery.h"
+#include "ofxCsv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/// number of 64 row bitmap words per parallel chunk
+static const size_t s_wordsPerChunk = 1024;
+
+// apply a comparison operator
+template<typename T>
+static inline bool test(ofxCsvQuery::Op op, const T &a, const T &b) {
+	switch(op) {
+		case ofxCsvQuery::Equal:        return a == b;
+		case ofxCsvQuery::NotEqual:     return a != b;
+		case ofxCsvQuery::Less:         return a < b;
+		case ofxCsvQuery::LessEqual:    return a <= b;
+		case ofxCsvQuery::Greater:      return a > b;
+		case ofxCsvQuery::GreaterEqual: return a >= b;
+	}
+	return false;
+}
+
+// compare an integer to a number exactly, without rounding the integer to
+// a double, ie. for nanosecond timestamps above 2^53
+static inline bool testExact(ofxCsvQuery::Op op, int64_t a, double b) {
+	if(std::isnan(b)) {
+		return op == ofxCsvQuery::NotEqual;
+	}
+	if(b >= 9223372036854775808.0) { // a < b
+		return test(op, 0, 1);
+	}
+	if(b < -9223372036854775808.0) { // a > b
+		return test(op, 1, 0);
+	}
+	double whole = std::floor(b);
+	int64_t i = (int64_t)whole;
+	if(a != i) { // i <= b < i+1
+		return test(op, a, i);
+	}
+	return (whole == b ? test(op, 0, 0) : test(op, 0, 1));
+}
+
+// mirror an operator when swapping operands, ie. 1 < a -> a > 1
+static ofxCsvQuery::Op mirror(ofxCsvQuery::Op op) {
+	switch(op) {
+		case ofxCsvQuery::Less:         return ofxCsvQuery::Greater;
+		case ofxCsvQuery::LessEqual:    return ofxCsvQuery::GreaterEqual;
+		case ofxCsvQuery::Greater:      return ofxCsvQuery::Less;
+		case ofxCsvQuery::GreaterEqual: return ofxCsvQuery::LessEqual;
+		default:                        return op;
+	}
+}
+
+// parse a field as a number, bools count as 1 or 0
+static inline bool parseNumber(const string &field, double &value) {
+	if(ofxCsvColumn::parseFloat(field, value)) {
+		return true;
+	}
+	bool b;
+	if(ofxCsvColumn::parseBool(field, b)) {
+		value = (b ? 1 : 0);
+		return true;
+	}
+	return false;
+}
+
+// get a field or an empty string if the row is too short
+static inline const string& getField(const ofxCsvRow &row, int col) {
+	static const string s_empty;
+	const vector<string> &fields = row.getData();
+	return (col >= 0 && (size_t)col < fields.size() ? fields[col] : s_empty);
+}
+
+// set bits for rows matching a predicate, in parallel
+template<typename Predicate>
+static void fill(size_t numRows, vector<uint64_t> &bits, Predicate predicate) {
+	ofxCsvThreadPool::shared().parallelFor(0, bits.size(), s_wordsPerChunk, [&](size_t begin, size_t end) {
+		for(size_t w = begin; w < end; w++) {
+			uint64_t word = 0;
+			size_t base = w * 64;
+			size_t count = std::min<size_t>(64, numRows - base);
+			for(size_t i = 0; i < count; i++) {
+				if(predicate(base + i)) {
+					word |= (1ULL << i);
+				}
+			}
+			bits[w] = word;
+		}
+	});
+}
+
+//--------------------------------------------------
+ofxCsvQuery::ofxCsvQuery() : root(-1), position(0) {}
+
+//--------------------------------------------------
+ofxCsvQuery::ofxCsvQuery(const string &expression, const vector<string> &columnNames) :
+	root(-1), position(0) {
+	compile(expression, columnNames);
+}
+
+//--------------------------------------------------
+bool ofxCsvQuery::compile(const string &expression, const vector<string> &columnNames) {
+	nodes.clear();
+	root = -1;
+	error = "";
+	position = 0;
+	if(!tokenize(expression, columnNames)) {
+		tokens.clear();
+		return false;
+	}
+	int node = parseOr();
+	if(node >= 0 && tokens[position].type != Token::End) {
+		node = -1;
+		fail("unexpected \"" + tokens[position].text + "\"");
+	}
+	tokens.clear();
+	if(node < 0) {
+		nodes.clear();
+		return false;
+	}
+	root = node;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvQuery::isCompiled() const {
+	return root >= 0;
+}
+
+//--------------------------------------------------
+string ofxCsvQuery::getError() const {
+	return error;
+}
+
+//--------------------------------------------------
+vector<uint64_t> ofxCsvQuery::evaluate(const ofxCsv &csv, bool header) const {
+	size_t numRows = csv.getNumRows();
+	vector<uint64_t> bits((numRows + 63) / 64, 0);
+	if(root < 0) {
+		return bits;
+	}
+	evaluate(root, csv, numRows, bits);
+	if(header && numRows > 0) {
+		bits[0] &= ~1ULL;
+	}
+	return bits;
+}
+
+//--------------------------------------------------
+vector<size_t> ofxCsvQuery::select(const ofxCsv &csv, bool header) const {
+	vector<uint64_t> bits = evaluate(csv, header);
+	vector<size_t> rows;
+	for(size_t w = 0; w < bits.size(); w++) {
+		uint64_t word = bits[w];
+		while(word) {
+			size_t i = 0;
+			while(!(word & (1ULL << i))) {i++;}
+			rows.push_back(w * 64 + i);
+			word &= word - 1; // clear lowest set bit
+		}
+	}
+	return rows;
+}
+
+//--------------------------------------------------
+ofxCsv ofxCsvQuery::filter(const ofxCsv &csv, bool header) const {
+	return csv.filter(*this, header);
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+bool ofxCsvQuery::tokenize(const string &expression, const vector<string> &columnNames) {
+	tokens.clear();
+	size_t i = 0;
+	size_t n = expression.size();
+	auto isIdentifier = [](char c, bool first) {
+		return isalpha((unsigned char)c) || c == '_' || (!first && (isdigit((unsigned char)c) || c == '.'));
+	};
+	auto resolve = [&](const string &name, Token &token) {
+		for(size_t c = 0; c < columnNames.size(); c++) {
+			if(columnNames[c] == name) {
+				token.col = c;
+				return true;
+			}
+		}
+		return fail("unknown column \"" + name + "\"");
+	};
+	while(i < n) {
+		char c = expression[i];
+		if(isspace((unsigned char)c)) {
+			i++;
+			continue;
+		}
+		Token token;
+		bool expectOperand = tokens.empty() || tokens.back().type == Token::Operator ||
+		                     tokens.back().type == Token::Open;
+		if(c == '(' || c == ')') {
+			token.type = (c == '(' ? Token::Open : Token::Close);
+			token.text = string(1, c);
+			i++;
+		}
+		else if(c == '"' || c == '\'') { // string literal
+			token.type = Token::String;
+			char quote = c;
+			for(i++; i < n && expression[i] != quote; i++) {
+				if(expression[i] == '\\' && i+1 < n) {
+					i++;
+				}
+				token.text += expression[i];
+			}
+			if(i >= n) {
+				return fail("unterminated string");
+			}
+			i++;
+		}
+		else if(c == '`') { // quoted column name
+			size_t end = expression.find('`', i+1);
+			if(end == string::npos) {
+				return fail("unterminated column name");
+			}
+			token.type = Token::Column;
+			token.text = expression.substr(i+1, end-i-1);
+			if(!resolve(token.text, token)) {
+				return false;
+			}
+			i = end+1;
+		}
+		else if(c == '$') { // column number
+			size_t end = i+1;
+			while(end < n && isdigit((unsigned char)expression[end])) {end++;}
+			if(end == i+1) {
+				return fail("expected column number after $");
+			}
+			token.type = Token::Column;
+			token.text = expression.substr(i, end-i);
+			token.col = atoi(token.text.c_str()+1);
+			i = end;
+		}
+		else if(isdigit((unsigned char)c) || c == '.' ||
+		        (expectOperand && (c == '-' || c == '+') && i+1 < n &&
+		         (isdigit((unsigned char)expression[i+1]) || expression[i+1] == '.'))) { // number
+			size_t end = i+1;
+			while(end < n && (isalnum((unsigned char)expression[end]) || expression[end] == '.' ||
+			      ((expression[end] == '-' || expression[end] == '+') &&
+			       (expression[end-1] == 'e' || expression[end-1] == 'E')))) {
+				end++;
+			}
+			token.type = Token::Number;
+			token.text = expression.substr(i, end-i);
+			if(!ofxCsvColumn::parseFloat(token.text, token.number)) {
+				return fail("invalid number \"" + token.text + "\"");
+			}
+			i = end;
+		}
+		else if(isIdentifier(c, true)) { // keyword or column name
+			size_t end = i+1;
+			while(end < n && isIdentifier(expression[end], false)) {end++;}
+			token.text = expression.substr(i, end-i);
+			string lower = token.text;
+			std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+			if(lower == "and" || lower == "or" || lower == "not") {
+				token.type = Token::Operator;
+				token.text = (lower == "and" ? "&&" : (lower == "or" ? "||" : "!"));
+			}
+			else if(lower == "true" || lower == "false") {
+				token.type = Token::Number;
+				token.number = (lower == "true" ? 1 : 0);
+			}
+			else {
+				token.type = Token::Column;
+				if(!resolve(token.text, token)) {
+					return false;
+				}
+			}
+			i = end;
+		}
+		else { // operator
+			static const char *s_operators[] = {
+				"&&", "||", "==", "!=", "<>", "<=", ">=", "<", ">", "=", "!"
+			};
+			for(auto op : s_operators) {
+				size_t len = strlen(op);
+				if(expression.compare(i, len, op) == 0) {
+					token.type = Token::Operator;
+					token.text = op;
+					i += len;
+					break;
+				}
+			}
+			if(token.type != Token::Operator) {
+				return fail("unexpected character '" + string(1, c) + "'");
+			}
+		}
+		tokens.push_back(token);
+	}
+	Token end;
+	end.text = "end of expression";
+	tokens.push_back(end);
+	return true;
+}
+
+//--------------------------------------------------
+int ofxCsvQuery::parseOr() {
+	int node = parseAnd();
+	while(node >= 0 && tokens[position].type == Token::Operator && tokens[position].text == "||") {
+		position++;
+		int right = parseAnd();
+		if(right < 0) {
+			return -1;
+		}
+		Node n;
+		n.type = Node::Or;
+		n.a = node;
+		n.b = right;
+		nodes.push_back(n);
+		node = nodes.size()-1;
+	}
+	return node;
+}
+
+//--------------------------------------------------
+int ofxCsvQuery::parseAnd() {
+	int node = parseNot();
+	while(node >= 0 && tokens[position].type == Token::Operator && tokens[position].text == "&&") {
+		position++;
+		int right = parseNot();
+		if(right < 0) {
+			return -1;
+		}
+		Node n;
+		n.type = Node::And;
+		n.a = node;
+		n.b = right;
+		nodes.push_back(n);
+		node = nodes.size()-1;
+	}
+	return node;
+}
+
+//--------------------------------------------------
+int ofxCsvQuery::parseNot() {
+	const Token &token = tokens[position];
+	if(token.type == Token::Operator && token.text == "!") {
+		position++;
+		int child = parseNot();
+		if(child < 0) {
+			return -1;
+		}
+		Node n;
+		n.type = Node::Not;
+		n.a = child;
+		nodes.push_back(n);
+		return nodes.size()-1;
+	}
+	if(token.type == Token::Open) {
+		position++;
+		int node = parseOr();
+		if(node < 0) {
+			return -1;
+		}
+		if(tokens[position].type != Token::Close) {
+			fail("expected ) before " + tokens[position].text);
+			return -1;
+		}
+		position++;
+		return node;
+	}
+	return parseComparison();
+}
+
+//--------------------------------------------------
+int ofxCsvQuery::parseComparison() {
+	Node n;
+	if(!parseOperand(n.left)) {
+		return -1;
+	}
+	const Token &token = tokens[position];
+	if(token.type != Token::Operator || token.text == "&&" || token.text == "||" || token.text == "!") {
+		fail("expected comparison operator before " + token.text);
+		return -1;
+	}
+	if(token.text == "==" || token.text == "=")       {n.op = Equal;}
+	else if(token.text == "!=" || token.text == "<>") {n.op = NotEqual;}
+	else if(token.text == "<")                        {n.op = Less;}
+	else if(token.text == "<=")                       {n.op = LessEqual;}
+	else if(token.text == ">")                        {n.op = Greater;}
+	else                                              {n.op = GreaterEqual;}
+	position++;
+	if(!parseOperand(n.right)) {
+		return -1;
+	}
+	if(n.left.col < 0 && n.right.col >= 0) { // put the column first
+		std::swap(n.left, n.right);
+		n.op = mirror(n.op);
+	}
+	nodes.push_back(n);
+	return nodes.size()-1;
+}
+
+//--------------------------------------------------
+bool ofxCsvQuery::parseOperand(Operand &operand) {
+	const Token &token = tokens[position];
+	switch(token.type) {
+		case Token::Column:
+			operand.col = token.col;
+			break;
+		case Token::Number:
+			operand.numeric = true;
+			operand.number = token.number;
+			operand.text = token.text;
+			break;
+		case Token::String:
+			operand.text = token.text;
+			break;
+		default:
+			return fail("expected column or value before " + token.text);
+	}
+	position++;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvQuery::fail(const string &message) {
+	error = message;
+	return false;
+}
+
+//--------------------------------------------------
+void ofxCsvQuery::evaluate(int node, const ofxCsv &csv, size_t numRows, vector<uint64_t> &bits) const {
+	const Node &n = nodes[node];
+	switch(n.type) {
+		case Node::Compare:
+			compare(n, csv, numRows, bits);
+			break;
+		case Node::And:
+		case Node::Or: {
+			evaluate(n.a, csv, numRows, bits);
+			vector<uint64_t> other(bits.size());
+			evaluate(n.b, csv, numRows, other);
+			for(size_t w = 0; w < bits.size(); w++) {
+				bits[w] = (n.type == Node::And ? bits[w] & other[w] : bits[w] | other[w]);
+			}
+			break;
+		}
+		case Node::Not:
+			evaluate(n.a, csv, numRows, bits);
+			for(auto &word : bits) {
+				word = ~word;
+			}
+			if(numRows % 64 != 0) { // clear bits past the last row
+				bits.back() &= (1ULL << (numRows % 64)) - 1;
+			}
+			break;
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvQuery::compare(const Node &node, const ofxCsv &csv, size_t numRows, vector<uint64_t> &bits) const {
+	const vector<ofxCsvRow> &rows = csv.getData();
+	const Operand &left = node.left;
+	const Operand &right = node.right;
+	const Op op = node.op;
+
+	// constant
+	if(left.col < 0) {
+		bool match = (left.numeric && right.numeric ?
+		              test(op, left.number, right.number) : test(op, left.text, right.text));
+		std::fill(bits.begin(), bits.end(), (match ? ~0ULL : 0ULL));
+		if(match && numRows % 64 != 0) {
+			bits.back() &= (1ULL << (numRows % 64)) - 1;
+		}
+		return;
+	}
+
+	// column vs column, numeric if both parse as numbers
+	if(right.col >= 0) {
+		fill(numRows, bits, [&](size_t r) {
+			const string &a = getField(rows[r], left.col);
+			const string &b = getField(rows[r], right.col);
+			double x, y;
+			if(parseNumber(a, x) && parseNumber(b, y)) {
+				return test(op, x, y);
+			}
+			return test(op, a, b);
+		});
+		return;
+	}
+
+	// column vs literal, use typed values if available
+	const ofxCsvColumn &column = csv.getColumn(left.col);
+	bool typed = (column.getType() != ofxCsvSchema::String && column.size() == numRows);
+	const double number = right.number;
+	const bool numeric = right.numeric;
+
+	// integer & timestamp columns are compared as int64, exactly
+	if(typed && column.getType() != ofxCsvSchema::Float) {
+		const vector<int64_t> &values = column.getInts();
+		const vector<uint8_t> &valid = column.getValid();
+		int64_t integer;
+		if((numeric && ofxCsvColumn::parseInt(right.text, integer)) ||
+		   (!numeric && column.getType() == ofxCsvSchema::Timestamp &&
+		    ofxCsvColumn::parseTimestamp(right.text, integer))) {
+			fill(numRows, bits, [&](size_t r) {
+				return valid[r] && test(op, values[r], integer);
+			});
+			return;
+		}
+		if(numeric) {
+			fill(numRows, bits, [&](size_t r) {
+				return valid[r] && testExact(op, values[r], number);
+			});
+			return;
+		}
+	}
+	if(numeric) {
+		if(typed && column.getType() == ofxCsvSchema::Float) {
+			const vector<double> &values = column.getDoubles();
+			const vector<uint8_t> &valid = column.getValid();
+			fill(numRows, bits, [&](size_t r) {
+				return valid[r] && test(op, values[r], number);
+			});
+		}
+		else {
+			fill(numRows, bits, [&](size_t r) {
+				double v;
+				return parseNumber(getField(rows[r], left.col), v) && test(op, v, number);
+			});
+		}
+	}
+	else {
+		const string &text = right.text;
+		fill(numRows, bits, [&](size_t r) {
+			return test(op, getField(rows[r], left.col), text);
+		});
+	}
+}
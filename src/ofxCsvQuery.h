@@ -0,0 +1,158 @@
+/**
+ *  ofxCsvQuery.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+class ofxCsv;
+
+/// \class ofxCsvQuery
+/// \brief a filter expression compiled once & evaluated column by column
+///
+/// Expressions compare columns with literals or other columns & combine the
+/// comparisons with boolean operators:
+///
+///     speed > 3.5 && zone == "B"
+///     !(temp < -10 || temp > 40) and $3 != 0
+///
+/// Columns are referenced by header name, by `quoted name` if the name
+/// contains spaces or symbols, or by number: $0, $1, etc. Literals are
+/// numbers, "strings" or 'strings', & true or false. Supported operators:
+///
+///   * comparison: == (or =), != (or <>), <, <=, >, >=
+///   * boolean: && (or and), || (or or), ! (or not), & parentheses
+///
+/// Each comparison is evaluated over a whole column into a selection bitmap
+/// & the bitmaps are combined with the boolean operators. Numeric columns
+/// of the table's typed columns (see ofxCsv::setSchema()) are used as is,
+/// other columns are parsed once per evaluation. Comparisons with empty or
+/// non-numeric fields are false.
+///
+///     ofxCsvQuery query;
+///     if(query.compile("speed > 3.5 && zone == \"B\"", {"speed", "zone"})) {
+///         vector<size_t> rows = query.select(csv, true);
+///     }
+///
+class ofxCsvQuery {
+
+	public:
+
+		/// Comparison operator
+		enum Op {Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual};
+
+		/// Constructor.
+		ofxCsvQuery();
+
+		/// Create & compile an expression.
+		ofxCsvQuery(const string &expression, const vector<string> &columnNames=vector<string>());
+
+		/// Compile an expression.
+		///
+		/// \param expression Filter expression.
+		/// \param columnNames Column names used to resolve named references.
+		/// \returns true on success, see getError() otherwise
+		bool compile(const string &expression, const vector<string> &columnNames=vector<string>());
+
+		/// Has an expression been compiled successfully?
+		bool isCompiled() const;
+
+		/// Get the last compile error message.
+		string getError() const;
+
+		/// Evaluate over a table.
+		///
+		/// \param csv Table to evaluate.
+		/// \param header Is the first row a header? If so, it never matches.
+		/// \returns selection bitmap with one bit per row, bit i of word i/64
+		vector<uint64_t> evaluate(const ofxCsv &csv, bool header=false) const;
+
+		/// Find the matching rows of a table.
+		///
+		/// \param csv Table to evaluate.
+		/// \param header Is the first row a header? If so, it never matches.
+		/// \returns matching row indices in order
+		vector<size_t> select(const ofxCsv &csv, bool header=false) const;
+
+		/// Create a new table with the matching rows of a table.
+		///
+		/// \param csv Table to filter.
+		/// \param header Is the first row a header? If so, it is kept.
+		/// \returns a new table with the matching rows
+		ofxCsv filter(const ofxCsv &csv, bool header=false) const;
+
+	protected:
+
+		/// comparison operand: a column or a literal
+		struct Operand {
+			int col = -1;         //< column number or -1 for a literal
+			bool numeric = false; //< is the literal a number?
+			double number = 0;    //< numeric literal value
+			string text;          //< literal text
+		};
+
+		/// expression tree node
+		struct Node {
+			enum Type {Compare, And, Or, Not} type = Compare;
+			Op op = Equal;
+			Operand left, right;  //< comparison operands
+			int a = -1, b = -1;   //< child node indices
+		};
+
+		/// expression token
+		struct Token {
+			enum Type {End, Column, Number, String, Operator, Open, Close} type = End;
+			string text;
+			double number = 0;
+			int col = -1;
+		};
+
+		/// recursive descent parser
+		bool tokenize(const string &expression, const vector<string> &columnNames);
+		int parseOr();
+		int parseAnd();
+		int parseNot();
+		int parseComparison();
+		bool parseOperand(Operand &operand);
+		bool fail(const string &message);
+
+		/// evaluate a node into a bitmap
+		void evaluate(int node, const ofxCsv &csv, size_t numRows, vector<uint64_t> &bits) const;
+
+		/// evaluate a comparison into a bitmap
+		void compare(const Node &node, const ofxCsv &csv, size_t numRows, vector<uint64_t> &bits) const;
+
+		vector<Node> nodes;   //< compiled expression tree
+		int root;             //< root node index, -1 if not compiled
+		string error;         //< last compile error
+
+		vector<Token> tokens; //< tokens while compiling
+		size_t position;      //< current token while compiling
+};
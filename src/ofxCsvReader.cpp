@@ -0,0 +1,385 @@
+/**
+ *  ofxCsvReader.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvReader.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <zlib.h>
+#ifdef OFX_CSV_ZSTD
+	#include <zstd.h>
+#endif
+
+//--------------------------------------------------
+ofxCsvReader::ofxCsvReader(size_t blockSize) :
+	compression(ofxCsvCompression::None), file(nullptr), zstd(nullptr),
+	error(false), eof(false), blockPos(0), blockLen(0), inputPos(0), inputLen(0),
+	encoding(ofxCsvEncoding::Auto), started(false), finished(false),
+	bytesRead(0), readTime(0) {
+	block.resize(std::max<size_t>(blockSize, 1024));
+}
+
+//--------------------------------------------------
+ofxCsvReader::~ofxCsvReader() {
+	close();
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::open(const string &path, ofxCsvCompression compression) {
+	close();
+	bytesRead = 0;
+	readTime = 0;
+	decoder.reset(encoding);
+	started = false;
+	finished = false;
+	if(compression == ofxCsvCompression::Auto) {
+		compression = detectCompression(path);
+	}
+	if(!isSupported(compression)) {
+		error = true;
+		return false;
+	}
+	this->compression = compression;
+	switch(compression) {
+		case ofxCsvCompression::Gzip: {
+			gzFile gz = gzopen(path.c_str(), "rb");
+			if(gz) {
+				gzbuffer(gz, block.size());
+			}
+			file = gz;
+			break;
+		}
+		case ofxCsvCompression::Zstd:
+		#ifdef OFX_CSV_ZSTD
+			file = fopen(path.c_str(), "rb");
+			zstd = ZSTD_createDStream();
+			ZSTD_initDStream((ZSTD_DStream *)zstd);
+			input.resize(ZSTD_DStreamInSize());
+		#endif
+			break;
+		default:
+			file = fopen(path.c_str(), "rb");
+			break;
+	}
+	if(!file) {
+		close();
+		error = true;
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+void ofxCsvReader::close() {
+	if(file) {
+		if(compression == ofxCsvCompression::Gzip) {
+			gzclose((gzFile)file);
+		}
+		else {
+			fclose((FILE *)file);
+		}
+		file = nullptr;
+	}
+#ifdef OFX_CSV_ZSTD
+	if(zstd) {
+		ZSTD_freeDStream((ZSTD_DStream *)zstd);
+	}
+#endif
+	zstd = nullptr;
+	error = false;
+	eof = false;
+	blockPos = blockLen = 0;
+	inputPos = inputLen = 0;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::isOpen() const {
+	return file != nullptr;
+}
+
+//--------------------------------------------------
+void ofxCsvReader::setEncoding(ofxCsvEncoding encoding) {
+	this->encoding = encoding;
+}
+
+//--------------------------------------------------
+size_t ofxCsvReader::read(char *buffer, size_t size) {
+	// drain any buffered line data first, small reads go through the block
+	if(blockPos < blockLen || size < 16) {
+		if(blockPos >= blockLen && !fill()) {
+			return 0;
+		}
+		size_t n = std::min(size, blockLen - blockPos);
+		memcpy(buffer, block.data() + blockPos, n);
+		blockPos += n;
+		return n;
+	}
+	auto start = std::chrono::steady_clock::now();
+	size_t n = readDecoded(buffer, size);
+	readTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return n;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::readLine(string &line) {
+	line.clear();
+	bool found = false;
+	while(true) {
+		if(blockPos >= blockLen && !fill()) {
+			break;
+		}
+		found = true;
+		const char *begin = block.data() + blockPos;
+		const char *newline = (const char *)memchr(begin, '\n', blockLen - blockPos);
+		if(newline) {
+			line.append(begin, newline - begin);
+			blockPos += (newline - begin) + 1;
+			break;
+		}
+		line.append(begin, blockLen - blockPos);
+		blockPos = blockLen;
+	}
+	if(!line.empty() && line.back() == '\r') {
+		line.pop_back();
+	}
+	return found;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::readAll(string &text) {
+	const size_t blockSize = 256 * 1024;
+	size_t size = 0;
+	text.clear();
+	while(true) {
+		text.resize(size + blockSize);
+		size_t count = read(&text[size], blockSize);
+		size += count;
+		if(count == 0) {
+			break;
+		}
+	}
+	text.resize(size);
+	return !error;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::hasError() const {
+	return error;
+}
+
+//--------------------------------------------------
+ofxCsvCompression ofxCsvReader::getCompression() const {
+	return compression;
+}
+
+//--------------------------------------------------
+ofxCsvEncoding ofxCsvReader::getEncoding() const {
+	return decoder.getEncoding();
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::hasByteOrderMark() const {
+	return decoder.hasByteOrderMark();
+}
+
+//--------------------------------------------------
+size_t ofxCsvReader::getNumInvalid() const {
+	return decoder.getNumInvalid();
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvReader::getFirstInvalid() const {
+	return decoder.getFirstInvalid();
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvReader::getBytesRead() const {
+	return bytesRead;
+}
+
+//--------------------------------------------------
+double ofxCsvReader::getReadTime() const {
+	return readTime;
+}
+
+//--------------------------------------------------
+ofxCsvCompression ofxCsvReader::detectCompression(const string &path) {
+	auto endsWith = [&path](const string &ext) {
+		if(path.size() < ext.size()) {
+			return false;
+		}
+		for(size_t i = 0; i < ext.size(); i++) {
+			if(tolower((unsigned char)path[path.size()-ext.size()+i]) != ext[i]) {
+				return false;
+			}
+		}
+		return true;
+	};
+	if(endsWith(".gz")) {
+		return ofxCsvCompression::Gzip;
+	}
+	if(endsWith(".zst")) {
+		return ofxCsvCompression::Zstd;
+	}
+	return ofxCsvCompression::None;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::isSupported(ofxCsvCompression compression) {
+#ifndef OFX_CSV_ZSTD
+	if(compression == ofxCsvCompression::Zstd) {
+		return false;
+	}
+#endif
+	return true;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+size_t ofxCsvReader::readRaw(char *buffer, size_t size) {
+	if(!file || eof || error) {
+		return 0;
+	}
+	switch(compression) {
+		case ofxCsvCompression::Gzip: {
+			int n = gzread((gzFile)file, buffer, (unsigned int)std::min<size_t>(size, INT_MAX));
+			if(n < 0) {
+				error = true;
+				return 0;
+			}
+			if(n == 0) {
+				eof = true;
+			}
+			return n;
+		}
+	#ifdef OFX_CSV_ZSTD
+		case ofxCsvCompression::Zstd: {
+			ZSTD_outBuffer out = {buffer, size, 0};
+			while(out.pos == 0) {
+				if(inputPos >= inputLen) {
+					inputLen = fread(input.data(), 1, input.size(), (FILE *)file);
+					inputPos = 0;
+					if(inputLen == 0) {
+						eof = true;
+						break;
+					}
+				}
+				ZSTD_inBuffer in = {input.data(), inputLen, inputPos};
+				size_t ret = ZSTD_decompressStream((ZSTD_DStream *)zstd, &out, &in);
+				inputPos = in.pos;
+				if(ZSTD_isError(ret)) {
+					error = true;
+					return 0;
+				}
+			}
+			return out.pos;
+		}
+	#endif
+		default: {
+			size_t n = fread(buffer, 1, size, (FILE *)file);
+			if(n == 0) {
+				if(ferror((FILE *)file)) {
+					error = true;
+				}
+				eof = true;
+			}
+			return n;
+		}
+	}
+}
+
+//--------------------------------------------------
+size_t ofxCsvReader::readDecoded(char *buffer, size_t size) {
+	if(!started) {
+		// read just enough to detect a byte order mark
+		started = true;
+		size_t len = 0;
+		while(len < 4) {
+			size_t n = readRaw(buffer + len, 4 - len);
+			if(n == 0) {
+				break;
+			}
+			len += n;
+		}
+		bytesRead += len;
+		size_t skip = decoder.detect(buffer, len);
+		if(decoder.isUtf16()) {
+			char bytes[4];
+			memcpy(bytes, buffer + skip, len - skip);
+			len = decoder.transcode(bytes, len - skip, buffer);
+		}
+		else {
+			len -= skip;
+			memmove(buffer, buffer + skip, len);
+			decoder.validate(buffer, len);
+		}
+		if(len > 0) {
+			return len;
+		}
+	}
+	size_t len = 0;
+	if(decoder.isUtf16()) {
+		// read a chunk which always fits in the buffer once transcoded
+		size_t chunk = (size - 6) / 3 * 2;
+		if(encoded.size() < chunk) {
+			encoded.resize(chunk);
+		}
+		while(len == 0) {
+			size_t n = readRaw(encoded.data(), chunk);
+			bytesRead += n;
+			if(n == 0) {
+				break;
+			}
+			len = decoder.transcode(encoded.data(), n, buffer);
+		}
+	}
+	else {
+		len = readRaw(buffer, size);
+		bytesRead += len;
+		decoder.validate(buffer, len);
+	}
+	if(len == 0 && !finished) {
+		// end of the file, replace any unfinished UTF-16 unit
+		finished = true;
+		len = decoder.finish(buffer);
+	}
+	return len;
+}
+
+//--------------------------------------------------
+bool ofxCsvReader::fill() {
+	auto start = std::chrono::steady_clock::now();
+	blockPos = 0;
+	blockLen = readDecoded(block.data(), block.size());
+	readTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return blockLen > 0;
+}
@@ -0,0 +1,175 @@
+/**
+ *  ofxCsvReader.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+#include "ofxCsvDecoder.h"
+
+/// compressed file formats
+enum class ofxCsvCompression {
+	Auto, //< detect by file extension: .gz or .zst
+	None, //< plain text
+	Gzip, //< gzip, requires zlib
+	Zstd  //< Zstandard, requires libzstd & OFX_CSV_ZSTD to be defined
+};
+
+/// \class ofxCsvReader
+/// \brief streaming line reader for plain & compressed files
+///
+/// Reads & decompresses the file in fixed size blocks, so compressed files
+/// are never fully expanded in memory. Each block is decoded as it's read:
+/// a byte order mark is skipped, UTF-16 is transcoded to UTF-8, & UTF-8 is
+/// validated, see ofxCsvDecoder.
+///
+///
+///     ofxCsvReader reader;
+///     if(reader.open("data.csv.gz")) {
+///         string line;
+///         while(reader.readLine(line)) {
+///             // do something with each line
+///         }
+///     }
+///
+class ofxCsvReader {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param blockSize Read block size in bytes, default 256 kB.
+		ofxCsvReader(size_t blockSize=256*1024);
+		virtual ~ofxCsvReader();
+
+		/// Open a file for reading.
+		///
+		/// Closes any currently open file.
+		///
+		/// \param path Absolute or working directory relative file path.
+		/// \param compression Compression format, default detects by extension.
+		/// \returns true if the file was opened
+		bool open(const string &path, ofxCsvCompression compression=ofxCsvCompression::Auto);
+
+		/// Set the text encoding for files opened afterwards.
+		///
+		/// \param encoding Encoding, default Auto detects by byte order mark.
+		void setEncoding(ofxCsvEncoding encoding);
+
+		/// Close the current file.
+		void close();
+
+		/// Is a file currently open?
+		bool isOpen() const;
+
+		/// Read the next block of decompressed bytes.
+		///
+		/// \param buffer Destination buffer.
+		/// \param size Maximum number of bytes to read.
+		/// \returns number of bytes read, 0 at the end of the file or on error
+		size_t read(char *buffer, size_t size);
+
+		/// Read the next line.
+		///
+		/// The trailing newline & any carriage return are removed.
+		///
+		/// \param line Set to the line contents.
+		/// \returns false at the end of the file
+		bool readLine(string &line);
+
+		/// Read the rest of the file.
+		///
+		/// \param text Set to the remaining contents.
+		/// \returns false on error
+		bool readAll(string &text);
+
+		/// Did a read or decompression error occur?
+		bool hasError() const;
+
+		/// Get the compression format of the open file.
+		ofxCsvCompression getCompression() const;
+
+		/// Get the text encoding of the open file, Auto until the first read.
+		ofxCsvEncoding getEncoding() const;
+
+		/// Did the open file start with a byte order mark?
+		bool hasByteOrderMark() const;
+
+		/// Get the number of invalid UTF-8 or UTF-16 sequences read so far.
+		size_t getNumInvalid() const;
+
+		/// Get the UTF-8 byte offset of the first invalid sequence.
+		uint64_t getFirstInvalid() const;
+
+		/// Get the number of decompressed bytes read since opening.
+		uint64_t getBytesRead() const;
+
+		/// Get the time spent reading & decompressing since opening.
+		///
+		/// \returns wall time in seconds
+		double getReadTime() const;
+
+		/// Detect the compression format by file extension.
+		///
+		/// \returns Gzip for .gz, Zstd for .zst, otherwise None
+		static ofxCsvCompression detectCompression(const string &path);
+
+		/// Is a compression format supported by this build?
+		static bool isSupported(ofxCsvCompression compression);
+
+	protected:
+
+		/// read compressed or plain bytes from the file
+		size_t readRaw(char *buffer, size_t size);
+
+		/// read decoded UTF-8 bytes, size must be at least 16
+		size_t readDecoded(char *buffer, size_t size);
+
+		/// refill the line buffer
+		bool fill();
+
+		ofxCsvCompression compression; //< current compression format
+		void *file;                    //< FILE* or gzFile handle
+		void *zstd;                    //< zstd decompression state
+		bool error;                    //< did an error occur?
+		bool eof;                      //< has the end of the file been reached?
+		vector<char> block;            //< decompressed line data
+		size_t blockPos;               //< read position in the block
+		size_t blockLen;               //< number of valid bytes in the block
+		vector<char> input;            //< compressed input for zstd
+		size_t inputPos;               //< read position in the compressed input
+		size_t inputLen;               //< number of valid compressed input bytes
+		ofxCsvEncoding encoding;       //< requested text encoding
+		ofxCsvDecoder decoder;         //< text decoding state
+		bool started;                  //< has the encoding been detected?
+		bool finished;                 //< has the decoder been finished?
+		vector<char> encoded;          //< UTF-16 input for transcoding
+		uint64_t bytesRead;            //< decompressed bytes read
+		double readTime;               //< seconds spent reading
+};
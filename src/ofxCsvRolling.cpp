@@ -0,0 +1,244 @@
+/**
+ *  ofxCsvRolling.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvRolling.h"
+
+#include <cmath>
+
+// Neumaier compensated summation, keeps the low-order bits lost when adding
+// values of different magnitudes in a separate compensation term
+static inline void addCompensated(double &sum, double &compensation, double value) {
+	double total = sum + value;
+	if(std::abs(sum) >= std::abs(value)) {
+		compensation += (sum - total) + value;
+	}
+	else {
+		compensation += (value - total) + sum;
+	}
+	sum = total;
+}
+
+//--------------------------------------------------
+ofxCsvRolling::ofxCsvRolling(Op op, size_t window, size_t minValues) {
+	setup(op, window, minValues);
+}
+
+//--------------------------------------------------
+void ofxCsvRolling::setup(Op op, size_t window, size_t minValues) {
+	this->op = op;
+	this->window = std::max<size_t>(window, 1);
+	this->minValues = std::max<size_t>(minValues, 1);
+	clear();
+}
+
+//--------------------------------------------------
+double ofxCsvRolling::push(double value) {
+
+	// drop the oldest value
+	size_t slot = next % window;
+	if(next >= window) {
+		double old = ring[slot];
+		if(!std::isnan(old)) {
+			count--;
+			if(std::isinf(old)) {
+				numInfinite[old > 0]--;
+			}
+			else {
+				removeFinite(old);
+			}
+		}
+		while(!extremes.empty() && extremes.front().first + window <= next) {
+			extremes.pop_front();
+		}
+	}
+	ring[slot] = value;
+
+	// add the new value
+	if(!std::isnan(value)) {
+		count++;
+		if(std::isinf(value)) {
+			numInfinite[value > 0]++;
+		}
+		else {
+			addFinite(value);
+		}
+		if(op == Min) {
+			while(!extremes.empty() && extremes.back().second >= value) {
+				extremes.pop_back();
+			}
+			extremes.emplace_back(next, value);
+		}
+		else if(op == Max) {
+			while(!extremes.empty() && extremes.back().second <= value) {
+				extremes.pop_back();
+			}
+			extremes.emplace_back(next, value);
+		}
+	}
+	next++;
+
+	// once per window keeps the update amortized constant time
+	if(next % window == 0 && op != Min && op != Max) {
+		recompute();
+	}
+	return get();
+}
+
+//--------------------------------------------------
+double ofxCsvRolling::get() const {
+	if(count < minValues || count == 0) {
+		return NAN;
+	}
+	size_t finite = count - numInfinite[0] - numInfinite[1];
+	switch(op) {
+		case Sum:
+		case Mean:
+			if(numInfinite[0] > 0 || numInfinite[1] > 0) {
+				if(numInfinite[0] > 0 && numInfinite[1] > 0) {
+					return NAN;
+				}
+				return (numInfinite[1] > 0 ? INFINITY : -INFINITY);
+			}
+			return (op == Sum ? sum + compensation : mean);
+		case Variance:
+		case StdDev: {
+			if(finite < count || count < 2) {
+				return NAN;
+			}
+			double variance = m2 / (count - 1);
+			return (op == Variance ? variance : sqrt(variance));
+		}
+		case Min:
+		case Max:      return extremes.front().second;
+	}
+	return NAN;
+}
+
+//--------------------------------------------------
+void ofxCsvRolling::clear() {
+	ring.assign(window, NAN);
+	next = 0;
+	count = 0;
+	numInfinite[0] = numInfinite[1] = 0;
+	sum = compensation = mean = m2 = 0;
+	extremes.clear();
+}
+
+//--------------------------------------------------
+size_t ofxCsvRolling::getCount() const {
+	return count;
+}
+
+//--------------------------------------------------
+ofxCsvRolling::Op ofxCsvRolling::getOp() const {
+	return op;
+}
+
+//--------------------------------------------------
+size_t ofxCsvRolling::getWindow() const {
+	return window;
+}
+
+//--------------------------------------------------
+string ofxCsvRolling::getName(int col, const string &colName) const {
+	string name;
+	switch(op) {
+		case Sum:      name = "sum"; break;
+		case Mean:     name = "mean"; break;
+		case Variance: name = "var"; break;
+		case StdDev:   name = "std"; break;
+		case Min:      name = "min"; break;
+		case Max:      name = "max"; break;
+	}
+	return name + "(" + (colName.empty() ? std::to_string(col) : colName) + "," +
+	       std::to_string(window) + ")";
+}
+
+//--------------------------------------------------
+vector<double> ofxCsvRolling::apply(const vector<double> &values, Op op,
+                                    size_t window, size_t minValues) {
+	ofxCsvRolling rolling(op, window, minValues);
+	vector<double> results;
+	results.reserve(values.size());
+	for(double value : values) {
+		results.push_back(rolling.push(value));
+	}
+	return results;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+void ofxCsvRolling::addFinite(double value) {
+	size_t finite = count - numInfinite[0] - numInfinite[1];
+	addCompensated(sum, compensation, value);
+
+	// Welford update
+	double delta = value - mean;
+	mean += delta / finite;
+	m2 += delta * (value - mean);
+}
+
+//--------------------------------------------------
+void ofxCsvRolling::removeFinite(double value) {
+	size_t finite = count - numInfinite[0] - numInfinite[1];
+	if(finite == 0) {
+		sum = compensation = mean = m2 = 0;
+		return;
+	}
+	addCompensated(sum, compensation, -value);
+
+	// reverse Welford update
+	double delta = value - mean;
+	mean -= delta / finite;
+	m2 -= delta * (value - mean);
+	if(m2 < 0) {
+		m2 = 0;
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvRolling::recompute() {
+	size_t finite = 0;
+	sum = compensation = 0;
+	for(double value : ring) {
+		if(std::isfinite(value)) {
+			addCompensated(sum, compensation, value);
+			finite++;
+		}
+	}
+	mean = (finite > 0 ? (sum + compensation) / finite : 0);
+	m2 = 0;
+	for(double value : ring) {
+		if(std::isfinite(value)) {
+			m2 += (value - mean) * (value - mean);
+		}
+	}
+}
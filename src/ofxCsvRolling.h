@@ -0,0 +1,152 @@
+/**
+ *  ofxCsvRolling.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+#include <deque>
+
+/// \class ofxCsvRolling
+/// \brief a statistic over a sliding window of values, updated incrementally
+///
+/// Each pushed value updates the statistic in constant amortized time:
+/// running sums for the sum, mean & variance, & a monotonic queue for the
+/// min & max, so a whole column is processed in O(n) regardless of the
+/// window size:
+///
+///     // 10 row moving average, updated as rows are appended
+///     ofxCsvRolling average(ofxCsvRolling::Mean, 10);
+///     for(auto &row : newRows) {
+///         float smoothed = average.push(row.getFloat(1));
+///     }
+///
+/// The window spans a number of rows, including missing values which are
+/// pushed as NAN & skipped. A result is NAN until the window contains the
+/// minimum number of values.
+///
+/// The running sums are compensated & recomputed from the window values once
+/// per window, so they don't drift over long series. While an infinite value
+/// is in the window, the sum & mean are infinite (NAN if both signs are
+/// present) & the variance is NAN; the statistics recover once it leaves.
+///
+class ofxCsvRolling {
+
+	public:
+
+		/// Statistic type
+		enum Op {
+			Sum,      //< sum of the window values
+			Mean,     //< arithmetic mean of the window values
+			Variance, //< sample variance of the window values
+			StdDev,   //< sample standard deviation of the window values
+			Min,      //< smallest window value
+			Max       //< largest window value
+		};
+
+		/// Constructor.
+		///
+		/// \param op Statistic type.
+		/// \param window Window size in rows, at least 1.
+		/// \param minValues Minimum number of values in the window for a
+		///                  result, at least 1. default 1
+		ofxCsvRolling(Op op=Mean, size_t window=10, size_t minValues=1);
+
+		/// Set the statistic & window size, clears current values.
+		void setup(Op op, size_t window, size_t minValues=1);
+
+		/// Add a value, dropping the oldest value if the window is full.
+		///
+		/// \param value New value, NAN if missing.
+		/// \returns the statistic for the current window
+		double push(double value);
+
+		/// Get the statistic for the current window.
+		///
+		/// \returns the statistic or NAN if there are too few values
+		double get() const;
+
+		/// Clear all values.
+		void clear();
+
+		/// Get the number of values in the current window, excluding missing.
+		size_t getCount() const;
+
+		/// Get the statistic type.
+		Op getOp() const;
+
+		/// Get the window size in rows.
+		size_t getWindow() const;
+
+		/// Get a descriptive name, ie. "mean(3,10)" or "mean(speed,10)".
+		///
+		/// \param col Column number.
+		/// \param colName Optional column name, uses the column number if empty.
+		string getName(int col, const string &colName="") const;
+
+		/// Compute a rolling statistic over a series of values.
+		///
+		/// \param values Values, NAN if missing.
+		/// \param op Statistic type.
+		/// \param window Window size in rows.
+		/// \param minValues Minimum number of values in the window for a result.
+		/// \returns one result per value, NAN if there are too few values
+		static vector<double> apply(const vector<double> &values, Op op,
+		                            size_t window, size_t minValues=1);
+
+	protected:
+
+		Op op;            //< statistic type
+		size_t window;    //< window size in rows
+		size_t minValues; //< minimum number of values for a result
+
+		vector<double> ring; //< window values, NAN if missing
+		size_t next;         //< total number of values pushed
+
+		size_t count; //< number of values in the window
+		size_t numInfinite[2]; //< number of -inf & +inf values in the window
+		double sum;          //< running sum of the finite values
+		double compensation; //< lost low-order bits of the sum
+		double mean;         //< running mean of the finite values
+		double m2;           //< running sum of squared differences from the mean
+
+		/// add a finite value to the running sums
+		void addFinite(double value);
+
+		/// remove a finite value from the running sums
+		void removeFinite(double value);
+
+		/// recompute the running sums from the window values
+		void recompute();
+
+		/// monotonic queue of (push index, value) for Min or Max, the front
+		/// is the current extreme value
+		std::deque<std::pair<size_t, double>> extremes;
+};
@@ -30,15 +30,69 @@
 
 #include "ofxCsvRow.h"
 
-#include "ofLog.h"
-#include "ofUtils.h"
-
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
 #include <regex>
 
 /// whitespace leading & trailing trim regular expression, from:
 // http://stackoverflow.com/questions/24048400/function-to-trim-leading-and-trailing-whitespace-in-vba
 static std::regex s_trimRegex = std::regex("^[\\s]+|[\\s]+$");
 
+// field conversions, same results as ofToInt(), ofToFloat(), ofToBool(), &
+// ofToString() without the string streams
+
+static int fieldToInt(const string &field) {
+	long value = strtol(field.c_str(), nullptr, 10);
+	return (int)std::max<long>(std::min<long>(value, INT_MAX), INT_MIN);
+}
+
+static float fieldToFloat(const string &field) {
+	return strtof(field.c_str(), nullptr);
+}
+
+static bool fieldToBool(const string &field) {
+	string lower = field;
+	for(auto &c : lower) {
+		c = tolower((unsigned char)c);
+	}
+	if(lower == "true") {
+		return true;
+	}
+	if(lower == "false") {
+		return false;
+	}
+	char *end;
+	long value = strtol(lower.c_str(), &end, 10);
+	return end != lower.c_str() && value != 0;
+}
+
+static string toField(int value) {
+	return std::to_string(value);
+}
+
+static string toField(float value) {
+	char text[32];
+	snprintf(text, sizeof(text), "%g", value);
+	return text;
+}
+
+static string toField(bool value) {
+	return (value ? "1" : "0");
+}
+
+static string joinFields(const vector<string> &fields, const string &separator) {
+	string joined;
+	for(size_t i = 0; i < fields.size(); i++) {
+		if(i > 0) {
+			joined += separator;
+		}
+		joined += fields[i];
+	}
+	return joined;
+}
+
 //--------------------------------------------------
 ofxCsvRow::ofxCsvRow() {}
 
@@ -52,14 +106,38 @@ ofxCsvRow::ofxCsvRow(const vector<string> &cols) {
 	load(cols);
 }
 
+//--------------------------------------------------
+ofxCsvRow::ofxCsvRow(vector<string> &&cols) {
+	data = std::move(cols);
+}
+
 //--------------------------------------------------
 ofxCsvRow::ofxCsvRow(const ofxCsvRow &mom) {
-	data = mom.data;
+	*this = mom;
+}
+
+//--------------------------------------------------
+ofxCsvRow::ofxCsvRow(ofxCsvRow &&mom) noexcept {
+	*this = std::move(mom);
 }
 
 //--------------------------------------------------
 ofxCsvRow& ofxCsvRow::operator=(const ofxCsvRow &mom) {
 	data = mom.data;
+	lazyText = mom.lazyText;
+	lazyOffset = mom.lazyOffset;
+	lazySize = mom.lazySize;
+	lazyCols = mom.lazyCols;
+	return *this;
+}
+
+//--------------------------------------------------
+ofxCsvRow& ofxCsvRow::operator=(ofxCsvRow &&mom) noexcept {
+	data = std::move(mom.data);
+	lazyText = std::move(mom.lazyText);
+	lazyOffset = mom.lazyOffset;
+	lazySize = mom.lazySize;
+	lazyCols = mom.lazyCols;
 	return *this;
 }
 
@@ -77,9 +155,26 @@ void ofxCsvRow::load(const vector<string> &cols) {
 	data = cols;
 }
 
+//--------------------------------------------------
+void ofxCsvRow::loadLazy(const std::shared_ptr<const LazyText> &text, size_t offset, size_t size) {
+	clear();
+	lazyText = text;
+	lazyOffset = offset;
+	lazySize = size;
+}
+
+//--------------------------------------------------
+bool ofxCsvRow::isSplit() const {
+	return !lazyText;
+}
+
 //--------------------------------------------------
 void ofxCsvRow::expand(int cols) {
 	cols = max(cols, 0);
+	if(lazyText) { // don't split just to expand, ie. for the whole table
+		lazyCols = max(lazyCols, cols);
+		return;
+	}
 	if(data.empty()) {
 		cols = max(cols, 1);
 	}
@@ -91,10 +186,13 @@ void ofxCsvRow::expand(int cols) {
 //--------------------------------------------------
 void ofxCsvRow::clear() {
 	data.clear();
+	lazyText.reset();
+	lazyCols = -1;
 }
 
 //--------------------------------------------------
 string ofxCsvRow::toString(bool quote, const string &separator) {
+	split();
 	return ofxCsvRow::toString(data, quote, separator);
 }
 
@@ -108,27 +206,31 @@ ostream& operator<<(ostream &ostr, const ofxCsvRow &row) {
 
 //--------------------------------------------------
 unsigned int ofxCsvRow::getNumCols() const {
+	split();
 	return data.size();
 }
 
 //--------------------------------------------------
 int ofxCsvRow::getInt(int col) const {
+	split();
 	if(col >= data.size()) {
 		return 0;
 	}
-	return ofToInt(data[col]);
+	return fieldToInt(data[col]);
 }
 
 //--------------------------------------------------
 float ofxCsvRow::getFloat(int col) const {
+	split();
 	if(col >= data.size()) {
 		return 0.0f;
 	}
-	return ofToFloat(data[col]);
+	return fieldToFloat(data[col]);
 }
 
 //--------------------------------------------------
 string ofxCsvRow::getString(int col) const {
+	split();
 	if(col >= data.size()) {
 		return "";
 	}
@@ -137,89 +239,113 @@ string ofxCsvRow::getString(int col) const {
 
 //--------------------------------------------------
 bool ofxCsvRow::getBool(int col) const {
+	split();
 	if(col >= data.size()) {
 		return false;
 	}
-	return ofToBool(data[col]);
+	return fieldToBool(data[col]);
+}
+
+//--------------------------------------------------
+int64_t ofxCsvRow::getTimestamp(int col, ofxCsvTimestamp::Format format) const {
+	split();
+	int64_t nanos;
+	if(col < 0 || (size_t)col >= data.size() || !ofxCsvTimestamp::parse(data[col], nanos, format)) {
+		return ofxCsvTimestamp::Missing;
+	}
+	return nanos;
 }
 
 // ADDING FIELDS
 
 //--------------------------------------------------
 void ofxCsvRow::addInt(int what) {
-	data.push_back(ofToString(what));
+	split();
+	data.push_back(toField(what));
 }
 
 //--------------------------------------------------
 void ofxCsvRow::addFloat(float what) {
-	data.push_back(ofToString(what));
+	split();
+	data.push_back(toField(what));
 }
 
 //--------------------------------------------------
 void ofxCsvRow::addString(string what) {
+	split();
 	data.push_back(what);
 }
 
 //--------------------------------------------------
 void ofxCsvRow::ofxCsvRow::addBool(bool what) {
-	data.push_back(ofToString(what));
+	split();
+	data.push_back(toField(what));
 }
 // SETTING FIELDS
 
 //--------------------------------------------------
 void ofxCsvRow::setInt(int col, int what) {
+	split();
 	expand(col);
-	data[col] = ofToString(what);
+	data[col] = toField(what);
 }
 
 //--------------------------------------------------
 void ofxCsvRow::setFloat(int col, float what) {
+	split();
 	expand(col);
-	data[col] = ofToString(what);
+	data[col] = toField(what);
 }
 
 //--------------------------------------------------
 void ofxCsvRow::setString(int col, string what) {
+	split();
 	expand(col);
 	data[col] = what;
 }
 
 //--------------------------------------------------
 void ofxCsvRow::setBool(int col, bool what) {
+	split();
 	expand(col);
-	data[col] = ofToString(what);
+	data[col] = toField(what);
 }
 
 // INSERTING FIELDS
 
 //--------------------------------------------------
 void ofxCsvRow::insertInt(int col, int what) {
+	split();
 	expand(col);
-	data.insert(data.begin()+col, ofToString(what));
+	data.insert(data.begin()+col, toField(what));
 }
 
 //--------------------------------------------------
 void ofxCsvRow::insertFloat(int col, float what) {
+	split();
 	expand(col);
-	data.insert(data.begin()+col, ofToString(what));
+	data.insert(data.begin()+col, toField(what));
 }
 
 //--------------------------------------------------
 void ofxCsvRow::insertString(int col, string what) {
+	split();
 	expand(col);
 	data.insert(data.begin()+col, what);
 }
 
 //--------------------------------------------------
 void ofxCsvRow::insertBool(int col, bool what) {
+	split();
 	expand(col);
-	data.insert(data.begin()+col, ofToString(what));
+	data.insert(data.begin()+col, toField(what));
 }
 
 // REMOVING FIELDS
 
 //--------------------------------------------------
 void ofxCsvRow::remove(int col) {
+	split();
 	if(col < data.size()) {
 		data.erase(data.begin()+col);
 	}
@@ -229,81 +355,103 @@ void ofxCsvRow::remove(int col) {
 
 //--------------------------------------------------
 vector<string>& ofxCsvRow::getData() {
+	split();
+	return data;
+}
+
+//--------------------------------------------------
+const vector<string>& ofxCsvRow::getData() const {
+	split();
 	return data;
 }
 
 //--------------------------------------------------
 vector<string>::iterator ofxCsvRow::begin() {
+	split();
 	return data.begin();
 }
 
 //--------------------------------------------------
 vector<string>::iterator ofxCsvRow::end() {
+	split();
 	return data.end();
 }
 
 //--------------------------------------------------
 vector<string>::const_iterator ofxCsvRow::begin() const {
+	split();
 	return data.begin();
 }
 
 //--------------------------------------------------
 vector<string>::const_iterator ofxCsvRow::end() const {
+	split();
 	return data.end();
 }
 
 //--------------------------------------------------
 vector<string>::reverse_iterator ofxCsvRow::rbegin() {
+	split();
 	return data.rbegin();
 }
 
 //--------------------------------------------------
 vector<string>::reverse_iterator ofxCsvRow::rend() {
+	split();
 	return data.rend();
 }
 
 //--------------------------------------------------
 vector<string>::const_reverse_iterator ofxCsvRow::rbegin() const {
+	split();
 	return data.rbegin();
 }
 
 //--------------------------------------------------
 vector<string>::const_reverse_iterator ofxCsvRow::rend() const {
+	split();
 	return data.rend();
 }
 
 //--------------------------------------------------
 ofxCsvRow::operator vector<string>() const {
+	split();
 	return data;
 }
 
 //--------------------------------------------------
 string& ofxCsvRow::operator[](size_t index) {
+	split();
 	return data[index];
 }
 
 //--------------------------------------------------
 string& ofxCsvRow::at(size_t index) {
+	split();
 	return data.at(index);
 }
 
 //--------------------------------------------------
 string& ofxCsvRow::front(){
+	split();
 	return data.front();
 }
 
 //--------------------------------------------------
 string& ofxCsvRow::back(){
+	split();
 	return data.back();
 }
 
 //--------------------------------------------------
 size_t ofxCsvRow::size() const {
+	split();
 	return data.size();
 }
 
 //--------------------------------------------------
 bool ofxCsvRow::empty() const {
+	split();
 	return data.empty();
 }
 
@@ -311,6 +459,7 @@ bool ofxCsvRow::empty() const {
 
 //--------------------------------------------------
 void ofxCsvRow::trim() {
+	split();
 	for(string &col : data) {
 		col = std::regex_replace(col, s_trimRegex, "$1");
 	}
@@ -333,9 +482,16 @@ enum ParseState {
 // handles separators inside quotes & Excel's double quoted quotes, adapted from:
 // http://stackoverflow.com/questions/1120140/how-can-i-read-and-parse-csv-files-in-c/1595366#1595366
 vector<string> ofxCsvRow::fromString(const string &row, const string &separator) {
+	return fromString(row, separator, 1);
+}
+
+//--------------------------------------------------
+vector<string> ofxCsvRow::fromString(const string &row, const string &separator, size_t numFields) {
 	
 	ParseState state = UnquotedField;
-	vector<string> fields {""};
+	vector<string> fields;
+	fields.reserve(std::max<size_t>(numFields, 1));
+	fields.push_back("");
 	
 	size_t i = 0; // index of the current field
 	int s = 0; // index in the separator
@@ -421,9 +577,30 @@ string ofxCsvRow::toString(const vector<string> &row, bool quote, const string &
 		for(auto field : row) {
 			fields.push_back("\""+field+"\"");
 		}
-		return ofJoinString(fields, separator);
+		return joinFields(fields, separator);
 	}
 	else { // no quotes
-		return ofJoinString(row, separator);
+		return joinFields(row, separator);
+	}
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+void ofxCsvRow::split() const {
+	if(!lazyText) {
+		return;
+	}
+	data = ofxCsvRow::fromString(lazyText->text.substr(lazyOffset, lazySize), lazyText->separator);
+	lazyText.reset();
+	if(lazyCols > -1) {
+		int cols = max(lazyCols, 0);
+		lazyCols = -1;
+		if(data.empty()) {
+			cols = max(cols, 1);
+		}
+		while(data.size() <= (size_t)cols) {
+			data.push_back("");
+		}
 	}
 }
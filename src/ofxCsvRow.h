@@ -31,14 +31,26 @@
 #pragma once
 using namespace std;
 
-#include "ofConstants.h"
+#include "ofxCsvConstants.h"
+#include "ofxCsvTimestamp.h"
+
+#include <memory>
 
 /// \class ofxCsvRow
 /// \brief A single row of column fields.
+///
+/// A row can also be a lazy slice of a line in a shared text buffer, which
+/// is only split into fields on first access, see ofxCsv::setLazy().
 class ofxCsvRow {
 	
 	public:
 	
+		/// shared text of lazily split rows
+		struct LazyText {
+			string text;      //< file text
+			string separator; //< field separator
+		};
+	
 		/// Constructor. Initializes and starts the class.
 		ofxCsvRow();
 	
@@ -48,12 +60,21 @@ class ofxCsvRow {
 		/// Create & load from a vector.
 		ofxCsvRow(const vector<string> &cols);
 	
+		/// Create & load from a vector, taking over its data.
+		ofxCsvRow(vector<string> &&cols);
+	
 		/// Copy constructor
 		ofxCsvRow(const ofxCsvRow &mom);
 	
+		/// Move constructor, noexcept so vectors move rows when growing
+		ofxCsvRow(ofxCsvRow &&mom) noexcept;
+	
 		/// Copy operator
 		ofxCsvRow &operator=(const ofxCsvRow &mom);
 	
+		/// Move operator
+		ofxCsvRow &operator=(ofxCsvRow &&mom) noexcept;
+	
 	/// \section Data IO
 	
 		/// Load from a string.
@@ -71,9 +92,25 @@ class ofxCsvRow {
 		/// \param data Cols to load.
 		void load(const vector<string> &cols);
 	
+		/// Load as a lazy slice of a line in a shared text.
+		///
+		/// Clears any currently loaded data. The line is split into fields
+		/// the first time any field is accessed.
+		///
+		/// \param text Shared text & field separator.
+		/// \param offset Start of the line in the text.
+		/// \param size Line size, without the newline.
+		void loadLazy(const std::shared_ptr<const LazyText> &text, size_t offset, size_t size);
+	
+		/// Has the row been split into fields?
+		///
+		/// \returns false if this is a lazy row which hasn't been accessed yet
+		bool isSplit() const;
+	
 		/// Expand for the required number of cols.
 		///
-		/// Fills any missing fields with empty strings.
+		/// Fills any missing fields with empty strings. Lazy rows are
+		/// expanded once they are split.
 		///
 		/// \param cols Required number of cols, minimum of 1.
 		void expand(int cols);
@@ -122,6 +159,15 @@ class ofxCsvRow {
 		/// \returns the value or false if not found.
 		bool getBool(int col) const;
 	
+		/// Get a field as a timestamp in nanoseconds since the Unix epoch.
+		///
+		/// Parses without allocating, see ofxCsvTimestamp.
+		///
+		/// \param col Column number
+		/// \param format Field format, default ISO-8601
+		/// \returns the value or ofxCsvTimestamp::Missing if not found or invalid.
+		int64_t getTimestamp(int col, ofxCsvTimestamp::Format format=ofxCsvTimestamp::Iso8601) const;
+	
 	/// \section Adding Fields
 	
 		/// Add an integer field value to the end of the row.
@@ -227,6 +273,7 @@ class ofxCsvRow {
 	
 		/// Get the underlying vector.
 		vector<string>& getData();
+		const vector<string>& getData() const;
 	
 		// iterator wrappers for easy looping:
 		//
@@ -282,6 +329,14 @@ class ofxCsvRow {
 		/// \returns String vector of fields.
 		static vector<string> fromString(const string &row, const string &separator);
 	
+		/// Split a row string into fields, reserving storage up front.
+		///
+		/// \param row Row string to split.
+		/// \param separator Field separator string, default comma ",".
+		/// \param numFields Expected number of fields.
+		/// \returns String vector of fields.
+		static vector<string> fromString(const string &row, const string &separator, size_t numFields);
+	
 		/// Join a row of separate column fields into a single string.
 		///
 		/// \param row Fields to join.
@@ -292,6 +347,15 @@ class ofxCsvRow {
 	
 	protected:
 	
-		/// col string data
-		vector<string> data;
+		/// split a lazy row into fields, if not done yet
+		void split() const;
+	
+		/// col string data, filled on first access for lazy rows
+		mutable vector<string> data;
+	
+		/// lazy row line text, null once split
+		mutable std::shared_ptr<const LazyText> lazyText;
+		mutable size_t lazyOffset = 0; //< line start in the lazy text
+		mutable size_t lazySize = 0;   //< line size
+		mutable int lazyCols = -1;     //< pending expand() once split
 };
@@ -0,0 +1,258 @@
+/**
+ *  ofxCsvSampler.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvSampler.h"
+#include "ofxCsvReader.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+
+/// files smaller than this are sampled exactly via the reservoir
+static const uint64_t s_minOffsetFileSize = 4 * 1024 * 1024;
+
+/// block size read when looking for the next row boundary
+static const size_t s_windowSize = 4 * 1024;
+
+/// maximum row size when reading a row, guards against binary files
+static const size_t s_maxRowSize = 16 * 1024 * 1024;
+
+/// maximum number of rounds to replace duplicate or skipped rows
+static const int s_maxRounds = 4;
+
+// is a line empty or a comment?
+static inline bool skipLine(const string &line, const string &comment) {
+	return line.empty() ||
+	       (!comment.empty() && line.compare(0, comment.size(), comment) == 0);
+}
+
+// create a random engine
+static std::mt19937_64 createEngine(uint64_t seed) {
+	if(seed == 0) {
+		std::random_device device;
+		seed = ((uint64_t)device() << 32) | device();
+	}
+	return std::mt19937_64(seed);
+}
+
+// read a row starting at a given offset, rows end at each newline like
+// ofxCsv::load() so both see the same rows
+// returns the offset after the row or 0 on failure
+static uint64_t readRow(std::ifstream &file, uint64_t offset, string &row) {
+	row.clear();
+	file.clear();
+	file.seekg(offset);
+	char buffer[4096];
+	while(row.size() < s_maxRowSize) {
+		file.read(buffer, sizeof(buffer));
+		size_t n = file.gcount();
+		if(n == 0) {
+			break;
+		}
+		const char *newline = (const char *)memchr(buffer, '\n', n);
+		if(newline) {
+			row.append(buffer, newline - buffer);
+			uint64_t end = offset + row.size() + 1;
+			if(!row.empty() && row.back() == '\r') {
+				row.pop_back();
+			}
+			return end;
+		}
+		row.append(buffer, n);
+	}
+	if(row.size() >= s_maxRowSize) {
+		return 0;
+	}
+	uint64_t end = offset + row.size();
+	if(!row.empty() && row.back() == '\r') {
+		row.pop_back();
+	}
+	return end;
+}
+
+// find the start of the next row after a given offset, reads forward block
+// by block so long rows are skipped over instead of missed
+// returns the row start offset or 0 if there is no boundary before EOF
+static uint64_t findNextRow(std::ifstream &file, uint64_t offset) {
+	file.clear();
+	file.seekg(offset);
+	char window[s_windowSize];
+	uint64_t read = 0;
+	while(read < s_maxRowSize) {
+		file.read(window, sizeof(window));
+		size_t n = file.gcount();
+		if(n == 0) {
+			break;
+		}
+		size_t pos = ofxCsvSampler::findRowStart(window, n);
+		if(pos != string::npos) {
+			return offset + read + pos;
+		}
+		read += n;
+	}
+	return 0;
+}
+
+//--------------------------------------------------
+bool ofxCsvSampler::sampleOffsets(const string &path, size_t numRows, bool header,
+                                  const string &separator, const string &comment,
+                                  uint64_t seed, vector<ofxCsvRow> &rows) {
+	rows.clear();
+	std::ifstream file(path, std::ios::binary);
+	if(!file.is_open()) {
+		return false;
+	}
+	file.seekg(0, std::ios::end);
+	uint64_t size = file.tellg();
+
+	// header & data start
+	uint64_t start = 0;
+	string text;
+	if(header) {
+		while(start < size) {
+			uint64_t end = readRow(file, start, text);
+			if(end == 0) {
+				return false;
+			}
+			start = end;
+			if(!skipLine(text, comment)) {
+				rows.push_back(ofxCsvRow(text, separator));
+				break;
+			}
+		}
+	}
+	if(size - start < s_minOffsetFileSize) { // not worth it
+		file.close();
+		return sampleReservoir(path, numRows, header, separator, comment, seed, rows);
+	}
+
+	// sample rows at random offsets, keyed by row start to skip duplicates
+	std::mt19937_64 engine = createEngine(seed);
+	std::uniform_int_distribution<uint64_t> distribution(start, size-1);
+	std::map<uint64_t, ofxCsvRow> sampled;
+	for(int round = 0; round < s_maxRounds && sampled.size() < numRows; round++) {
+		vector<uint64_t> offsets(numRows - sampled.size());
+		for(auto &offset : offsets) {
+			offset = distribution(engine);
+		}
+		std::sort(offsets.begin(), offsets.end()); // read sequentially
+		for(auto offset : offsets) {
+			uint64_t rowStart = offset;
+			if(offset > start) {
+				rowStart = findNextRow(file, offset);
+				if(rowStart == 0) {
+					continue;
+				}
+			}
+			if(rowStart >= size || sampled.count(rowStart) > 0) {
+				continue;
+			}
+			if(readRow(file, rowStart, text) == 0 || skipLine(text, comment)) {
+				continue;
+			}
+			sampled[rowStart] = ofxCsvRow(text, separator);
+		}
+	}
+	for(auto &row : sampled) {
+		rows.push_back(std::move(row.second));
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvSampler::sampleReservoir(const string &path, size_t numRows, bool header,
+                                    const string &separator, const string &comment,
+                                    uint64_t seed, vector<ofxCsvRow> &rows,
+                                    ofxCsvEncoding encoding) {
+	rows.clear();
+	ofxCsvReader reader;
+	reader.setEncoding(encoding);
+	if(!reader.open(path)) {
+		return false;
+	}
+
+	// Algorithm L, see https://en.wikipedia.org/wiki/Reservoir_sampling
+	std::mt19937_64 engine = createEngine(seed);
+	std::uniform_real_distribution<double> uniform(std::nextafter(0.0, 1.0), 1.0);
+	vector<std::pair<uint64_t, string>> reservoir; // line index & text
+	reservoir.reserve(numRows);
+	double w = 1;
+	uint64_t next = 0; // index of the next line to sample once full
+	uint64_t index = 0;
+	string line;
+	while(reader.readLine(line)) {
+		if(skipLine(line, comment)) {
+			continue;
+		}
+		if(header) {
+			rows.push_back(ofxCsvRow(line, separator));
+			header = false;
+			continue;
+		}
+		if(numRows == 0) {
+			break;
+		}
+		if(reservoir.size() < numRows) {
+			reservoir.push_back(std::make_pair(index, line));
+			if(reservoir.size() == numRows) {
+				w = exp(log(uniform(engine)) / numRows);
+				next = index + 1 + (uint64_t)floor(log(uniform(engine)) / log(1 - w));
+			}
+		}
+		else if(index == next) {
+			std::uniform_int_distribution<size_t> slot(0, numRows-1);
+			reservoir[slot(engine)] = std::make_pair(index, line);
+			w *= exp(log(uniform(engine)) / numRows);
+			next = index + 1 + (uint64_t)floor(log(uniform(engine)) / log(1 - w));
+		}
+		index++;
+	}
+	if(reader.hasError()) {
+		return false;
+	}
+
+	// return in file order
+	std::sort(reservoir.begin(), reservoir.end());
+	for(auto &sample : reservoir) {
+		rows.push_back(ofxCsvRow(sample.second, separator));
+	}
+	return true;
+}
+
+//--------------------------------------------------
+size_t ofxCsvSampler::findRowStart(const char *text, size_t size) {
+	const char *newline = (const char *)memchr(text, '\n', size);
+	if(!newline) {
+		return string::npos;
+	}
+	return newline - text + 1;
+}
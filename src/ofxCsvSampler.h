@@ -0,0 +1,94 @@
+/**
+ *  ofxCsvSampler.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvDecoder.h"
+#include "ofxCsvRow.h"
+
+/// \class ofxCsvSampler
+/// \brief random row sampling from large files
+///
+/// Used by ofxCsv::loadSample(). Two methods are available:
+///
+///   * Offsets: seeks to random byte offsets, reads forward in 4 kB blocks
+///     to the next row boundary & parses only that row. Reads about two
+///     rows per sample regardless of the file size, so rows of any length
+///     can be sampled, but favors rows which follow long rows.
+///   * Reservoir: streams through the whole file & keeps an exact uniform
+///     random sample in constant memory. Only the sampled lines are split.
+///     Used for compressed files & small files.
+///
+/// Rows end at each newline, as in ofxCsv::load(), so quoted fields
+/// containing newlines are split the same way in the sample & the table.
+/// Sampled rows are returned in file order.
+///
+class ofxCsvSampler {
+
+	public:
+
+		/// Sample rows via random byte offsets.
+		///
+		/// \param path Absolute file path, must not be compressed.
+		/// \param numRows Desired number of rows.
+		/// \param header Always include the first row?
+		/// \param separator Field separator string.
+		/// \param comment Comment line prefix.
+		/// \param seed Random seed, 0 to seed randomly.
+		/// \param rows Set to the sampled rows.
+		/// \returns false if the file couldn't be read
+		static bool sampleOffsets(const string &path, size_t numRows, bool header,
+		                          const string &separator, const string &comment,
+		                          uint64_t seed, vector<ofxCsvRow> &rows);
+
+		/// Sample rows via reservoir sampling over all lines.
+		///
+		/// \param path Absolute file path, plain or compressed.
+		/// \param numRows Desired number of rows.
+		/// \param header Always include the first row?
+		/// \param separator Field separator string.
+		/// \param comment Comment line prefix.
+		/// \param seed Random seed, 0 to seed randomly.
+		/// \param rows Set to the sampled rows.
+		/// \param encoding Text encoding, default detects by byte order mark.
+		/// \returns false if the file couldn't be read
+		static bool sampleReservoir(const string &path, size_t numRows, bool header,
+		                            const string &separator, const string &comment,
+		                            uint64_t seed, vector<ofxCsvRow> &rows,
+		                            ofxCsvEncoding encoding=ofxCsvEncoding::Auto);
+
+		/// Find the first row boundary in a block of text which starts at an
+		/// arbitrary position, ie. in the middle of a row.
+		///
+		/// \param text Block text.
+		/// \param size Block size in bytes.
+		/// \returns position after the first newline or string::npos
+		static size_t findRowStart(const char *text, size_t size);
+};
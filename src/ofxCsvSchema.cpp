@@ -0,0 +1,349 @@
+/**
+ *  ofxCsvSchema.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvSchema.h"
+#include "ofxCsvColumn.h"
+#include "ofxCsvThreadPool.h"
+
+#include <sstream>
+
+/// minimum number of rows in each partition
+static const size_t s_minRowsPerThread = 16384;
+
+/// running type & value info for a single column
+struct ColumnStats {
+	bool seen = false;                  //< has a non-null value been found?
+	ofxCsvSchema::Type type = ofxCsvSchema::String;
+	size_t count = 0;
+	size_t nullCount = 0;
+	bool ranged = false;                //< have min & max been set?
+	double min = 0;
+	double max = 0;
+
+	void addRange(double v) {
+		if(!ranged) {
+			min = max = v;
+			ranged = true;
+		}
+		else {
+			min = std::min(min, v);
+			max = std::max(max, v);
+		}
+	}
+
+	void add(const string &field) {
+		count++;
+		bool null = false;
+		ofxCsvSchema::Type fieldType = ofxCsvSchema::detectType(field, null);
+		if(null) {
+			nullCount++;
+			return;
+		}
+		ofxCsvSchema::Type merged = (seen ? merge(type, fieldType) : fieldType);
+		if(merged != ofxCsvSchema::String) {
+			double v = 0;
+			if(fieldType == ofxCsvSchema::Int || fieldType == ofxCsvSchema::Timestamp) {
+				int64_t i = 0;
+				if(fieldType == ofxCsvSchema::Int) {
+					ofxCsvColumn::parseInt(field, i);
+				}
+				else {
+					ofxCsvColumn::parseTimestamp(field, i);
+				}
+				v = (double)i;
+			}
+			else if(fieldType == ofxCsvSchema::Float) {
+				ofxCsvColumn::parseFloat(field, v);
+			}
+			if(fieldType != ofxCsvSchema::Bool) {
+				addRange(v);
+			}
+		}
+		type = merged;
+		seen = true;
+	}
+
+	void merge(const ColumnStats &other) {
+		if(other.ranged) {
+			addRange(other.min);
+			addRange(other.max);
+		}
+		if(other.seen) {
+			type = (seen ? merge(type, other.type) : other.type);
+			seen = true;
+		}
+		count += other.count;
+		nullCount += other.nullCount;
+	}
+
+	/// find the most specific type which can hold both types
+	static ofxCsvSchema::Type merge(ofxCsvSchema::Type a, ofxCsvSchema::Type b) {
+		if(a == b) {
+			return a;
+		}
+		if((a == ofxCsvSchema::Int && b == ofxCsvSchema::Float) ||
+		   (a == ofxCsvSchema::Float && b == ofxCsvSchema::Int)) {
+			return ofxCsvSchema::Float;
+		}
+		return ofxCsvSchema::String;
+	}
+};
+
+// examine a range of rows
+static void inferRange(const vector<ofxCsvRow> &rows, size_t begin, size_t end,
+                       vector<ColumnStats> &stats) {
+	for(size_t r = begin; r < end; r++) {
+		const vector<string> &fields = rows[r].getData();
+		if(fields.size() > stats.size()) {
+			stats.resize(fields.size());
+		}
+		for(size_t c = 0; c < fields.size(); c++) {
+			stats[c].add(fields[c]);
+		}
+	}
+}
+
+//--------------------------------------------------
+ofxCsvSchema::ofxCsvSchema() : header(false) {}
+
+//--------------------------------------------------
+ofxCsvSchema::ofxCsvSchema(const vector<Type> &types) : header(false) {
+	for(auto type : types) {
+		addColumn(type);
+	}
+}
+
+//--------------------------------------------------
+ofxCsvSchema ofxCsvSchema::infer(const vector<ofxCsvRow> &rows, bool header,
+                                 size_t sampleSize, unsigned int threads) {
+	size_t first = (header && !rows.empty() ? 1 : 0);
+	size_t end = rows.size();
+	size_t partitions = 1;
+	if(sampleSize > 0) {
+		end = std::min(end, first + sampleSize);
+	}
+	else {
+		if(threads == 0) {
+			threads = ofxCsvThreadPool::shared().getNumThreads();
+		}
+		partitions = std::max<size_t>(std::min<size_t>(threads, (end - first) / s_minRowsPerThread), 1);
+	}
+
+	// scan rows, in parallel on the shared thread pool for a full scan
+	vector<vector<ColumnStats>> stats(partitions);
+	size_t partitionSize = (end - first + partitions - 1) / partitions;
+	ofxCsvThreadPool::shared().parallelFor(0, partitions, 1, [&](size_t begin, size_t last) {
+		for(size_t p = begin; p < last; p++) {
+			size_t b = first + p * partitionSize;
+			size_t e = std::min(b + partitionSize, end);
+			inferRange(rows, b, e, stats[p]);
+		}
+	});
+	for(size_t p = 1; p < partitions; p++) {
+		if(stats[p].size() > stats[0].size()) {
+			stats[0].resize(stats[p].size());
+		}
+		for(size_t c = 0; c < stats[p].size(); c++) {
+			stats[0][c].merge(stats[p][c]);
+		}
+	}
+
+	// build schema, rows shorter than the widest are padded with nulls
+	ofxCsvSchema schema;
+	schema.header = header;
+	size_t numCols = stats[0].size();
+	if(header && !rows.empty()) {
+		numCols = std::max<size_t>(numCols, rows[0].size());
+	}
+	size_t numRows = end - first;
+	for(size_t c = 0; c < numCols; c++) {
+		Column column;
+		if(header && !rows.empty()) {
+			column.name = rows[0].getString(c);
+		}
+		if(c < stats[0].size()) {
+			const ColumnStats &s = stats[0][c];
+			column.type = (s.seen ? s.type : String);
+			column.count = s.count;
+			column.nullCount = s.nullCount;
+			if(column.type != String && column.type != Bool) {
+				column.min = s.min;
+				column.max = s.max;
+			}
+		}
+		column.nullCount += numRows - column.count;
+		column.count = numRows;
+		schema.columns.push_back(column);
+	}
+	return schema;
+}
+
+// COLUMNS
+
+//--------------------------------------------------
+void ofxCsvSchema::addColumn(Type type, const string &name) {
+	Column column;
+	column.type = type;
+	column.name = name;
+	columns.push_back(column);
+}
+
+//--------------------------------------------------
+size_t ofxCsvSchema::size() const {
+	return columns.size();
+}
+
+//--------------------------------------------------
+ofxCsvSchema::Column& ofxCsvSchema::operator[](size_t col) {
+	return columns[col];
+}
+
+//--------------------------------------------------
+const ofxCsvSchema::Column& ofxCsvSchema::operator[](size_t col) const {
+	return columns[col];
+}
+
+//--------------------------------------------------
+ofxCsvSchema::Type ofxCsvSchema::getType(int col) const {
+	if(col < 0 || (size_t)col >= columns.size()) {
+		return String;
+	}
+	return columns[col].type;
+}
+
+//--------------------------------------------------
+int ofxCsvSchema::getIndex(const string &name) const {
+	for(size_t c = 0; c < columns.size(); c++) {
+		if(columns[c].name == name) {
+			return c;
+		}
+	}
+	return -1;
+}
+
+//--------------------------------------------------
+vector<ofxCsvSchema::Column>& ofxCsvSchema::getColumns() {
+	return columns;
+}
+
+//--------------------------------------------------
+const vector<ofxCsvSchema::Column>& ofxCsvSchema::getColumns() const {
+	return columns;
+}
+
+//--------------------------------------------------
+bool ofxCsvSchema::hasHeader() const {
+	return header;
+}
+
+//--------------------------------------------------
+void ofxCsvSchema::setHeader(bool header) {
+	this->header = header;
+}
+
+// UTIL
+
+//--------------------------------------------------
+ofxCsvSchema::Type ofxCsvSchema::detectType(const string &field, bool &null) {
+	null = isNull(field);
+	if(null) {
+		return String;
+	}
+	int64_t i;
+	double d;
+	bool b;
+	if(ofxCsvColumn::parseInt(field, i)) {
+		return Int;
+	}
+	if(ofxCsvColumn::parseFloat(field, d)) {
+		return Float;
+	}
+	if(ofxCsvColumn::parseBool(field, b)) {
+		return Bool;
+	}
+	if(ofxCsvColumn::parseTimestamp(field, i)) {
+		return Timestamp;
+	}
+	return String;
+}
+
+//--------------------------------------------------
+bool ofxCsvSchema::isNull(const string &field) {
+	size_t begin = field.find_first_not_of(" \t\r");
+	if(begin == string::npos) {
+		return true;
+	}
+	size_t end = field.find_last_not_of(" \t\r") + 1;
+	size_t len = end - begin;
+	if(len > 4) {
+		return false;
+	}
+	string lower;
+	for(size_t i = begin; i < end; i++) {
+		lower += tolower((unsigned char)field[i]);
+	}
+	return lower == "na" || lower == "n/a" || lower == "null" ||
+	       lower == "none" || lower == "nan";
+}
+
+//--------------------------------------------------
+string ofxCsvSchema::typeToString(Type type) {
+	switch(type) {
+		case Int:       return "int";
+		case Float:     return "float";
+		case Bool:      return "bool";
+		case Timestamp: return "timestamp";
+		case String:    return "string";
+	}
+	return "string";
+}
+
+//--------------------------------------------------
+string ofxCsvSchema::toString() const {
+	std::ostringstream out;
+	for(size_t c = 0; c < columns.size(); c++) {
+		const Column &column = columns[c];
+		out << c << ": ";
+		if(!column.name.empty()) {
+			out << column.name << " ";
+		}
+		out << typeToString(column.type);
+		if(column.isNullable()) {
+			out << " nullable(" << column.nullCount << "/" << column.count << ")";
+		}
+		if(column.type == Int || column.type == Float || column.type == Timestamp) {
+			out << " [" << column.min << ", " << column.max << "]";
+		}
+		if(c+1 < columns.size()) {
+			out << "\n";
+		}
+	}
+	return out.str();
+}
@@ -0,0 +1,152 @@
+/**
+ *  ofxCsvSchema.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+/// \class ofxCsvSchema
+/// \brief column names & value types for a table
+///
+/// A schema can be inferred from loaded rows:
+///
+///     ofxCsvSchema schema = csv.inferSchema(true); // first row is a header
+///     ofLog() << schema.toString();
+///
+/// or given explicitly to load a file directly into typed columns, skipping
+/// inference:
+///
+///     ofxCsvSchema schema({ofxCsvSchema::Float, ofxCsvSchema::Int});
+///     csv.load("file.csv", schema);
+///     const ofxCsvColumn &speed = csv.getColumn(0);
+///
+/// Null values are empty fields & the usual placeholders: NA, N/A, null,
+/// none, & nan (case insensitive).
+///
+class ofxCsvSchema {
+
+	public:
+
+		/// Column value type, ordered from most to least specific
+		enum Type {
+			Int,       //< 64 bit signed integer
+			Float,     //< double precision floating point
+			Bool,      //< true or false
+			Timestamp, //< ISO-8601 date & time, stored as epoch nanoseconds
+			String     //< anything else
+		};
+
+		/// Per-column type & value info
+		struct Column {
+			string name;          //< column name, empty if there is no header
+			Type type = String;   //< value type
+			size_t count = 0;     //< number of values examined
+			size_t nullCount = 0; //< number of null values found
+			double min = 0;       //< smallest numeric or timestamp value
+			double max = 0;       //< largest numeric or timestamp value
+
+			/// Were any null values found?
+			bool isNullable() const {return nullCount > 0;}
+		};
+
+		/// Constructor.
+		ofxCsvSchema();
+
+		/// Create with the given column types & no header.
+		ofxCsvSchema(const vector<Type> &types);
+
+		/// Infer column types from rows.
+		///
+		/// \param rows Rows to examine.
+		/// \param header Is the first row a header with column names?
+		/// \param sampleSize Number of rows to examine, 0 scans all rows in
+		///                   parallel.
+		/// \param threads Maximum number of partitions scanned in parallel on
+		///                the shared thread pool, 0 for automatic.
+		/// \returns inferred schema
+		static ofxCsvSchema infer(const vector<ofxCsvRow> &rows, bool header=false,
+		                          size_t sampleSize=1000, unsigned int threads=0);
+
+	/// \section Columns
+
+		/// Add a column.
+		///
+		/// \param type Column value type.
+		/// \param name Optional column name.
+		void addColumn(Type type, const string &name="");
+
+		/// Get the number of columns.
+		size_t size() const;
+
+		/// Get the column info for a given column, ie. schema[1].type
+		Column& operator[](size_t col);
+		const Column& operator[](size_t col) const;
+
+		/// Get the type of a given column.
+		/// \returns the column type or String if the column does not exist
+		Type getType(int col) const;
+
+		/// Get the index of a named column.
+		/// \returns the column number or -1 if not found
+		int getIndex(const string &name) const;
+
+		/// Get all columns.
+		vector<Column>& getColumns();
+		const vector<Column>& getColumns() const;
+
+		/// Does the table have a header row with column names?
+		bool hasHeader() const;
+
+		/// Set whether the table has a header row.
+		void setHeader(bool header);
+
+	/// \section Util
+
+		/// Classify a single field value.
+		///
+		/// \param field Field value.
+		/// \param null Set to true if the value is null.
+		/// \returns the most specific matching type
+		static Type detectType(const string &field, bool &null);
+
+		/// Is a field value null?
+		static bool isNull(const string &field);
+
+		/// Get a type name, ie. "int".
+		static string typeToString(Type type);
+
+		/// Get a printable description with one line per column.
+		string toString() const;
+
+	protected:
+
+		vector<Column> columns; //< column info
+		bool header;            //< is the first row a header?
+};
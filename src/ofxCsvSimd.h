@@ -0,0 +1,201 @@
+/**
+ *  ofxCsvSimd.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OFX_CSV_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OFX_CSV_NEON
+#endif
+
+/// \class ofxCsvSimd
+/// \brief vectorized byte scanning helpers
+///
+/// Uses SSE2 on x86, NEON on ARM, & 64 bit SWAR (SIMD within a register)
+/// elsewhere.
+class ofxCsvSimd {
+
+	public:
+
+		/// Count the occurences of a byte.
+		///
+		/// \param text Text to scan.
+		/// \param size Text size in bytes.
+		/// \param c Byte to count.
+		/// \returns number of occurences
+		static inline size_t count(const char *text, size_t size, char c) {
+			size_t total = 0;
+			size_t i = 0;
+		#if defined(OFX_CSV_SSE2)
+			const __m128i needle = _mm_set1_epi8(c);
+			while(i + 16 <= size) {
+				// per-byte counters overflow after 255 blocks
+				__m128i counts = _mm_setzero_si128();
+				size_t blocks = std::min<size_t>((size - i) / 16, 255);
+				for(size_t b = 0; b < blocks; b++, i += 16) {
+					__m128i bytes = _mm_loadu_si128((const __m128i *)(text + i));
+					counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(bytes, needle));
+				}
+				__m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+				total += _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+			}
+		#elif defined(OFX_CSV_NEON)
+			const uint8x16_t needle = vdupq_n_u8((uint8_t)c);
+			while(i + 16 <= size) {
+				uint8x16_t counts = vdupq_n_u8(0);
+				size_t blocks = std::min<size_t>((size - i) / 16, 255);
+				for(size_t b = 0; b < blocks; b++, i += 16) {
+					uint8x16_t bytes = vld1q_u8((const uint8_t *)(text + i));
+					counts = vsubq_u8(counts, vceqq_u8(bytes, needle));
+				}
+				uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(counts)));
+				total += vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+			}
+		#else
+			const uint64_t ones = 0x0101010101010101ULL;
+			const uint64_t lows = 0x7f7f7f7f7f7f7f7fULL;
+			const uint64_t pattern = ones * (uint8_t)c;
+			while(i + 8 <= size) {
+				uint64_t word;
+				memcpy(&word, text + i, 8);
+				uint64_t x = word ^ pattern; // matching bytes are now 0
+				uint64_t t = ~(((x & lows) + lows) | x | lows); // high bit set for 0 bytes
+				total += ((t >> 7) * ones) >> 56;
+				i += 8;
+			}
+		#endif
+			for(; i < size; i++) {
+				if(text[i] == c) {
+					total++;
+				}
+			}
+			return total;
+		}
+
+		/// Find the first non-ASCII byte, ie. with the high bit set.
+		///
+		/// \param text Text to scan.
+		/// \param size Text size in bytes.
+		/// \returns index of the first non-ASCII byte or size if all are ASCII
+		static inline size_t findNonAscii(const char *text, size_t size) {
+			size_t i = 0;
+		#if defined(OFX_CSV_SSE2)
+			while(i + 16 <= size) {
+				__m128i bytes = _mm_loadu_si128((const __m128i *)(text + i));
+				if(_mm_movemask_epi8(bytes) != 0) {
+					break;
+				}
+				i += 16;
+			}
+		#elif defined(OFX_CSV_NEON)
+			while(i + 16 <= size) {
+				uint8x16_t bytes = vld1q_u8((const uint8_t *)(text + i));
+				uint8x8_t any = vorr_u8(vget_low_u8(bytes), vget_high_u8(bytes));
+				if(vget_lane_u64(vreinterpret_u64_u8(any), 0) & 0x8080808080808080ULL) {
+					break;
+				}
+				i += 16;
+			}
+		#else
+			while(i + 8 <= size) {
+				uint64_t word;
+				memcpy(&word, text + i, 8);
+				if(word & 0x8080808080808080ULL) {
+					break;
+				}
+				i += 8;
+			}
+		#endif
+			for(; i < size; i++) {
+				if(text[i] & 0x80) {
+					break;
+				}
+			}
+			return i;
+		}
+
+		/// Convert a run of ASCII UTF-16 code units to single bytes.
+		///
+		/// Stops at the first non-ASCII unit, which is left for the caller to
+		/// convert.
+		///
+		/// \param utf16 UTF-16 text.
+		/// \param units Number of 2 byte code units.
+		/// \param bigEndian Are the units big endian?
+		/// \param out Destination, must hold units bytes.
+		/// \returns number of units converted
+		static inline size_t narrowAscii(const char *utf16, size_t units, bool bigEndian, char *out) {
+			size_t i = 0;
+		#if defined(OFX_CSV_SSE2)
+			const __m128i high = _mm_set1_epi16((short)0xff80);
+			while(i + 8 <= units) {
+				__m128i v = _mm_loadu_si128((const __m128i *)(utf16 + i * 2));
+				if(bigEndian) {
+					v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+				}
+				__m128i zero = _mm_cmpeq_epi16(_mm_and_si128(v, high), _mm_setzero_si128());
+				if(_mm_movemask_epi8(zero) != 0xffff) {
+					break;
+				}
+				_mm_storel_epi64((__m128i *)(out + i), _mm_packus_epi16(v, v));
+				i += 8;
+			}
+		#elif defined(OFX_CSV_NEON)
+			while(i + 8 <= units) {
+				uint8x16_t bytes = vld1q_u8((const uint8_t *)(utf16 + i * 2));
+				if(bigEndian) {
+					bytes = vrev16q_u8(bytes);
+				}
+				uint16x8_t v = vreinterpretq_u16_u8(bytes);
+				uint16x8_t high = vandq_u16(v, vdupq_n_u16(0xff80));
+				uint16x4_t any = vorr_u16(vget_low_u16(high), vget_high_u16(high));
+				if(vget_lane_u64(vreinterpret_u64_u16(any), 0) != 0) {
+					break;
+				}
+				vst1_u8((uint8_t *)(out + i), vmovn_u16(v));
+				i += 8;
+			}
+		#endif
+			for(; i < units; i++) {
+				uint8_t a = utf16[i * 2], b = utf16[i * 2 + 1];
+				uint8_t low = (bigEndian ? b : a), hi = (bigEndian ? a : b);
+				if(hi != 0 || low >= 0x80) {
+					break;
+				}
+				out[i] = low;
+			}
+			return i;
+		}
+};
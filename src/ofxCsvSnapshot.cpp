@@ -0,0 +1,106 @@
+/**
+ *  ofxCsvSnapshot.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvSnapshot.h"
+
+const size_t ofxCsvSnapshot::BlockSize;
+
+//--------------------------------------------------
+ofxCsvSnapshot::ofxCsvSnapshot() {
+	numRows = 0;
+	version = 0;
+	copiedBlocks = 0;
+}
+
+// ROW ACCESS
+
+//--------------------------------------------------
+size_t ofxCsvSnapshot::getNumRows() const {
+	return numRows;
+}
+
+//--------------------------------------------------
+unsigned int ofxCsvSnapshot::getNumCols(size_t row) const {
+	if(row < numRows) {
+		return (*this)[row].size();
+	}
+	return 0;
+}
+
+//--------------------------------------------------
+const ofxCsvRow& ofxCsvSnapshot::getRow(size_t index) const {
+	static const ofxCsvRow s_emptyRow;
+	if(index >= numRows) {
+		return s_emptyRow;
+	}
+	return (*this)[index];
+}
+
+//--------------------------------------------------
+const ofxCsvRow& ofxCsvSnapshot::operator[](size_t index) const {
+	return (*blocks[index / BlockSize])[index % BlockSize];
+}
+
+//--------------------------------------------------
+size_t ofxCsvSnapshot::size() const {
+	return numRows;
+}
+
+//--------------------------------------------------
+bool ofxCsvSnapshot::empty() const {
+	return numRows == 0;
+}
+
+//--------------------------------------------------
+vector<ofxCsvRow> ofxCsvSnapshot::getRows() const {
+	vector<ofxCsvRow> rows;
+	rows.reserve(numRows);
+	for(auto &block : blocks) {
+		rows.insert(rows.end(), block->begin(), block->end());
+	}
+	return rows;
+}
+
+// VERSIONS
+
+//--------------------------------------------------
+uint64_t ofxCsvSnapshot::getVersion() const {
+	return version;
+}
+
+//--------------------------------------------------
+size_t ofxCsvSnapshot::getNumBlocks() const {
+	return blocks.size();
+}
+
+//--------------------------------------------------
+size_t ofxCsvSnapshot::getNumCopiedBlocks() const {
+	return copiedBlocks;
+}
@@ -0,0 +1,115 @@
+/**
+ *  ofxCsvSnapshot.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+/// \class ofxCsvSnapshot
+/// \brief an immutable, reference counted view of a table's rows
+///
+/// Snapshots are published by ofxCsv::publish() & obtained by any thread
+/// with ofxCsv::getSnapshot(). A snapshot never changes, so it can be read
+/// from multiple threads without locking while the table is edited,
+/// reloaded, & published again:
+///
+///     // draw or worker thread
+///     auto snapshot = csv.getSnapshot();
+///     for(size_t i = 0; i < snapshot->size(); i++) {
+///         float value = snapshot->getRow(i).getFloat(1);
+///     }
+///
+/// Rows are stored in shared blocks of BlockSize rows. Publishing reuses the
+/// blocks of the previous snapshot which weren't modified since, so an edit
+/// only copies the blocks it touched. A snapshot's memory is released when
+/// the last reference to it is dropped.
+///
+class ofxCsvSnapshot {
+
+	public:
+
+		/// Number of rows per shared block.
+		static const size_t BlockSize = 4096;
+
+		/// Constructor, creates an empty snapshot.
+		ofxCsvSnapshot();
+
+	/// \section Row Access
+
+		/// Get the number of rows.
+		size_t getNumRows() const;
+
+		/// Get the number of cols for a given row.
+		///
+		/// \returns the number of cols or 0 if the row does not exist
+		unsigned int getNumCols(size_t row=0) const;
+
+		/// Get a row at a given position.
+		///
+		/// \returns the row or an empty row if it does not exist
+		const ofxCsvRow& getRow(size_t index) const;
+
+		/// Raw row access, without range checks.
+		const ofxCsvRow& operator[](size_t index) const;
+
+		/// Alternate row size getter.
+		size_t size() const;
+
+		/// Is the snapshot empty?
+		bool empty() const;
+
+		/// Copy the rows into a vector.
+		vector<ofxCsvRow> getRows() const;
+
+	/// \section Versions
+
+		/// Get the version, incremented by each publish of a table. The
+		/// empty snapshot before the first publish is version 0.
+		uint64_t getVersion() const;
+
+		/// Get the number of row blocks.
+		size_t getNumBlocks() const;
+
+		/// Get the number of blocks copied by publish, the rest are shared
+		/// with the previous version.
+		size_t getNumCopiedBlocks() const;
+
+	protected:
+
+		friend class ofxCsv;
+
+		/// row block, shared between snapshots
+		typedef vector<ofxCsvRow> Block;
+
+		vector<std::shared_ptr<const Block>> blocks; //< row blocks
+		size_t numRows;      //< total number of rows
+		uint64_t version;    //< publish count
+		size_t copiedBlocks; //< blocks not shared with the previous version
+};
@@ -0,0 +1,402 @@
+/**
+ *  ofxCsvSorter.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvSorter.h"
+
+#include "ofxCsvColumn.h"
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+#include "ofxCsvRow.h"
+#include "ofxCsvThreadPool.h"
+#include "ofxCsvWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <queue>
+
+// most run files merged at once, limits open files
+static const size_t s_maxFanIn = 64;
+
+// replace a file with another, atomically where the platform allows
+static bool replaceFile(const string &from, const string &to) {
+	if(rename(from.c_str(), to.c_str()) == 0) {
+		return true;
+	}
+	// Windows won't rename over an existing file
+	remove(to.c_str());
+	return rename(from.c_str(), to.c_str()) == 0;
+}
+
+//--------------------------------------------------
+ofxCsvSorter::ofxCsvSorter(int col, ofxCsvSchema::Type type, bool descending) :
+	col(col), type(type), descending(descending), memoryBudget(256*1024*1024),
+	separator(","), commentPrefix("#"), numRows(0), numRuns(0), runCounter(0) {}
+
+//--------------------------------------------------
+void ofxCsvSorter::setKey(int col, ofxCsvSchema::Type type, bool descending) {
+	this->col = col;
+	this->type = type;
+	this->descending = descending;
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::setMemoryBudget(size_t bytes) {
+	memoryBudget = std::max<size_t>(bytes, 1024*1024);
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::setTempDirectory(const string &directory) {
+	tempDirectory = directory;
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::setSeparator(const string &separator) {
+	this->separator = separator;
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::setCommentPrefix(const string &comment) {
+	commentPrefix = comment;
+}
+
+//--------------------------------------------------
+bool ofxCsvSorter::sort(const string &srcPath, const string &dstPath, bool header) {
+	numRows = 0;
+	numRuns = 0;
+
+	string absoluteDst = ofxCsvFileUtils::toDataPath(dstPath);
+	string tempPath = absoluteDst + ".tmp";
+	ofxCsvCompression compression = ofxCsvReader::detectCompression(absoluteDst);
+	if(!ofxCsvReader::isSupported(compression)) {
+		OFX_CSV_LOG_ERROR << "Cannot sort to " << dstPath << ": compression format not supported";
+		return false;
+	}
+	ofxCsvReader reader;
+	if(!reader.open(ofxCsvFileUtils::toDataPath(srcPath))) {
+		OFX_CSV_LOG_ERROR << "Cannot sort " << srcPath << ": couldn't open file";
+		return false;
+	}
+
+	// read runs up to the memory budget, spilling each when full
+	vector<string> runPaths;
+	auto cleanup = [&]() {
+		for(auto &path : runPaths) {
+			remove(path.c_str());
+		}
+		remove(tempPath.c_str());
+	};
+	string headerLine;
+	bool hasHeader = false;
+	vector<Entry> run;
+	size_t runBytes = 0;
+	string line;
+	while(reader.readLine(line)) {
+		if(line.empty() || (!commentPrefix.empty() && line.compare(0, commentPrefix.size(), commentPrefix) == 0)) {
+			continue;
+		}
+		if(header && !hasHeader) {
+			headerLine = std::move(line);
+			hasHeader = true;
+			continue;
+		}
+		run.emplace_back();
+		run.back().line = std::move(line);
+		line = string();
+
+		// String keys about double the size of a row
+		size_t size = run.back().line.capacity();
+		runBytes += sizeof(Entry) + (type == ofxCsvSchema::String ? size * 2 : size);
+		numRows++;
+		if(runBytes >= memoryBudget) {
+			sortRun(run);
+			runPaths.push_back(getRunPath(absoluteDst));
+			if(!writeRun(runPaths.back(), ofxCsvCompression::None, nullptr, run)) {
+				OFX_CSV_LOG_ERROR << "Cannot sort " << srcPath << ": couldn't write temp file " << runPaths.back();
+				cleanup();
+				return false;
+			}
+			run.clear();
+			runBytes = 0;
+		}
+	}
+	if(reader.hasError()) {
+		OFX_CSV_LOG_ERROR << "Cannot sort " << srcPath << ": read error";
+		cleanup();
+		return false;
+	}
+	reader.close();
+	const string *headerPtr = (hasHeader ? &headerLine : nullptr);
+
+	// small enough to sort in memory
+	if(runPaths.empty()) {
+		sortRun(run);
+		if(!writeRun(tempPath, compression, headerPtr, run) || !replaceFile(tempPath, absoluteDst)) {
+			OFX_CSV_LOG_ERROR << "Cannot sort to " << dstPath << ": couldn't write file";
+			cleanup();
+			return false;
+		}
+		OFX_CSV_LOG_VERBOSE << "Sorted " << numRows << " rows in memory";
+		return true;
+	}
+
+	// spill the last run & free its memory for the merge
+	if(!run.empty()) {
+		sortRun(run);
+		runPaths.push_back(getRunPath(absoluteDst));
+		if(!writeRun(runPaths.back(), ofxCsvCompression::None, nullptr, run)) {
+			OFX_CSV_LOG_ERROR << "Cannot sort " << srcPath << ": couldn't write temp file " << runPaths.back();
+			cleanup();
+			return false;
+		}
+	}
+	vector<Entry>().swap(run);
+	numRuns = runPaths.size();
+	OFX_CSV_LOG_VERBOSE << "Sorting " << numRows << " rows: spilled " << numRuns << " runs";
+
+	// merge consecutive groups of runs until they can be merged at once,
+	// keeping the run order so the sort stays stable
+	while(runPaths.size() > s_maxFanIn) {
+		vector<string> merged;
+		for(size_t i = 0; i < runPaths.size(); i += s_maxFanIn) {
+			vector<string> group(runPaths.begin() + i, runPaths.begin() + std::min(i + s_maxFanIn, runPaths.size()));
+			merged.push_back(getRunPath(absoluteDst));
+			if(!mergeRuns(group, merged.back(), ofxCsvCompression::None, nullptr)) {
+				OFX_CSV_LOG_ERROR << "Cannot sort " << srcPath << ": couldn't merge temp files";
+				runPaths.insert(runPaths.end(), merged.begin(), merged.end());
+				cleanup();
+				return false;
+			}
+			for(auto &path : group) {
+				remove(path.c_str());
+			}
+		}
+		runPaths = merged;
+	}
+	if(!mergeRuns(runPaths, tempPath, compression, headerPtr) || !replaceFile(tempPath, absoluteDst)) {
+		OFX_CSV_LOG_ERROR << "Cannot sort to " << dstPath << ": couldn't merge temp files";
+		cleanup();
+		return false;
+	}
+	for(auto &path : runPaths) {
+		remove(path.c_str());
+	}
+	OFX_CSV_LOG_VERBOSE << "Sorted " << numRows << " rows";
+	return true;
+}
+
+//--------------------------------------------------
+size_t ofxCsvSorter::getNumRows() const {
+	return numRows;
+}
+
+//--------------------------------------------------
+size_t ofxCsvSorter::getNumRuns() const {
+	return numRuns;
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::parseKey(Entry &entry) const {
+	entry.missing = true;
+	if(col < 0) {
+		return;
+	}
+	vector<string> fields = ofxCsvRow::fromString(entry.line, separator, col + 1);
+	if((size_t)col >= fields.size()) {
+		return;
+	}
+	string &field = fields[col];
+	switch(type) {
+		case ofxCsvSchema::Int:
+			entry.missing = !ofxCsvColumn::parseInt(field, entry.integer);
+			break;
+		case ofxCsvSchema::Timestamp:
+			entry.missing = !ofxCsvColumn::parseTimestamp(field, entry.integer);
+			break;
+		case ofxCsvSchema::Float:
+			entry.missing = !ofxCsvColumn::parseFloat(field, entry.number) || std::isnan(entry.number);
+			break;
+		case ofxCsvSchema::Bool: {
+			bool value;
+			entry.missing = !ofxCsvColumn::parseBool(field, value);
+			entry.number = value;
+			break;
+		}
+		default:
+			entry.text = std::move(field);
+			entry.missing = false;
+			break;
+	}
+}
+
+//--------------------------------------------------
+bool ofxCsvSorter::less(const Entry &a, const Entry &b) const {
+	if(a.missing || b.missing) {
+		return !a.missing && b.missing;
+	}
+	switch(type) {
+		case ofxCsvSchema::Int: case ofxCsvSchema::Timestamp:
+			return (descending ? a.integer > b.integer : a.integer < b.integer);
+		case ofxCsvSchema::Float: case ofxCsvSchema::Bool:
+			return (descending ? a.number > b.number : a.number < b.number);
+		default: {
+			int c = a.text.compare(b.text);
+			return (descending ? c > 0 : c < 0);
+		}
+	}
+}
+
+//--------------------------------------------------
+void ofxCsvSorter::sortRun(vector<Entry> &run) const {
+	ofxCsvThreadPool &pool = ofxCsvThreadPool::shared();
+	size_t n = run.size();
+	pool.parallelFor(0, n, 4096, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			parseKey(run[i]);
+		}
+	});
+
+	// stable sort a chunk per thread, then merge neighbouring chunks pairwise
+	auto compare = [this](const Entry &a, const Entry &b) {
+		return less(a, b);
+	};
+	size_t chunk = std::max<size_t>(n / pool.getNumThreads() + 1, 16384);
+	size_t numChunks = (n + chunk - 1) / chunk;
+	pool.parallelFor(0, numChunks, 1, [&](size_t begin, size_t end) {
+		for(size_t c = begin; c < end; c++) {
+			std::stable_sort(run.begin() + c * chunk, run.begin() + std::min(n, (c + 1) * chunk), compare);
+		}
+	});
+	for(size_t width = chunk; width < n; width *= 2) {
+		size_t numPairs = (n + width * 2 - 1) / (width * 2);
+		pool.parallelFor(0, numPairs, 1, [&](size_t begin, size_t end) {
+			for(size_t p = begin; p < end; p++) {
+				size_t first = p * width * 2;
+				size_t middle = std::min(n, first + width);
+				size_t last = std::min(n, first + width * 2);
+				if(middle < last) {
+					std::inplace_merge(run.begin() + first, run.begin() + middle, run.begin() + last, compare);
+				}
+			}
+		});
+	}
+}
+
+//--------------------------------------------------
+bool ofxCsvSorter::writeRun(const string &path, ofxCsvCompression compression,
+                            const string *header, const vector<Entry> &run) const {
+	ofxCsvWriter writer;
+	if(!writer.open(path, compression)) {
+		return false;
+	}
+	if(header) {
+		writer.write(*header);
+		writer.write("\n", 1);
+	}
+	for(auto &entry : run) {
+		writer.write(entry.line);
+		writer.write("\n", 1);
+	}
+	return writer.close();
+}
+
+//--------------------------------------------------
+bool ofxCsvSorter::mergeRuns(const vector<string> &paths, const string &path,
+                             ofxCsvCompression compression, const string *header) const {
+
+	// split the budget between the run read buffers
+	size_t blockSize = std::min<size_t>(std::max<size_t>(memoryBudget / (paths.size() + 1) / 2, 64*1024), 4*1024*1024);
+	vector<std::unique_ptr<ofxCsvReader>> readers(paths.size());
+	vector<Entry> heads(paths.size());
+	auto next = [&](size_t i) {
+		if(!readers[i]->readLine(heads[i].line)) {
+			return false;
+		}
+		parseKey(heads[i]);
+		return true;
+	};
+
+	// min heap of run indices by head entry, earlier runs first for equal keys
+	auto later = [&](size_t a, size_t b) {
+		if(less(heads[b], heads[a])) {
+			return true;
+		}
+		return !less(heads[a], heads[b]) && a > b;
+	};
+	std::priority_queue<size_t, vector<size_t>, decltype(later)> heap(later);
+	for(size_t i = 0; i < paths.size(); i++) {
+		readers[i].reset(new ofxCsvReader(blockSize));
+		if(!readers[i]->open(paths[i], ofxCsvCompression::None)) {
+			return false;
+		}
+		if(next(i)) {
+			heap.push(i);
+		}
+	}
+
+	ofxCsvWriter writer;
+	if(!writer.open(path, compression)) {
+		return false;
+	}
+	if(header) {
+		writer.write(*header);
+		writer.write("\n", 1);
+	}
+	while(!heap.empty()) {
+		size_t i = heap.top();
+		heap.pop();
+		writer.write(heads[i].line);
+		writer.write("\n", 1);
+		if(next(i)) {
+			heap.push(i);
+		}
+	}
+	for(auto &reader : readers) {
+		if(reader->hasError()) {
+			writer.close();
+			return false;
+		}
+	}
+	return writer.close();
+}
+
+//--------------------------------------------------
+string ofxCsvSorter::getRunPath(const string &dstPath) {
+	string directory = tempDirectory;
+	if(directory.empty()) {
+		directory = ofxCsvFileUtils::getEnclosingDirectory(dstPath);
+	}
+	else {
+		directory = ofxCsvFileUtils::toDataPath(directory);
+	}
+	string name = ofxCsvFileUtils::getFileName(dstPath) + ".run" + std::to_string(runCounter++) + ".tmp";
+	return ofxCsvFileUtils::join(directory, name);
+}
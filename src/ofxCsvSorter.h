@@ -0,0 +1,153 @@
+/**
+ *  ofxCsvSorter.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvReader.h"
+#include "ofxCsvSchema.h"
+
+/// \class ofxCsvSorter
+/// \brief external merge sort for files larger than memory
+///
+/// Sorts the rows of a file by a key column without loading the whole file:
+///
+///   1. Reads runs of rows up to the memory budget, sorts each run in
+///      parallel on the shared thread pool & spills it to a temp file.
+///   2. Merges the sorted runs with a k-way heap merge into the output file.
+///      When there are too many runs to open at once, they are merged in
+///      several passes.
+///
+/// Input smaller than the budget is sorted in memory without temp files.
+/// The sort is stable, so rows with equal keys keep their file order.
+///
+///     ofxCsvSorter sorter(0, ofxCsvSchema::Timestamp);
+///     sorter.setMemoryBudget(1024*1024*1024); // 1 GB
+///     sorter.setTempDirectory("/scratch");
+///     sorter.sort("export.csv.gz", "export-sorted.csv.gz", true);
+///
+/// Like ofxCsv::load(), rows are read line by line, so quoted fields can't
+/// contain newlines. Empty & comment lines are dropped.
+///
+class ofxCsvSorter {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param col Key column number.
+		/// \param type Key value type: String compares bytes, Int, Float & Bool
+		///             compare numerically, Timestamp parses ISO-8601 values.
+		/// \param descending Sort largest keys first?
+		ofxCsvSorter(int col=0, ofxCsvSchema::Type type=ofxCsvSchema::String, bool descending=false);
+
+		/// Set the sort key.
+		///
+		/// Rows with missing or unparseable key values are sorted last.
+		///
+		/// \param col Key column number.
+		/// \param type Key value type.
+		/// \param descending Sort largest keys first?
+		void setKey(int col, ofxCsvSchema::Type type, bool descending=false);
+
+		/// Set the approximate amount of memory used for each sorted run,
+		/// default 256 MB. Larger budgets mean fewer runs & merge passes.
+		void setMemoryBudget(size_t bytes);
+
+		/// Set the directory for temp run files, default is the output file's
+		/// directory. Needs free space for about the size of the input.
+		void setTempDirectory(const string &directory);
+
+		/// Set the field separator, default ",".
+		void setSeparator(const string &separator);
+
+		/// Set the comment line prefix, default "#".
+		void setCommentPrefix(const string &comment);
+
+		/// Sort a file.
+		///
+		/// Input & output may be compressed, detected by file extension. The
+		/// output is written to a temp file & replaces the destination when
+		/// done, so a file can be sorted in place.
+		///
+		/// \param srcPath Input file path.
+		/// \param dstPath Output file path.
+		/// \param header Keep the first row as a header at the top?
+		/// \returns true on success
+		bool sort(const string &srcPath, const string &dstPath, bool header=false);
+
+		/// Get the number of rows sorted by the last sort() call.
+		size_t getNumRows() const;
+
+		/// Get the number of runs spilled to temp files by the last sort()
+		/// call, 0 if it was sorted in memory.
+		size_t getNumRuns() const;
+
+	protected:
+
+		/// a row & its parsed key
+		struct Entry {
+			string line;     //< row text
+			string text;     //< String key
+			int64_t integer; //< Int & Timestamp key
+			double number;   //< Float & Bool key
+			bool missing;    //< no key value?
+		};
+
+		/// parse the key of an entry's line
+		void parseKey(Entry &entry) const;
+
+		/// does an entry sort before another?
+		bool less(const Entry &a, const Entry &b) const;
+
+		/// sort a run in parallel, stable
+		void sortRun(vector<Entry> &run) const;
+
+		/// write an optional header & a sorted run to a file
+		bool writeRun(const string &path, ofxCsvCompression compression,
+		              const string *header, const vector<Entry> &run) const;
+
+		/// k-way merge sorted run files into a file
+		bool mergeRuns(const vector<string> &paths, const string &path,
+		               ofxCsvCompression compression, const string *header) const;
+
+		/// get a new temp run file path
+		string getRunPath(const string &dstPath);
+
+		int col;                 //< key column number
+		ofxCsvSchema::Type type; //< key value type
+		bool descending;         //< sort largest first?
+		size_t memoryBudget;     //< bytes per run
+		string tempDirectory;    //< temp run directory, empty for the output dir
+		string separator;        //< field separator
+		string commentPrefix;    //< comment line prefix
+		size_t numRows;          //< rows sorted by the last call
+		size_t numRuns;          //< runs spilled by the last call
+		size_t runCounter;       //< temp run file counter
+};
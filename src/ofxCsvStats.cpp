@@ -0,0 +1,65 @@
+/**
+ *  ofxCsvStats.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvStats.h"
+
+#include <sstream>
+
+//--------------------------------------------------
+string ofxCsvStats::toString() const {
+	std::ostringstream out;
+	switch(operation) {
+		case None:
+			return "no load or save";
+		case Load:
+			out << "loaded ";
+			break;
+		case Save:
+			out << "saved ";
+			break;
+	}
+	out << path << (success ? "" : " (failed)") << ": "
+	    << rows << "x" << maxCols << ", " << fields << " fields, "
+	    << bytes << " bytes";
+	if(operation == Load) {
+		out << ", " << ofxCsvDecoder::getName(encoding);
+		if(invalidSequences > 0) {
+			out << " (" << invalidSequences << " invalid)";
+		}
+		out << ", " << paddedCells << " padded, " << allocations << " allocs"
+		    << ", read " << readTime << "s, parse " << parseTime << "s, expand "
+		    << expandTime << "s";
+	}
+	else {
+		out << ", format " << formatTime << "s, write " << writeTime << "s";
+	}
+	out << ", total " << totalTime << "s";
+	return out.str();
+}
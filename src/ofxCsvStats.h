@@ -0,0 +1,84 @@
+/**
+ *  ofxCsvStats.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+#include "ofxCsvDecoder.h"
+
+/// \class ofxCsvStats
+/// \brief counts & phase timings of the last ofxCsv load or save
+///
+/// Times are wall clock seconds. Phases which don't apply to an operation
+/// are 0, ie. parse & expand for a save or format & write for a load.
+///
+/// Load phases:
+///   * read: reading & decompressing the file
+///   * parse: splitting lines into fields & parsing typed columns
+///   * expand: padding rows to the widest row
+///
+/// Save phases:
+///   * format: joining & quoting fields into lines
+///   * write: compressing & writing the file
+///
+/// Lazy loads don't split rows, so the field & cell counts stay 0.
+///
+struct ofxCsvStats {
+
+	/// the measured operation
+	enum Operation {
+		None, //< nothing loaded or saved yet
+		Load, //< load()
+		Save  //< save() or saveChanges()
+	};
+
+	Operation operation = None;
+	string path;              //< file path
+	bool success = false;     //< did the operation succeed?
+
+	uint64_t bytes = 0;       //< uncompressed bytes read or written
+	size_t rows = 0;          //< rows loaded or written
+	size_t fields = 0;        //< fields parsed or written, not counting padding
+	size_t maxCols = 0;       //< number of fields in the widest row
+	size_t paddedCells = 0;   //< empty fields added to pad short rows
+	size_t allocations = 0;   //< estimated heap allocations for the row data
+	ofxCsvEncoding encoding = ofxCsvEncoding::Auto; //< detected text encoding when loading
+	size_t invalidSequences = 0; //< invalid UTF-8 or UTF-16 sequences when loading
+
+	double readTime = 0;      //< seconds reading
+	double parseTime = 0;     //< seconds parsing
+	double expandTime = 0;    //< seconds padding rows
+	double formatTime = 0;    //< seconds formatting
+	double writeTime = 0;     //< seconds writing
+	double totalTime = 0;     //< seconds for the whole operation
+
+	/// Get a one line summary, ie. for logging.
+	string toString() const;
+};
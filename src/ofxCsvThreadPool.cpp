@@ -0,0 +1,203 @@
+/**
+ *  ofxCsvThreadPool.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvThreadPool.h"
+
+#include <exception>
+
+//--------------------------------------------------
+ofxCsvThreadPool::ofxCsvThreadPool(unsigned int threads) : pending(0), next(0), stopping(false) {
+	if(threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+	}
+	for(unsigned int i = 0; i < threads; i++) {
+		queues.push_back(std::unique_ptr<Queue>(new Queue));
+	}
+	for(unsigned int i = 0; i < threads; i++) {
+		this->threads.push_back(std::thread(&ofxCsvThreadPool::work, this, i));
+	}
+}
+
+//--------------------------------------------------
+ofxCsvThreadPool::~ofxCsvThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	for(auto &thread : threads) {
+		thread.join();
+	}
+}
+
+//--------------------------------------------------
+ofxCsvThreadPool& ofxCsvThreadPool::shared() {
+	static ofxCsvThreadPool s_pool;
+	return s_pool;
+}
+
+//--------------------------------------------------
+void ofxCsvThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize,
+                                   const std::function<void(size_t begin, size_t end)> &function) {
+	if(begin >= end) {
+		return;
+	}
+	size_t size = end - begin;
+	if(grainSize == 0) { // a few chunks per thread for balance
+		grainSize = std::max<size_t>(size / (getNumThreads() * 4), 1);
+	}
+	size_t chunks = (size + grainSize - 1) / grainSize;
+	if(chunks == 1 || queues.empty()) {
+		function(begin, end);
+		return;
+	}
+
+	// shared completion state for this call
+	struct State {
+		std::atomic<size_t> remaining;
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr exception;
+	};
+	auto state = std::make_shared<State>();
+	state->remaining = chunks;
+
+	// queue all but the first chunk, round robin across the workers
+	for(size_t c = 1; c < chunks; c++) {
+		size_t b = begin + c * grainSize;
+		size_t e = std::min(b + grainSize, end);
+		Task task = [state, &function, b, e] {
+			try {
+				function(b, e);
+			}
+			catch(...) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if(!state->exception) {
+					state->exception = std::current_exception();
+				}
+			}
+			if(--state->remaining == 0) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->done.notify_all();
+			}
+		};
+		Queue &queue = *queues[next++ % queues.size()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		pending++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+	}
+	condition.notify_all();
+
+	// run the first chunk here, then help out until everything is done
+	try {
+		function(begin, std::min(begin + grainSize, end));
+	}
+	catch(...) {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if(!state->exception) {
+			state->exception = std::current_exception();
+		}
+	}
+	state->remaining--;
+	Task task;
+	while(state->remaining > 0) {
+		if(steal(queues.size(), task)) {
+			task();
+			continue;
+		}
+		// the rest is running on other threads
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->done.wait(lock, [&state] {
+			return state->remaining == 0;
+		});
+	}
+	if(state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
+
+//--------------------------------------------------
+size_t ofxCsvThreadPool::getNumThreads() const {
+	return threads.size() + 1;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+bool ofxCsvThreadPool::pop(size_t index, Task &task) {
+	Queue &queue = *queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if(queue.tasks.empty()) {
+		return false;
+	}
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	pending--;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvThreadPool::steal(size_t index, Task &task) {
+	for(size_t i = 1; i <= queues.size(); i++) {
+		Queue &queue = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if(!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			pending--;
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------
+void ofxCsvThreadPool::work(size_t index) {
+	Task task;
+	while(true) {
+		if(pop(index, task) || steal(index, task)) {
+			task();
+			task = nullptr;
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this] {
+			return stopping || pending > 0;
+		});
+		if(stopping && pending == 0) {
+			return;
+		}
+	}
+}
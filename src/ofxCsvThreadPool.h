@@ -0,0 +1,115 @@
+/**
+ *  ofxCsvThreadPool.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/// \class ofxCsvThreadPool
+/// \brief reusable work-stealing thread pool for parallel table processing
+///
+/// Each worker thread has its own task queue & steals from the others when
+/// it runs out of work. The calling thread also runs tasks while waiting, so
+/// parallel calls can be nested safely.
+///
+/// The addon's parallel functions share a single pool:
+///
+///     ofxCsvThreadPool::shared().parallelFor(0, n, 1024, [&](size_t begin, size_t end) {
+///         for(size_t i = begin; i < end; i++) {
+///             // do something for each index
+///         }
+///     });
+///
+class ofxCsvThreadPool {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param threads Number of worker threads, 0 uses the number of
+		///                hardware threads minus one for the calling thread.
+		ofxCsvThreadPool(unsigned int threads=0);
+
+		/// Destructor, waits for running tasks & stops the workers.
+		virtual ~ofxCsvThreadPool();
+
+		/// Get the shared pool, created on first use.
+		static ofxCsvThreadPool& shared();
+
+		/// Run a function over a range of indices in parallel.
+		///
+		/// The range is split into chunks of grainSize indices which are
+		/// processed by the workers & the calling thread. Returns when all
+		/// chunks are done. The first exception thrown by a chunk is rethrown.
+		///
+		/// \param begin First index.
+		/// \param end One past the last index.
+		/// \param grainSize Indices per chunk, 0 chooses automatically.
+		/// \param function Chunk function, called with a sub range.
+		void parallelFor(size_t begin, size_t end, size_t grainSize,
+		                 const std::function<void(size_t begin, size_t end)> &function);
+
+		/// Get the number of threads used for parallel work, including the
+		/// calling thread.
+		size_t getNumThreads() const;
+
+	protected:
+
+		typedef std::function<void()> Task;
+
+		/// per-worker task queue
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		/// take a task from a worker's own queue, newest first
+		bool pop(size_t index, Task &task);
+
+		/// take a task from any other queue, oldest first
+		bool steal(size_t index, Task &task);
+
+		/// worker thread loop
+		void work(size_t index);
+
+		vector<std::unique_ptr<Queue>> queues; //< task queues, one per worker
+		vector<std::thread> threads;           //< worker threads
+		std::mutex mutex;                      //< guards sleeping
+		std::condition_variable condition;     //< wakes sleeping workers
+		std::atomic<size_t> pending;           //< number of queued tasks
+		std::atomic<size_t> next;              //< round robin queue index
+		bool stopping;                         //< are the workers stopping?
+};
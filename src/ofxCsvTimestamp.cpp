@@ -0,0 +1,358 @@
+/**
+ *  ofxCsvTimestamp.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvTimestamp.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	#define OFX_CSV_BIG_ENDIAN
+#endif
+
+// is a char surrounding whitespace?
+static inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// parse a fixed number of decimal digits, returns -1 on failure
+static inline int parseDigits(const char *p, int count) {
+	int v = 0;
+	for(int i = 0; i < count; i++) {
+		if(p[i] < '0' || p[i] > '9') {
+			return -1;
+		}
+		v = v * 10 + (p[i] - '0');
+	}
+	return v;
+}
+
+// number of days in a month of a given year
+static inline int daysInMonth(int year, int month) {
+	static const int s_days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	if(month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+		return 29;
+	}
+	return s_days[month-1];
+}
+
+// nanoseconds per unit of a fraction with a given number of digits
+static const int64_t s_scales[10] = {
+	1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+#ifndef OFX_CSV_BIG_ENDIAN
+
+// decode the digit pairs of 8 characters, the first character in the low
+// byte, where mask selects the digit bytes: returns false if a digit byte is
+// not 0-9, otherwise byte i of pairs is the 2 digit value starting at i
+static inline bool decodePairs(const char *p, uint64_t mask, uint64_t &pairs) {
+	uint64_t chunk;
+	memcpy(&chunk, p, 8);
+	// '0'-'9' are 0x30-0x39, so xor leaves 0-9 without borrows between bytes
+	uint64_t v = (chunk ^ 0x3030303030303030ULL) & mask;
+	// a byte > 9 has its high bit set either before or after adding 0x76
+	if(((v | (v + 0x7676767676767676ULL)) & 0x8080808080808080ULL & mask) != 0) {
+		return false;
+	}
+	pairs = v * 10 + (v >> 8);
+	return true;
+}
+
+// decode the fixed-width layout YYYY-MM-DD[T ]HH:MM:SS, 19 characters
+static inline bool parseFixed(const char *p, int &year, int &month, int &day,
+                              int &hour, int &minute, int &second) {
+	uint64_t date, time;
+	if(p[4] != '-' || p[7] != '-' || (p[10] != 'T' && p[10] != ' ') ||
+	   p[13] != ':' || p[16] != ':') {
+		return false;
+	}
+	// "YYYY-MM-": digits in bytes 0-3 & 5-6
+	// "DDTHH:MM": digits in bytes 0-1, 3-4, & 6-7
+	if(!decodePairs(p, 0x00FFFF00FFFFFFFFULL, date) ||
+	   !decodePairs(p+8, 0xFFFF00FFFF00FFFFULL, time)) {
+		return false;
+	}
+	year = (date & 0xFF) * 100 + ((date >> 16) & 0xFF);
+	month = (date >> 40) & 0xFF;
+	day = time & 0xFF;
+	hour = (time >> 24) & 0xFF;
+	minute = (time >> 48) & 0xFF;
+	second = parseDigits(p+17, 2);
+	return second >= 0;
+}
+
+#endif
+
+//--------------------------------------------------
+bool ofxCsvTimestamp::parse(const char *text, size_t size, int64_t &nanos, Format format) {
+	const char *p = text, *end = text + size;
+	while(p < end && isSpace(*p)) {p++;}
+	while(end > p && isSpace(*(end-1))) {end--;}
+	switch(format) {
+		case Iso8601: return parseIso8601(p, end, nanos);
+		case Seconds: return parseUnix(p, end, 1, nanos);
+		case Millis:  return parseUnix(p, end, 1000, nanos);
+		case Micros:  return parseUnix(p, end, 1000000, nanos);
+		case Nanos:   return parseUnix(p, end, 1000000000, nanos);
+	}
+	return false;
+}
+
+//--------------------------------------------------
+bool ofxCsvTimestamp::parse(const std::string &field, int64_t &nanos, Format format) {
+	return parse(field.c_str(), field.size(), nanos, format);
+}
+
+//--------------------------------------------------
+int64_t ofxCsvTimestamp::daysFromCivil(int64_t y, unsigned int m, unsigned int d) {
+	// from http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+	y -= m <= 2;
+	const int64_t era = (y >= 0 ? y : y-399) / 400;
+	const unsigned yoe = static_cast<unsigned>(y - era * 400);
+	const unsigned doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;
+	const unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+//--------------------------------------------------
+void ofxCsvTimestamp::civilFromDays(int64_t z, int64_t &y, unsigned int &m, unsigned int &d) {
+	// from http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+	z += 719468;
+	const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = static_cast<unsigned>(z - era * 146097);
+	const unsigned yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	const unsigned doy = doe - (365*yoe + yoe/4 - yoe/100);
+	const unsigned mp = (5*doy + 2)/153;
+	d = doy - (153*mp+2)/5 + 1;
+	m = (mp < 10 ? mp+3 : mp-9);
+	y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+//--------------------------------------------------
+std::string ofxCsvTimestamp::toString(int64_t nanos, bool dateOnly) {
+	const int64_t nanosPerDay = 86400 * 1000000000LL;
+	int64_t days = nanos / nanosPerDay;
+	int64_t rest = nanos % nanosPerDay;
+	if(rest < 0) { // floor for times before the epoch
+		days--;
+		rest += nanosPerDay;
+	}
+	int64_t year;
+	unsigned int month, day;
+	civilFromDays(days, year, month, day);
+	char buffer[48];
+	if(dateOnly) {
+		snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u", (long long)year, month, day);
+		return buffer;
+	}
+	int64_t seconds = rest / 1000000000LL;
+	int64_t fraction = rest % 1000000000LL;
+	int len = snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02d:%02d:%02d",
+	                   (long long)year, month, day, (int)(seconds / 3600),
+	                   (int)(seconds / 60 % 60), (int)(seconds % 60));
+	if(fraction % 1000000 == 0 && fraction != 0) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, ".%03d", (int)(fraction / 1000000));
+	}
+	else if(fraction % 1000 == 0 && fraction != 0) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, ".%06d", (int)(fraction / 1000));
+	}
+	else if(fraction != 0) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, ".%09d", (int)fraction);
+	}
+	snprintf(buffer + len, sizeof(buffer) - len, "Z");
+	return buffer;
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+bool ofxCsvTimestamp::parseIso8601(const char *p, const char *end, int64_t &nanos) {
+	int year = 0, month = 0, day = 0;
+	int hour = 0, minute = 0, second = 0;
+	int64_t fraction = 0;
+	bool hasSeconds = false;
+
+#ifndef OFX_CSV_BIG_ENDIAN
+	// fast path: YYYY-MM-DDTHH:MM:SS
+	if(end - p >= 19 && parseFixed(p, year, month, day, hour, minute, second)) {
+		p += 19;
+		hasSeconds = true;
+		if(month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) ||
+		   hour > 23 || minute > 59 || second > 60) {
+			return false;
+		}
+	}
+	else
+#endif
+	{
+		// date: YYYY-MM-DD
+		if(end - p < 10 || p[4] != '-' || p[7] != '-') {
+			return false;
+		}
+		year = parseDigits(p, 4);
+		month = parseDigits(p+5, 2);
+		day = parseDigits(p+8, 2);
+		if(year < 0 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+			return false;
+		}
+		p += 10;
+
+		// time: [T ]HH:MM[:SS]
+		if(p < end && (*p == 'T' || *p == ' ')) {
+			if(end - p < 6 || p[3] != ':') {
+				return false;
+			}
+			hour = parseDigits(p+1, 2);
+			minute = parseDigits(p+4, 2);
+			if(hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+				return false;
+			}
+			p += 6;
+			if(p < end && *p == ':') {
+				if(end - p < 3 || (second = parseDigits(p+1, 2)) < 0 || second > 60) {
+					return false;
+				}
+				p += 3;
+				hasSeconds = true;
+			}
+		}
+	}
+
+	// fraction: .fraction, extra digits past nanoseconds are truncated
+	if(hasSeconds && p < end && (*p == '.' || *p == ',')) {
+		p++;
+		int digits = 0;
+		while(p < end && *p >= '0' && *p <= '9') {
+			if(digits < 9) {
+				fraction = fraction * 10 + (*p - '0');
+				digits++;
+			}
+			p++;
+		}
+		if(digits == 0) {
+			return false;
+		}
+		fraction *= s_scales[digits];
+	}
+
+	// UTC offset: Z, +HH:MM, +HHMM, or +HH
+	int offset = 0;
+	if(p < end) {
+		if(*p == 'Z' || *p == 'z') {
+			p++;
+		}
+		else if(*p == '+' || *p == '-') {
+			int sign = (*p == '-' ? -1 : 1);
+			p++;
+			int oh = (end - p >= 2 ? parseDigits(p, 2) : -1), om = 0;
+			if(oh < 0) {
+				return false;
+			}
+			p += 2;
+			if(p < end && *p == ':') {p++;}
+			if(p < end) {
+				if(end - p < 2 || (om = parseDigits(p, 2)) < 0) {
+					return false;
+				}
+				p += 2;
+			}
+			offset = sign * (oh * 3600 + om * 60);
+		}
+	}
+	if(p != end) {
+		return false;
+	}
+
+	// reject dates outside the 64 bit nanosecond range
+	const int64_t nanosPerSecond = 1000000000LL;
+	int64_t total = daysFromCivil(year, month, day) * 86400 +
+	                hour * 3600 + minute * 60 + second - offset;
+	if(total > INT64_MAX / nanosPerSecond ||
+	   (total == INT64_MAX / nanosPerSecond && fraction > INT64_MAX % nanosPerSecond) ||
+	   total < INT64_MIN / nanosPerSecond) {
+		return false;
+	}
+	nanos = total * nanosPerSecond + fraction;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvTimestamp::parseUnix(const char *p, const char *end, int64_t unitsPerSecond, int64_t &nanos) {
+	bool negative = false;
+	if(p < end && (*p == '-' || *p == '+')) {
+		negative = (*p == '-');
+		p++;
+	}
+
+	// whole units, limited so the result fits in 64 bits
+	const int64_t nanosPerUnit = 1000000000LL / unitsPerSecond;
+	const uint64_t limit = INT64_MAX / nanosPerUnit;
+	uint64_t units = 0;
+	const char *digits = p;
+	while(p < end && *p >= '0' && *p <= '9') {
+		unsigned digit = *p - '0';
+		if(units > (limit - digit) / 10) {
+			return false;
+		}
+		units = units * 10 + digit;
+		p++;
+	}
+	bool whole = (p != digits);
+
+	// fraction of a unit, extra digits past nanoseconds are truncated
+	int64_t fraction = 0;
+	if(p < end && *p == '.') {
+		p++;
+		int64_t scale = nanosPerUnit;
+		const char *fractionDigits = p;
+		while(p < end && *p >= '0' && *p <= '9') {
+			scale /= 10;
+			fraction += (*p - '0') * scale;
+			p++;
+		}
+		if(p == fractionDigits && !whole) {
+			return false;
+		}
+	}
+	else if(!whole) {
+		return false;
+	}
+	if(p != end) {
+		return false;
+	}
+	int64_t value = static_cast<int64_t>(units) * nanosPerUnit;
+	if(value > INT64_MAX - fraction) {
+		return false;
+	}
+	value += fraction;
+	nanos = (negative ? -value : value);
+	return true;
+}
@@ -0,0 +1,109 @@
+/**
+ *  ofxCsvTimestamp.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvConstants.h"
+
+#include <cstdint>
+#include <string>
+
+/// \class ofxCsvTimestamp
+/// \brief fast timestamp field parsing into nanoseconds since the Unix epoch
+///
+/// Decodes directly from the field text without allocating. ISO-8601 fields
+/// in the common fixed-width layout, ie. 2019-05-15T12:00:01, are validated
+/// & decoded 8 characters at a time with SWAR (SIMD within a register)
+/// arithmetic; other layouts fall back to a scalar parser.
+///
+///     int64_t nanos;
+///     if(ofxCsvTimestamp::parse("2019-05-15T12:00:01.250Z", nanos)) {
+///         // nanos == 1557921601250000000
+///     }
+///     ofxCsvTimestamp::parse("1557921601250", nanos, ofxCsvTimestamp::Millis);
+///
+class ofxCsvTimestamp {
+
+	public:
+
+		/// Timestamp field format
+		enum Format {
+			Iso8601, //< ISO-8601 date & optional time, fraction, & UTC offset
+			Seconds, //< Unix seconds with optional fraction, ie. 1557921601.25
+			Millis,  //< Unix milliseconds
+			Micros,  //< Unix microseconds
+			Nanos    //< Unix nanoseconds
+		};
+
+		/// Value used for missing or invalid timestamps by column extraction
+		static constexpr int64_t Missing = INT64_MIN;
+
+		/// Parse a field as a timestamp.
+		///
+		/// ISO-8601 accepts a date with optional time, fractional seconds, &
+		/// UTC offset: 2019-05-15, 2019-05-15 12:00, 2019-05-15T12:00:01.250Z,
+		/// or 2019-05-15T12:00:01+02:00. Unix formats accept an optional sign
+		/// & fraction. Surrounding whitespace is ignored. Timestamps outside
+		/// the 64 bit nanosecond range, about 1677-09-21 to 2262-04-11, &
+		/// invalid dates like 2019-02-31 are rejected.
+		///
+		/// \param text Field text, does not need to be null terminated.
+		/// \param size Field size in bytes.
+		/// \param nanos Set to nanoseconds since the Unix epoch.
+		/// \param format Field format. default Iso8601
+		/// \returns true on success
+		static bool parse(const char *text, size_t size, int64_t &nanos, Format format=Iso8601);
+
+		/// Parse a field as a timestamp.
+		static bool parse(const std::string &field, int64_t &nanos, Format format=Iso8601);
+
+		/// Format a timestamp as ISO-8601 UTC, ie. 2019-05-15T12:00:01.250Z.
+		///
+		/// Fractional seconds are written with 3, 6, or 9 digits, as needed.
+		///
+		/// \param nanos Nanoseconds since the Unix epoch.
+		/// \param dateOnly Write the date only, ie. 2019-05-15? default false
+		/// \returns formatted timestamp
+		static std::string toString(int64_t nanos, bool dateOnly=false);
+
+		/// Get the number of days since 1970-01-01 for a proleptic Gregorian date.
+		static int64_t daysFromCivil(int64_t year, unsigned int month, unsigned int day);
+
+		/// Get the proleptic Gregorian date for a number of days since 1970-01-01.
+		static void civilFromDays(int64_t days, int64_t &year, unsigned int &month, unsigned int &day);
+
+	protected:
+
+		/// parse a trimmed ISO-8601 field
+		static bool parseIso8601(const char *p, const char *end, int64_t &nanos);
+
+		/// parse a trimmed Unix time field with a given number of units per second
+		static bool parseUnix(const char *p, const char *end, int64_t unitsPerSecond, int64_t &nanos);
+};
@@ -0,0 +1,477 @@
+/**
+ *  ofxCsvTyped.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvRow.h"
+
+#include "ofxCsvFileUtils.h"
+#include "ofxCsvLog.h"
+#include "ofxCsvReader.h"
+
+#include <limits>
+#include <tuple>
+#include <utility>
+
+/// \class ofxCsvTypedField
+/// \brief parses a single field range into a value of a given type
+///
+/// Specialized for integers, floating point, bool, & string. Specialize for
+/// your own types to use them with ofxCsvTyped:
+///
+///     template<> struct ofxCsvTypedField<MyType> {
+///         static void parse(const char *begin, const char *end, MyType &value) {...}
+///     };
+///
+/// Fields which can't be parsed or are out of range are set to 0, false, or
+/// empty.
+template<typename T, typename Enable=void>
+struct ofxCsvTypedField;
+
+/// integer fields
+template<typename T>
+struct ofxCsvTypedField<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+	static inline void parse(const char *begin, const char *end, T &value) {
+		while(begin < end && (*begin == ' ' || *begin == '\t')) {begin++;}
+		bool negative = false;
+		if(begin < end && (*begin == '-' || *begin == '+')) {
+			negative = (*begin == '-');
+			begin++;
+		}
+		typedef typename std::make_unsigned<T>::type U;
+		const U max = (U)std::numeric_limits<T>::max();
+		const U limit = negative ? (std::is_signed<T>::value ? (U)(max + 1) : (U)0) : max;
+		U v = 0;
+		for(; begin < end && *begin >= '0' && *begin <= '9'; begin++) {
+			U digit = (U)(*begin - '0');
+			if(v > limit / 10 || (v == limit / 10 && digit > limit % 10)) {
+				value = 0; // out of range
+				return;
+			}
+			v = (U)(v * 10 + digit);
+		}
+		value = negative ? (T)(0 - v) : (T)v;
+	}
+};
+
+/// floating point fields
+///
+/// Simple decimals with up to 19 significant digits & a small exponent are
+/// converted exactly without a library call, anything else uses strtod().
+template<typename T>
+struct ofxCsvTypedField<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+	static inline void parse(const char *begin, const char *end, T &value) {
+		static const double s_pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		while(begin < end && (*begin == ' ' || *begin == '\t')) {begin++;}
+		while(end > begin && (*(end-1) == ' ' || *(end-1) == '\t' || *(end-1) == '\r')) {end--;}
+		const char *p = begin;
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+')) {
+			negative = (*p == '-');
+			p++;
+		}
+		uint64_t mantissa = 0;
+		int digits = 0, exponent = 0;
+		for(; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+			mantissa = mantissa * 10 + (*p - '0');
+		}
+		if(p < end && *p == '.') {
+			for(p++; p < end && *p >= '0' && *p <= '9'; p++, digits++, exponent--) {
+				mantissa = mantissa * 10 + (*p - '0');
+			}
+		}
+		if(p < end && (*p == 'e' || *p == 'E')) {
+			const char *e = p+1;
+			bool negativeExponent = false;
+			if(e < end && (*e == '-' || *e == '+')) {
+				negativeExponent = (*e == '-');
+				e++;
+			}
+			int v = 0;
+			const char *start = e;
+			for(; e < end && *e >= '0' && *e <= '9' && v < 10000; e++) {
+				v = v * 10 + (*e - '0');
+			}
+			if(e > start) {
+				exponent += (negativeExponent ? -v : v);
+				p = e;
+			}
+		}
+		if(p == end && digits > 0 && digits <= 19 && mantissa <= (1ULL << 53) &&
+		   exponent >= -22 && exponent <= 22) {
+			// exact: both the mantissa & the power of 10 are representable
+			double v = (double)mantissa;
+			v = (exponent < 0 ? v / s_pow10[-exponent] : v * s_pow10[exponent]);
+			value = (T)(negative ? -v : v);
+			return;
+		}
+		if(digits == 0) {
+			value = 0;
+			return;
+		}
+		// slow path, copy into a terminated buffer
+		char buffer[64];
+		size_t len = end - begin;
+		if(len < sizeof(buffer)) {
+			memcpy(buffer, begin, len);
+			buffer[len] = '\0';
+			value = (T)strtod(buffer, nullptr);
+		}
+		else {
+			value = (T)strtod(string(begin, end).c_str(), nullptr);
+		}
+	}
+};
+
+/// boolean fields: "true" or a non-zero number
+template<>
+struct ofxCsvTypedField<bool> {
+	static inline void parse(const char *begin, const char *end, bool &value) {
+		while(begin < end && (*begin == ' ' || *begin == '\t')) {begin++;}
+		size_t len = end - begin;
+		if(len >= 4 && (begin[0] | 0x20) == 't' && (begin[1] | 0x20) == 'r' &&
+		   (begin[2] | 0x20) == 'u' && (begin[3] | 0x20) == 'e') {
+			value = true;
+			return;
+		}
+		long v = 0;
+		ofxCsvTypedField<long>::parse(begin, end, v);
+		value = (v != 0);
+	}
+};
+
+/// string fields
+template<>
+struct ofxCsvTypedField<string> {
+	static inline void parse(const char *begin, const char *end, string &value) {
+		value.assign(begin, end);
+	}
+};
+
+/// \class ofxCsvTyped
+/// \brief table data parsed straight into typed tuples or structs
+///
+/// The column types are fixed at compile time & each field is converted
+/// directly from the file buffer without creating intermediate strings:
+///
+///     ofxCsvTyped<float, float, int, string> points;
+///     points.load("points.csv", true); // skip header
+///     for(auto &p : points) {
+///         float x = std::get<0>(p);
+///         ...
+///     }
+///
+/// or into a vector of your own structs via member pointers:
+///
+///     struct Point {float x, y; int id; string name;};
+///     vector<Point> points;
+///     ofxCsvTyped<float, float, int, string> csv;
+///     csv.load("points.csv", points, true, &Point::x, &Point::y, &Point::id, &Point::name);
+///
+/// Lines are split & quoted fields are handled the same way as
+/// ofxCsvRow::fromString(). Missing fields are set to 0, false, or empty &
+/// extra fields are ignored.
+///
+template<typename... Ts>
+class ofxCsvTyped {
+
+	public:
+
+		/// Row tuple type
+		typedef std::tuple<Ts...> Row;
+
+		/// Number of columns
+		static const size_t numCols = sizeof...(Ts);
+
+		/// Constructor.
+		///
+		/// \param separator Field separator string, default comma ",".
+		/// \param comment Comment line prefix string, default "#".
+		ofxCsvTyped(const string &separator=",", const string &comment="#") :
+			separator(separator), comment(comment) {}
+
+	/// \section File IO
+
+		/// Load a CSV file into row tuples.
+		///
+		/// Clears any currently loaded data.
+		///
+		/// \param path File path to load.
+		/// \param header Is the first line a header? If so, the fields are
+		///               kept as strings & are available via getHeader().
+		/// \returns true if the file loaded successfully
+		bool load(const string &path, bool header=false) {
+			clear();
+			string text;
+			if(!readFile(path, text)) {
+				return false;
+			}
+			parse(text.data(), text.size(), header);
+			return true;
+		}
+
+		/// Load a CSV file into structs via member pointers.
+		///
+		/// Appends to the given vector. The member types must match the
+		/// column types.
+		///
+		/// \param path File path to load.
+		/// \param rows Vector to append to.
+		/// \param header Is the first line a header?
+		/// \param fields Member pointers, one for each column.
+		/// \returns true if the file loaded successfully
+		template<typename T>
+		bool load(const string &path, vector<T> &rows, bool header, Ts T::*... fields) {
+			string text;
+			if(!readFile(path, text)) {
+				return false;
+			}
+			parse(text.data(), text.size(), rows, header, fields...);
+			return true;
+		}
+
+		/// Parse CSV text into row tuples.
+		///
+		/// Clears any currently loaded data.
+		///
+		/// \param text CSV text to parse.
+		/// \param size Text length in bytes.
+		/// \param header Is the first line a header?
+		void parse(const char *text, size_t size, bool header=false) {
+			clear();
+			const char *end = text + size;
+			data.reserve(countLines(text, end));
+			forEachLine(text, end, header, [this](const char *b, const char *e) {
+				data.emplace_back();
+				parseRow(b, e, data.back(), std::index_sequence_for<Ts...>());
+			});
+		}
+
+		/// Parse CSV text into structs via member pointers.
+		///
+		/// Appends to the given vector.
+		///
+		/// \param text CSV text to parse.
+		/// \param size Text length in bytes.
+		/// \param rows Vector to append to.
+		/// \param header Is the first line a header?
+		/// \param fields Member pointers, one for each column.
+		template<typename T>
+		void parse(const char *text, size_t size, vector<T> &rows, bool header, Ts T::*... fields) {
+			const char *end = text + size;
+			rows.reserve(rows.size() + countLines(text, end));
+			forEachLine(text, end, header, [&](const char *b, const char *e) {
+				rows.emplace_back();
+				T &row = rows.back();
+				parseFields(b, e, (row.*fields)...);
+			});
+		}
+
+		/// Clear the current rows & header.
+		void clear() {
+			data.clear();
+			header.clear();
+		}
+
+	/// \section Access
+
+		/// Get the header fields, empty if there is no header.
+		const vector<string>& getHeader() const {return header;}
+
+		/// Get the underlying vector.
+		vector<Row>& getData() {return data;}
+		const vector<Row>& getData() const {return data;}
+
+		/// Get the current number of rows.
+		size_t size() const {return data.size();}
+
+		/// Is the table empty?
+		bool empty() const {return data.empty();}
+
+		/// Row access via index.
+		Row& operator[](size_t index) {return data[index];}
+		const Row& operator[](size_t index) const {return data[index];}
+
+		// iterator wrappers for easy looping
+		typename vector<Row>::iterator begin() {return data.begin();}
+		typename vector<Row>::iterator end() {return data.end();}
+		typename vector<Row>::const_iterator begin() const {return data.begin();}
+		typename vector<Row>::const_iterator end() const {return data.end();}
+
+	protected:
+
+		/// read a whole file, logs any errors
+		bool readFile(const string &path, string &text) {
+			string absolutePath = ofxCsvFileUtils::toDataPath(path);
+			if(!ofxCsvFileUtils::exists(absolutePath) || ofxCsvFileUtils::isDirectory(absolutePath)) {
+				OFX_CSV_LOG_ERROR << "Cannot load " << path << ": file not found";
+				return false;
+			}
+			ofxCsvReader reader;
+			if(!reader.open(absolutePath) || !reader.readAll(text)) {
+				OFX_CSV_LOG_ERROR << "Cannot load " << path << ": couldn't read file";
+				return false;
+			}
+			return true;
+		}
+
+		/// count lines for reserving rows, an upper bound as empty & comment
+		/// lines are included
+		static size_t countLines(const char *begin, const char *end) {
+			size_t count = 0;
+			while(begin < end && (begin = (const char *)memchr(begin, '\n', end - begin))) {
+				count++;
+				begin++;
+			}
+			return count + 1;
+		}
+
+		/// call a function with the bounds of each non-empty, non-comment line,
+		/// reads the header first if required
+		template<typename F>
+		void forEachLine(const char *begin, const char *end, bool readHeader, F function) {
+			while(begin < end) {
+				const char *next = (const char *)memchr(begin, '\n', end - begin);
+				const char *lineEnd = (next ? next : end);
+				next = (next ? next+1 : end);
+				if(lineEnd > begin && *(lineEnd-1) == '\r') {
+					lineEnd--;
+				}
+				if(lineEnd == begin ||
+				   (!comment.empty() && (size_t)(lineEnd - begin) >= comment.size() &&
+				    memcmp(begin, comment.data(), comment.size()) == 0)) {
+					begin = next;
+					continue;
+				}
+				if(readHeader) {
+					header = ofxCsvRow::fromString(string(begin, lineEnd), separator);
+					readHeader = false;
+				}
+				else {
+					function(begin, lineEnd);
+				}
+				begin = next;
+			}
+		}
+
+		/// parse a line into a tuple
+		template<size_t... I>
+		void parseRow(const char *begin, const char *end, Row &row, std::index_sequence<I...>) {
+			parseFields(begin, end, std::get<I>(row)...);
+		}
+
+		/// parse a line into each given destination in order
+		template<typename... Fs>
+		void parseFields(const char *begin, const char *end, Fs &... values) {
+			const char *p = begin;
+			int unused[] = {0, (parseNext(p, end, values), 0)...};
+			(void)unused;
+		}
+
+		/// parse the next field & advance past its separator
+		template<typename F>
+		void parseNext(const char *&p, const char *end, F &value) {
+			if(!p) { // missing field
+				value = F();
+				return;
+			}
+			const char sepStart = (separator.empty() ? ',' : separator[0]);
+			const char *fieldEnd = p;
+			while(fieldEnd < end && *fieldEnd != sepStart && *fieldEnd != '"') {
+				fieldEnd++;
+			}
+			if(fieldEnd < end && *fieldEnd == '"') {
+				// quoted, unescape into scratch
+				scratch.assign(p, fieldEnd);
+				fieldEnd = unquote(fieldEnd, end, scratch);
+				ofxCsvTypedField<F>::parse(scratch.data(), scratch.data()+scratch.size(), value);
+			}
+			else {
+				ofxCsvTypedField<F>::parse(p, fieldEnd, value);
+			}
+			p = skipSeparator(fieldEnd, end);
+		}
+
+		/// unquote a field starting at the first quote, appending to a string
+		/// \returns position of the field separator or end
+		const char* unquote(const char *p, const char *end, string &field) const {
+			const char sepStart = (separator.empty() ? ',' : separator[0]);
+			bool quoted = false;
+			for(; p < end; p++) {
+				char c = *p;
+				if(quoted) {
+					if(c == '"') {
+						if(p+1 < end && p[1] == '"') { // "" -> "
+							field += '"';
+							p++;
+						}
+						else {
+							quoted = false;
+						}
+					}
+					else {
+						field += c;
+					}
+				}
+				else if(c == '"') {
+					quoted = true;
+				}
+				else if(c == sepStart) {
+					break;
+				}
+				else {
+					field += c;
+				}
+			}
+			return p;
+		}
+
+		/// skip a separator at the end of a field
+		/// \returns the start of the next field or nullptr if none
+		const char* skipSeparator(const char *p, const char *end) const {
+			if(p >= end) {
+				return nullptr;
+			}
+			p++; // separator start
+			for(size_t s = 1; s < separator.size() && p < end && *p == separator[s]; s++) {
+				p++;
+			}
+			return p;
+		}
+
+		vector<Row> data;      //< row tuples
+		vector<string> header; //< header fields
+		string separator;      //< field separator
+		string comment;        //< comment line prefix
+		string scratch;        //< unquoting buffer
+};
@@ -0,0 +1,285 @@
+/**
+ *  ofxCsvWriter.cpp
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#include "ofxCsvWriter.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <zlib.h>
+#ifdef OFX_CSV_ZSTD
+	#include <zstd.h>
+#endif
+
+//--------------------------------------------------
+ofxCsvWriter::ofxCsvWriter(size_t bufferSize) :
+	compression(ofxCsvCompression::None), level(0), file(nullptr), zstd(nullptr),
+	error(false), bufferLen(0), bytesWritten(0), writeTime(0) {
+	buffer.resize(std::max<size_t>(bufferSize, 1024));
+}
+
+//--------------------------------------------------
+ofxCsvWriter::~ofxCsvWriter() {
+	close();
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::open(const string &path, ofxCsvCompression compression, bool append) {
+	close();
+	error = false;
+	bytesWritten = 0;
+	writeTime = 0;
+	if(compression == ofxCsvCompression::Auto) {
+		compression = ofxCsvReader::detectCompression(path);
+	}
+	if(!ofxCsvReader::isSupported(compression)) {
+		error = true;
+		return false;
+	}
+	this->compression = compression;
+	switch(compression) {
+		case ofxCsvCompression::Gzip: {
+			string mode = (append ? "ab" : "wb");
+			if(level > 0) {
+				mode += std::to_string(std::min(level, 9));
+			}
+			gzFile gz = gzopen(path.c_str(), mode.c_str());
+			if(gz) {
+				gzbuffer(gz, buffer.size());
+			}
+			file = gz;
+			break;
+		}
+		case ofxCsvCompression::Zstd:
+		#ifdef OFX_CSV_ZSTD
+			file = fopen(path.c_str(), (append ? "ab" : "wb"));
+			zstd = ZSTD_createCStream();
+			ZSTD_initCStream((ZSTD_CStream *)zstd, (level > 0 ? level : ZSTD_CLEVEL_DEFAULT));
+			output.resize(ZSTD_CStreamOutSize());
+		#endif
+			break;
+		default:
+			file = fopen(path.c_str(), (append ? "ab" : "wb"));
+			break;
+	}
+	if(!file) {
+		close();
+		error = true;
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::close() {
+	if(!file) {
+		return !error;
+	}
+	flushBuffer();
+	auto start = std::chrono::steady_clock::now();
+#ifdef OFX_CSV_ZSTD
+	if(zstd) {
+		// finish the frame
+		size_t remaining = 1;
+		while(remaining > 0 && !error) {
+			ZSTD_outBuffer out = {output.data(), output.size(), 0};
+			remaining = ZSTD_endStream((ZSTD_CStream *)zstd, &out);
+			if(ZSTD_isError(remaining) ||
+			   fwrite(output.data(), 1, out.pos, (FILE *)file) != out.pos) {
+				error = true;
+			}
+		}
+		ZSTD_freeCStream((ZSTD_CStream *)zstd);
+		zstd = nullptr;
+	}
+#endif
+	if(compression == ofxCsvCompression::Gzip) {
+		if(gzclose((gzFile)file) != Z_OK) {
+			error = true;
+		}
+	}
+	else if(fclose((FILE *)file) != 0) {
+		error = true;
+	}
+	writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	file = nullptr;
+	return !error;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::isOpen() const {
+	return file != nullptr;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::write(const char *data, size_t size) {
+	if(!file || error) {
+		return false;
+	}
+	bytesWritten += size;
+	if(bufferLen + size > buffer.size()) {
+		if(!flushBuffer()) {
+			return false;
+		}
+		if(size >= buffer.size()) { // too big to buffer
+			auto start = std::chrono::steady_clock::now();
+			bool ret = writeRaw(data, size);
+			writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			return ret;
+		}
+	}
+	if(size > 0) {
+		memcpy(buffer.data() + bufferLen, data, size);
+		bufferLen += size;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::write(const string &text) {
+	return write(text.data(), text.size());
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::flush() {
+	if(!file) {
+		return !error;
+	}
+	if(!flushBuffer()) {
+		return false;
+	}
+	auto start = std::chrono::steady_clock::now();
+	switch(compression) {
+		case ofxCsvCompression::Gzip:
+			if(gzflush((gzFile)file, Z_SYNC_FLUSH) != Z_OK) {
+				error = true;
+			}
+			break;
+	#ifdef OFX_CSV_ZSTD
+		case ofxCsvCompression::Zstd: {
+			size_t remaining = 1;
+			while(remaining > 0 && !error) {
+				ZSTD_outBuffer out = {output.data(), output.size(), 0};
+				remaining = ZSTD_flushStream((ZSTD_CStream *)zstd, &out);
+				if(ZSTD_isError(remaining) ||
+				   fwrite(output.data(), 1, out.pos, (FILE *)file) != out.pos) {
+					error = true;
+				}
+			}
+			if(!error && fflush((FILE *)file) != 0) {
+				error = true;
+			}
+			break;
+		}
+	#endif
+		default:
+			if(fflush((FILE *)file) != 0) {
+				error = true;
+			}
+			break;
+	}
+	writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return !error;
+}
+
+//--------------------------------------------------
+uint64_t ofxCsvWriter::getBytesWritten() const {
+	return bytesWritten;
+}
+
+//--------------------------------------------------
+double ofxCsvWriter::getWriteTime() const {
+	return writeTime;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::hasError() const {
+	return error;
+}
+
+//--------------------------------------------------
+void ofxCsvWriter::setCompressionLevel(int level) {
+	this->level = std::max(level, 0);
+}
+
+// PROTECTED
+
+//--------------------------------------------------
+bool ofxCsvWriter::flushBuffer() {
+	if(bufferLen == 0) {
+		return !error;
+	}
+	auto start = std::chrono::steady_clock::now();
+	bool ret = writeRaw(buffer.data(), bufferLen);
+	writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	bufferLen = 0;
+	return ret;
+}
+
+//--------------------------------------------------
+bool ofxCsvWriter::writeRaw(const char *data, size_t size) {
+	if(!file || error) {
+		return false;
+	}
+	switch(compression) {
+		case ofxCsvCompression::Gzip:
+			while(size > 0) {
+				unsigned int n = (unsigned int)std::min<size_t>(size, INT_MAX);
+				if(gzwrite((gzFile)file, data, n) != (int)n) {
+					error = true;
+					return false;
+				}
+				data += n;
+				size -= n;
+			}
+			return true;
+	#ifdef OFX_CSV_ZSTD
+		case ofxCsvCompression::Zstd: {
+			ZSTD_inBuffer in = {data, size, 0};
+			while(in.pos < in.size) {
+				ZSTD_outBuffer out = {output.data(), output.size(), 0};
+				size_t ret = ZSTD_compressStream((ZSTD_CStream *)zstd, &out, &in);
+				if(ZSTD_isError(ret) ||
+				   fwrite(output.data(), 1, out.pos, (FILE *)file) != out.pos) {
+					error = true;
+					return false;
+				}
+			}
+			return true;
+		}
+	#endif
+		default:
+			if(fwrite(data, 1, size, (FILE *)file) != size) {
+				error = true;
+				return false;
+			}
+			return true;
+	}
+}
@@ -0,0 +1,132 @@
+/**
+ *  ofxCsvWriter.h
+ *  Inspired and based on Ben Fry's [table class](http://benfry.com/writing/map/Table.pde)
+ *
+ *  The MIT License
+ *
+ *  Copyright (c) 2011-2019 Paul Vollmer, https://paulvollmer.net
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *  @modified           2019.05.15
+ *  @version            0.2.1
+ */
+
+#pragma once
+
+#include "ofxCsvReader.h"
+
+/// \class ofxCsvWriter
+/// \brief buffered writer for plain & compressed files
+///
+/// Collects writes in a memory buffer & writes or compresses them to the
+/// file in large blocks:
+///
+///     ofxCsvWriter writer;
+///     if(writer.open("data.csv.gz")) {
+///         writer.write("1,2,3\n");
+///         writer.close();
+///     }
+///
+class ofxCsvWriter {
+
+	public:
+
+		/// Constructor.
+		///
+		/// \param bufferSize Write buffer size in bytes, default 1 MB.
+		ofxCsvWriter(size_t bufferSize=1024*1024);
+		virtual ~ofxCsvWriter();
+
+		/// Open a file for writing.
+		///
+		/// Closes any currently open file.
+		///
+		/// \param path Absolute or working directory relative file path.
+		/// \param compression Compression format, default detects by extension.
+		/// \param append Append to an existing file instead of truncating it?
+		///               Compressed files are appended as a new stream member.
+		/// \returns true if the file was opened
+		bool open(const string &path, ofxCsvCompression compression=ofxCsvCompression::Auto,
+		          bool append=false);
+
+		/// Flush buffered data & close the current file.
+		///
+		/// \returns false if any write error occured
+		bool close();
+
+		/// Is a file currently open?
+		bool isOpen() const;
+
+		/// Write bytes.
+		///
+		/// \returns false on a write error
+		bool write(const char *data, size_t size);
+
+		/// Write a string.
+		///
+		/// \returns false on a write error
+		bool write(const string &text);
+
+		/// Write all buffered data to the file.
+		///
+		/// Also flushes the compressor & the stream, so the data written so
+		/// far can be read back. Compressed files are slightly larger when
+		/// flushed often.
+		///
+		/// \returns false on a write error
+		bool flush();
+
+		/// Get the number of uncompressed bytes written since opening.
+		uint64_t getBytesWritten() const;
+
+		/// Get the time spent compressing & writing to the file since
+		/// opening, including closing it.
+		///
+		/// \returns wall time in seconds
+		double getWriteTime() const;
+
+		/// Did a write or compression error occur?
+		bool hasError() const;
+
+		/// Set the compression level used when opening a file.
+		///
+		/// \param level 1 (fast) - 9 (small) for gzip or 1 - 19 for zstd,
+		///              0 uses the default of each format.
+		void setCompressionLevel(int level);
+
+	protected:
+
+		/// write the buffer through the compressor, without flushing the stream
+		bool flushBuffer();
+
+		/// write bytes through the compressor to the file
+		bool writeRaw(const char *data, size_t size);
+
+		ofxCsvCompression compression; //< current compression format
+		int level;                     //< compression level, 0 for default
+		void *file;                    //< FILE* or gzFile handle
+		void *zstd;                    //< zstd compression state
+		bool error;                    //< did an error occur?
+		vector<char> buffer;           //< pending write data
+		size_t bufferLen;              //< number of pending bytes
+		vector<char> output;           //< compressed output for zstd
+		uint64_t bytesWritten;         //< uncompressed bytes written
+		double writeTime;              //< seconds spent writing
+};